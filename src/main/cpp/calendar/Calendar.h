@@ -58,6 +58,9 @@ public:
 	/// Get the current year
 	std::size_t GetYear() const { return m_date.year(); }
 
+	/// Set the simulation day and the corresponding date (when restoring a snapshot)
+	void SetDate(std::size_t day, const boost::gregorian::date& date) { m_day = day; m_date = date; }
+
     /// Check if it's a holiday
     bool IsHoliday() const { return (std::find(m_holidays.begin(), m_holidays.end(), m_date) != m_holidays.end()); }
 
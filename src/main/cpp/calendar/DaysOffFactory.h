@@ -0,0 +1,60 @@
+#ifndef SRC_MAIN_CALENDAR_DAYS_OFF_FACTORY_H_
+#define SRC_MAIN_CALENDAR_DAYS_OFF_FACTORY_H_
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * DaysOffFactory class.
+ */
+
+#include "DaysOffAll.h"
+#include "DaysOffInterface.h"
+#include "DaysOffNone.h"
+#include "DaysOffSchool.h"
+#include "DaysOffStandard.h"
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace stride {
+
+/**
+ * Creates the days off scheme named in the configuration (run.days_off):
+ * "Standard", "School" (schools closed), "None" or "All".
+ */
+class DaysOffFactory
+{
+public:
+        /// Create the named scheme on the calendar.
+        static std::shared_ptr<DaysOffInterface> Create(const std::string& name, std::shared_ptr<Calendar> cal)
+        {
+                if (name == "Standard") {
+                        return std::make_shared<DaysOffStandard>(cal);
+                } else if (name == "School") {
+                        return std::make_shared<DaysOffSchool>(cal);
+                } else if (name == "None") {
+                        return std::make_shared<DaysOffNone>(cal);
+                } else if (name == "All") {
+                        return std::make_shared<DaysOffAll>(cal);
+                }
+                throw std::runtime_error(std::string(__func__) + "> Invalid input for days off: " + name);
+        }
+};
+
+} // end_of_namespace
+
+#endif // end of include guard
@@ -0,0 +1,61 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Implementation of the AgeMixing class.
+ */
+
+#include "AgeMixing.h"
+
+#include <stdexcept>
+#include <string>
+
+namespace stride {
+
+using namespace std;
+
+AgeMixing::AgeMixing(const ContactMatrices& matrices, const vector<double>& population_ages, unsigned int bin_width)
+        : m_bin_width(bin_width), m_num_bins(0U)
+{
+        if (bin_width == 0U || bin_width > MaximumAge()) {
+                throw runtime_error(string(__func__) + "> Invalid age bin width " + to_string(bin_width) + ".");
+        }
+        m_num_bins = MaximumAge() / bin_width + 1U;
+        vector<double> population(m_num_bins, 0.0);
+        for (unsigned int b = 0; b <= MaximumAge() && b < population_ages.size(); b++) {
+                population[GetBin(b)] += population_ages[b];
+        }
+
+        // Per participant group: the mean over its ages of the contacts with each contact group,
+        // per person of the contact group.
+        for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+                auto& weights = m_weights[t];
+                weights.assign(m_num_bins * m_num_bins, 0.0);
+                vector<unsigned int> num_ages(m_num_bins, 0U);
+                for (unsigned int a = 0; a <= MaximumAge(); a++) {
+                        ++num_ages[GetBin(a)];
+                        for (unsigned int b = 0; b <= MaximumAge(); b++) {
+                                weights[GetBin(a) * m_num_bins + GetBin(b)] += matrices[t][a][b];
+                        }
+                }
+                for (size_t i = 0; i < weights.size(); i++) {
+                        const double num_persons = population[i % m_num_bins];
+                        weights[i] = (num_persons > 0.0) ? weights[i] / num_ages[i / m_num_bins] / num_persons : 0.0;
+                }
+        }
+}
+
+} // end_of_namespace
@@ -0,0 +1,81 @@
+#ifndef AGE_MIXING_H_INCLUDED
+#define AGE_MIXING_H_INCLUDED
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Header for the AgeMixing class.
+ */
+
+#include "core/ClusterType.h"
+#include "core/ContactMatrix.h"
+#include "pop/Age.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace stride {
+
+/**
+ * Age-structured mixing within clusters, from the full age-by-age contact matrices
+ * binned over age groups of a given width (the last group holds MaximumAge() only).
+ * The matrices give contacts with persons of an age; divided by the number of persons
+ * of that age in the population, they give the contacts per person of that age, the
+ * weight of a contact between two members of a cluster. A person still has the total
+ * contact rate of the ContactProfile (the row sum for its age, over the cluster size),
+ * but spreads it over the members of the cluster in proportion to these weights: a
+ * member in age group B gets weight(A, B) / sum over members k of weight(A, group of k)
+ * of it. Matrices with contacts in proportion to the population of each age give the
+ * uniform mixing of the ContactProfile.
+ *
+ * The Infector then aggregates the infectious members of a cluster by age group once
+ * and gives every susceptible the force of infection of its group: the sum over the
+ * infectious groups of their contact rates times the weight, a dot product over the
+ * groups rather than a sum over the infectious members.
+ */
+class AgeMixing
+{
+public:
+	/// Binned weights (age groups of the given width) for all cluster types, given the
+	/// number of persons of each age (0 to MaximumAge()) in the population.
+	AgeMixing(const ContactMatrices& matrices, const std::vector<double>& population_ages, unsigned int bin_width);
+
+	/// Number of age groups.
+	std::size_t GetNumBins() const { return m_num_bins; }
+
+	/// Age group of a person.
+	std::size_t GetBin(double age) const
+	{
+		return std::min<std::size_t>(EffectiveAge(age) / m_bin_width, m_num_bins - 1U);
+	}
+
+	/// Weight of a contact of a person of age group a with a person of age group b, in a cluster type.
+	double GetWeight(ClusterType type, std::size_t a, std::size_t b) const
+	{
+		return m_weights[ToSizeType(type)][a * m_num_bins + b];
+	}
+
+private:
+	unsigned int                                              m_bin_width;   ///< Years per age group.
+	std::size_t                                               m_num_bins;    ///< Number of age groups.
+	std::array<std::vector<double>, NumOfClusterTypes()>      m_weights;     ///< Binned weights, row major.
+};
+
+} // end_of_namespace
+
+#endif // include-guard
@@ -38,7 +38,7 @@ std::array<ContactProfile, NumOfClusterTypes()> Cluster::g_profiles;
 
 Cluster::Cluster(std::size_t cluster_id, ClusterType cluster_type)
         : m_cluster_id(cluster_id), m_cluster_type(cluster_type),
-          m_index_immune(0), m_profile(g_profiles.at(ToSizeType(m_cluster_type)))
+          m_index_immune(0), m_is_sorted(false), m_profile(g_profiles.at(ToSizeType(m_cluster_type)))
 {
 }
 
@@ -54,46 +54,70 @@ void Cluster::AddPerson(Person* p)
         m_index_immune++;
 }
 
+void Cluster::CompactMembers(vector<Cluster>& clusters, const vector<size_t>& order,
+        const shared_ptr<const util::Storage>& storage)
+{
+        size_t total = 0U;
+        for (const auto c : order) {
+                total += clusters[c].m_members.size();
+        }
+        const auto block = make_shared<ClusterMembers::Block>(ClusterMembers::Block::allocator_type(storage));
+        block->resize(total);
+        size_t offset = 0U;
+        for (const auto c : order) {
+                auto& members = clusters[c].m_members;
+                const size_t size = members.size();
+                members.MoveTo(block, offset);
+                offset += size;
+        }
+}
+
 tuple<bool, size_t> Cluster::SortMembers()
 {
+        const auto members = m_members.data();
         bool infectious_cases = false;
         size_t num_cases = 0;
+        const size_t index_immune = m_index_immune;
+        bool swapped_any = false;
 
         for (size_t i_member = 0; i_member < m_index_immune; i_member++) {
                 // if immune, move to back
-                if (m_members[i_member].first->GetHealth().IsImmune()) {
+                if (members[i_member].first->GetHealth().IsImmune()) {
                         bool swapped = false;
                         size_t new_place = m_index_immune - 1;
                         m_index_immune--;
                         while(! swapped && new_place > i_member) {
-                                if (m_members[new_place].first->GetHealth().IsImmune()) {
+                                if (members[new_place].first->GetHealth().IsImmune()) {
                                         m_index_immune--;
                                         new_place--;
                                 } else {
-                                        swap(m_members[i_member], m_members[new_place]);
+                                        swap(members[i_member], members[new_place]);
                                         swapped = true;
+                                        swapped_any = true;
                                 }
                         }
                 }
                 // else, if not susceptible, move to front
-                else if (!m_members[i_member].first->GetHealth().IsSusceptible()) {
-                        if (!infectious_cases && m_members[i_member].first->GetHealth().IsInfectious()) {
+                else if (!members[i_member].first->GetHealth().IsSusceptible()) {
+                        if (!infectious_cases && members[i_member].first->GetHealth().IsInfectious()) {
                                 infectious_cases = true;
                         }
                         if (i_member > num_cases) {
-                                swap(m_members[i_member], m_members[num_cases]);
+                                swap(members[i_member], members[num_cases]);
+                                swapped_any = true;
                         }
                         num_cases++;
                 }
         }
 
+        m_is_sorted = !swapped_any && m_index_immune == index_immune;
         return make_tuple(infectious_cases, num_cases);
 }
 
-void Cluster::UpdateMemberPresence()
+void Cluster::UpdateMemberPresence(bool is_work_off, bool is_school_off)
 {
         for (auto& member: m_members) {
-                member.second = member.first->IsInCluster(m_cluster_type);
+                member.second = member.first->IsInCluster(m_cluster_type, is_work_off, is_school_off);
         }
 }
 
@@ -20,6 +20,7 @@
  * Header for the core Cluster class.
  */
 
+#include "core/ClusterMembers.h"
 #include "core/ClusterType.h"
 #include "core/ContactProfile.h"
 #include "core/LogMode.h"
@@ -53,9 +54,15 @@ public:
 	/// Return number of persons in this cluster.
 	std::size_t GetSize() const { return m_members.size(); }
 
+	/// Return the i-th member of this cluster.
+	Person* GetMember(std::size_t i) const { return m_members[i].first; }
+
 	/// Return the type of this cluster.
 	ClusterType GetClusterType() const { return m_cluster_type; }
 
+	/// Did the last sort of the members by health status leave their order as it was?
+	bool IsSorted() const { return m_is_sorted; }
+
 	/// Get basic contact rate in this cluster.
 	double GetContactRate(const Person* p) const
 	{
@@ -66,22 +73,42 @@ public:
         /// Add contact profile.
         static void AddContactProfile(ClusterType cluster_type, const ContactProfile& profile);
 
-private:
+        /// Get contact profile.
+        static const ContactProfile& GetContactProfile(ClusterType cluster_type)
+        {
+                return g_profiles.at(ToSizeType(cluster_type));
+        }
+
+        /// Move the member lists of the clusters with the given indices, in that order,
+        /// into one shared block (see ClusterMembers), kept as the storage says. Clusters
+        /// not listed keep their own.
+        static void CompactMembers(std::vector<Cluster>& clusters, const std::vector<std::size_t>& order,
+                const std::shared_ptr<const util::Storage>& storage);
+
 	/// Sort members w.r.t. health status (order: exposed/infected/recovered, susceptible, immune).
+	/// Returns whether there are infectious members and the number of members before the
+	/// susceptible ones. Done by the Infector before the contacts of the day.
 	std::tuple<bool, size_t> SortMembers();
 
+	/// Calculate which members are present in the cluster on the current day.
+	void UpdateMemberPresence(bool is_work_off, bool is_school_off);
+
+private:
 	/// Infector calculates contacts and transmissions.
         template<LogMode log_level, bool track_index_case>
         friend class Infector;
 
-	/// Calculate which members are present in the cluster on the current day.
-	void UpdateMemberPresence();
+        /// Snapshots store and restore the members.
+        friend class MemoryPlacement;
+        friend class SimulatorCheckpoint;
+        friend class SimulatorSnapshot;
 
 private:
 	std::size_t                               m_cluster_id;     ///< The ID of the Cluster (for logging purposes).
 	ClusterType                               m_cluster_type;   ///< The type of the Cluster (for logging purposes).
 	std::size_t                               m_index_immune;   ///< Index of the first immune member in the Cluster.
-	std::vector<std::pair<Person*, bool>>     m_members;        ///< Container with pointers to Cluster members.
+	bool                                      m_is_sorted;      ///< The last sort left the members as they were.
+	ClusterMembers                            m_members;        ///< Container with pointers to Cluster members.
 	const ContactProfile&                     m_profile;
 private:
 	static std::array<ContactProfile, NumOfClusterTypes()> g_profiles;
@@ -0,0 +1,134 @@
+#ifndef CLUSTER_MEMBERS_H_INCLUDED
+#define CLUSTER_MEMBERS_H_INCLUDED
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Header for the ClusterMembers class.
+ */
+
+#include "util/NumaAllocator.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace stride {
+
+class Person;
+
+/**
+ * Member list of a cluster: pointer to the person and presence today. The list
+ * is held by the cluster itself while it is being built; afterwards the lists of
+ * many clusters can be moved into one shared block (see Cluster::CompactMembers),
+ * laid out in the order in which the daily cluster pass goes through them.
+ */
+class ClusterMembers
+{
+public:
+	using value_type = std::pair<Person*, bool>;
+
+	/// Shared block with the member lists of many clusters.
+	using Block = std::vector<value_type, util::NumaAllocator<value_type, util::Access::Sequential>>;
+
+public:
+	/// Empty list.
+	ClusterMembers() : m_offset(0U), m_size(0U) {}
+
+	/// Number of members.
+	std::size_t size() const { return m_size; }
+
+	/// First member.
+	value_type* data() { return m_block ? m_block->data() + m_offset : m_own.data(); }
+
+	/// First member.
+	const value_type* data() const { return m_block ? m_block->data() + m_offset : m_own.data(); }
+
+	///
+	value_type* begin() { return data(); }
+
+	///
+	value_type* end() { return data() + m_size; }
+
+	///
+	const value_type* begin() const { return data(); }
+
+	///
+	const value_type* end() const { return data() + m_size; }
+
+	///
+	value_type& operator[](std::size_t i) { return data()[i]; }
+
+	///
+	const value_type& operator[](std::size_t i) const { return data()[i]; }
+
+	/// Reserve room in the cluster's own list.
+	void reserve(std::size_t n)
+	{
+		Detach();
+		m_own.reserve(n);
+	}
+
+	/// Append a member (to the cluster's own list).
+	template<typename... Args>
+	void emplace_back(Args&&... args)
+	{
+		Detach();
+		m_own.emplace_back(std::forward<Args>(args)...);
+		m_size++;
+	}
+
+	///
+	void swap(ClusterMembers& other)
+	{
+		m_own.swap(other.m_own);
+		m_block.swap(other.m_block);
+		std::swap(m_offset, other.m_offset);
+		std::swap(m_size, other.m_size);
+	}
+
+	/// Move the members to the given position in the block, releasing the cluster's own list.
+	void MoveTo(const std::shared_ptr<Block>& block, std::size_t offset)
+	{
+		std::copy(begin(), end(), block->data() + offset);
+		std::vector<value_type>().swap(m_own);
+		m_block  = block;
+		m_offset = offset;
+	}
+
+private:
+	/// Take the members out of a shared block, back into the cluster's own list.
+	void Detach()
+	{
+		if (m_block) {
+			m_own.assign(begin(), end());
+			m_block.reset();
+			m_offset = 0U;
+		}
+	}
+
+private:
+	std::vector<value_type>         m_own;       ///< Members while held by the cluster itself.
+	std::shared_ptr<Block>          m_block;     ///< Shared block with the members, if any.
+	std::size_t                     m_offset;    ///< Position of the first member in the block.
+	std::size_t                     m_size;      ///< Number of members.
+};
+
+} // end_of_namespace
+
+#endif // include-guard
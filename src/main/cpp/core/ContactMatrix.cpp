@@ -0,0 +1,141 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Implementation of the ContactMatrix class.
+ */
+
+#include "ContactMatrix.h"
+
+#include "util/InputBuffer.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace stride {
+
+using namespace std;
+using boost::filesystem::path;
+using boost::property_tree::ptree;
+using namespace stride::util;
+
+namespace {
+
+/// Parse a rate with either a decimal point or a decimal comma, optionally quoted.
+bool ParseRate(const char* first, const char* last, double& rate)
+{
+        while (first < last && (*first == ' ' || *first == '"')) {
+                ++first;
+        }
+        while (last > first && (last[-1] == ' ' || last[-1] == '"' || last[-1] == '\r')) {
+                --last;
+        }
+        char buf[64];
+        const size_t len = static_cast<size_t>(last - first);
+        if (len == 0U || len >= sizeof(buf)) {
+                return false;
+        }
+        memcpy(buf, first, len);
+        buf[len] = '\0';
+        if (char* comma = strchr(buf, ',')) {
+                *comma = '.';
+        }
+        char* end = nullptr;
+        rate = strtod(buf, &end);
+        return end == buf + len;
+}
+
+}
+
+ContactMatrix::ContactMatrix()
+{
+        for (auto& row : *this) {
+                row.fill(0.0);
+        }
+}
+
+ContactMatrix::ContactMatrix(ClusterType cluster_type, const ptree& pt_contacts)
+        : ContactMatrix()
+{
+        const string key = "matrices." + ToString(cluster_type);
+        size_t i = 0U;
+        for (const auto& participant : pt_contacts.get_child(key)) {
+                size_t j = 0U;
+                for (const auto& contact : participant.second.get_child("contacts")) {
+                        if (i < size() && j < (*this)[i].size()) {
+                                (*this)[i][j] = contact.second.get<double>("rate");
+                        }
+                        j++;
+                }
+                i++;
+        }
+}
+
+ContactMatrix ContactMatrix::ReadCsv(const path& file_path, double scale)
+{
+        const InputBuffer buffer(file_path);
+        ContactMatrix matrix;
+        const char* line = buffer.begin();
+        size_t line_number = 0U;
+        size_t row = 0U;
+        bool header = true;
+
+        while (line < buffer.end()) {
+                const void* nl = memchr(line, '\n', static_cast<size_t>(buffer.end() - line));
+                const char* line_end = (nl != nullptr) ? static_cast<const char*>(nl) : buffer.end();
+                const char* next = (nl != nullptr) ? line_end + 1 : buffer.end();
+                line_number++;
+
+                // Skip the header and blank lines.
+                const bool blank = (line == line_end) || (line_end - line == 1 && *line == '\r');
+                if (header || blank) {
+                        header = header && blank;
+                        line = next;
+                        continue;
+                }
+                if (row >= matrix.size()) {
+                        throw runtime_error(string(__func__) + "> Too many rows in " + file_path.string());
+                }
+
+                size_t col = 0U;
+                const char* field = line;
+                while (field <= line_end) {
+                        const void* sc = memchr(field, ';', static_cast<size_t>(line_end - field));
+                        const char* field_end = (sc != nullptr) ? static_cast<const char*>(sc) : line_end;
+                        double rate = 0.0;
+                        if (col >= matrix[row].size() || !ParseRate(field, field_end, rate)) {
+                                throw runtime_error(string(__func__) + "> Bad data at line "
+                                        + to_string(line_number) + " of " + file_path.string());
+                        }
+                        matrix[row][col++] = scale * rate;
+                        field = field_end + 1;
+                }
+                if (col != matrix[row].size()) {
+                        throw runtime_error(string(__func__) + "> Too few rates at line "
+                                + to_string(line_number) + " of " + file_path.string());
+                }
+                row++;
+                line = next;
+        }
+        if (row != matrix.size()) {
+                throw runtime_error(string(__func__) + "> Too few rows in " + file_path.string());
+        }
+        return matrix;
+}
+
+} // namespace
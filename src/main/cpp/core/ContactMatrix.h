@@ -0,0 +1,56 @@
+#ifndef CONTACT_MATRIX_H_INCLUDED
+#define CONTACT_MATRIX_H_INCLUDED
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Age-by-age contact matrix.
+ */
+
+#include "core/ClusterType.h"
+#include "pop/Age.h"
+
+#include <boost/filesystem.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <array>
+
+namespace stride {
+
+/**
+ * Dense contact matrix for one cluster type: (*this)[i][j] is the mean number
+ * of contacts per day of a participant of age i with persons of age j.
+ */
+class ContactMatrix : public std::array<std::array<double, MaximumAge() + 1>, MaximumAge() + 1>
+{
+public:
+        /// All rates zero.
+        ContactMatrix();
+
+        /// Rates for the cluster type from the contact matrix XML
+        /// (matrices.<type>.participant.contacts.contact.rate).
+        ContactMatrix(ClusterType cluster_type, const boost::property_tree::ptree& pt_contacts);
+
+        /// Rates from a reference CSV file: a header row "age0";...;"age80" followed by one row
+        /// of semicolon separated rates (with decimal commas) per participant age, scaled by the factor.
+        static ContactMatrix ReadCsv(const boost::filesystem::path& file_path, double scale = 1.0);
+};
+
+/// Contact matrices for all cluster types, indexed with ToSizeType.
+using ContactMatrices = std::array<ContactMatrix, NumOfClusterTypes()>;
+
+} // namespace
+
+#endif // end-of-include-guard
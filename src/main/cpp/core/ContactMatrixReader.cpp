@@ -0,0 +1,214 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Implementation of the ContactMatrixReader class.
+ */
+
+#include "ContactMatrixReader.h"
+
+#include "util/Fingerprint.h"
+#include "util/InstallDirs.h"
+
+#include <boost/property_tree/xml_parser.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+namespace stride {
+
+using namespace std;
+using namespace stride::util;
+using boost::filesystem::path;
+using boost::property_tree::ptree;
+
+namespace {
+
+/// Identifies compiled contact matrix files.
+const char g_magic[8] = { 'S', 'T', 'R', 'I', 'D', 'E', 'C', 'M' };
+
+/// Format version: bump it whenever the layout changes.
+const uint32_t g_version = 1U;
+
+/// Header of compiled contact matrix files, followed by the rates (row major, per cluster type).
+struct Header
+{
+        char         magic[8];
+        uint32_t     version;
+        uint32_t     num_ages;
+        uint32_t     num_types;
+        uint32_t     reserved;
+        uint64_t     key;          ///< Key of the inputs the matrices were compiled from.
+};
+
+/// The cluster types in index order.
+ClusterType Type(size_t t) { return static_cast<ClusterType>(t); }
+
+}
+
+ContactMatrices ContactMatrixReader::Read(const ptree& pt_config)
+{
+        // Reference CSV files.
+        const auto pt_csv = pt_config.get_child_optional("run.contact_matrices");
+        if (pt_csv) {
+                ContactMatrices matrices;
+                for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+                        const auto key = ToString(Type(t));
+                        const auto file_path = InstallDirs::GetDataDir() /= pt_csv->get<string>(key + ".file");
+                        if ( !is_regular_file(file_path) ) {
+                                throw runtime_error(string(__func__) + "> No file " + file_path.string());
+                        }
+                        matrices[t] = ContactMatrix::ReadCsv(file_path, pt_csv->get<double>(key + ".scale", 1.0));
+                }
+                return matrices;
+        }
+
+        // Compiled binary file or XML.
+        const auto file_name = pt_config.get("run.age_contact_matrix_file", "contact_matrix.xml");
+        const auto file_path = InstallDirs::GetDataDir() /= file_name;
+        if ( !is_regular_file(file_path) ) {
+                throw runtime_error(string(__func__) + "> No file " + file_path.string());
+        }
+        if (file_path.extension() == ".bin") {
+                return ReadBinary(file_path);
+        }
+
+        // XML, or its compiled copy in the snapshot directory (if so configured), named after
+        // a hash of the XML's content so that an edited XML never finds a stale copy.
+        ifstream ifs(file_path.string());
+        stringstream ss;
+        ss << ifs.rdbuf();
+        const string text = ss.str();
+        const auto snapshot_dir = pt_config.get<string>("run.snapshot_dir", "");
+        const auto key          = Fingerprint::Hash(text);
+        path bin_path;
+        if ( !snapshot_dir.empty() ) {
+                ostringstream oss;
+                oss << "contact_matrix_" << hex << setw(16) << setfill('0') << key << ".bin";
+                bin_path = absolute(snapshot_dir, InstallDirs::GetCurrentDir()) / oss.str();
+                if (is_regular_file(bin_path)) {
+                        try {
+                                uint64_t bin_key = 0U;
+                                const auto matrices = ReadBinary(bin_path, &bin_key);
+                                if (bin_key == key) {
+                                        return matrices;
+                                }
+                        } catch (runtime_error&) {
+                                // Foreign or damaged file: recompile below.
+                        }
+                }
+        }
+
+        ptree pt_contacts;
+        istringstream is(text);
+        read_xml(is, pt_contacts);
+        const auto matrices = ReadXml(pt_contacts);
+        if ( !bin_path.empty() ) {
+                try {
+                        create_directories(bin_path.parent_path());
+                        WriteBinary(matrices, bin_path, key);
+                } catch (exception&) {
+                        // The snapshot directory need not be writable; the next run parses the XML again.
+                }
+        }
+        return matrices;
+}
+
+ContactMatrices ContactMatrixReader::ReadXml(const ptree& pt_contacts)
+{
+        ContactMatrices matrices;
+        for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+                matrices[t] = ContactMatrix(Type(t), pt_contacts);
+        }
+        return matrices;
+}
+
+ContactMatrices ContactMatrixReader::ReadBinary(const path& file_path, uint64_t* key)
+{
+        ifstream ifs(file_path.string(), ios::binary);
+        Header h {};
+        ifs.read(reinterpret_cast<char*>(&h), sizeof(h));
+        if ( !ifs || memcmp(h.magic, g_magic, sizeof(g_magic)) != 0 || h.version != g_version
+                || h.num_ages != MaximumAge() + 1 || h.num_types != NumOfClusterTypes() ) {
+                throw runtime_error(string(__func__) + "> Not a compiled contact matrix file: " + file_path.string());
+        }
+        ContactMatrices matrices;
+        for (auto& m : matrices) {
+                for (auto& row : m) {
+                        ifs.read(reinterpret_cast<char*>(row.data()), row.size() * sizeof(double));
+                }
+        }
+        if ( !ifs ) {
+                throw runtime_error(string(__func__) + "> Truncated file " + file_path.string());
+        }
+        if (key != nullptr) {
+                *key = h.key;
+        }
+        return matrices;
+}
+
+void ContactMatrixReader::WriteBinary(const ContactMatrices& matrices, const path& file_path, uint64_t key)
+{
+        Header h {};
+        memcpy(h.magic, g_magic, sizeof(g_magic));
+        h.version   = g_version;
+        h.num_ages  = MaximumAge() + 1;
+        h.num_types = NumOfClusterTypes();
+        h.key       = key;
+
+        // Write next to the destination, then rename into place.
+        const path tmp_path = boost::filesystem::unique_path(file_path.string() + ".%%%%-%%%%-%%%%");
+        {
+                ofstream ofs(tmp_path.string(), ios::binary | ios::trunc);
+                if ( !ofs ) {
+                        throw runtime_error(string(__func__) + "> Error opening " + tmp_path.string());
+                }
+                ofs.write(reinterpret_cast<const char*>(&h), sizeof(h));
+                for (const auto& m : matrices) {
+                        for (const auto& row : m) {
+                                ofs.write(reinterpret_cast<const char*>(row.data()), row.size() * sizeof(double));
+                        }
+                }
+                if ( !ofs ) {
+                        boost::filesystem::remove(tmp_path);
+                        throw runtime_error(string(__func__) + "> Error writing " + tmp_path.string());
+                }
+        }
+        boost::filesystem::rename(tmp_path, file_path);
+}
+
+string ContactMatrixReader::GetStamp(const ptree& pt_config)
+{
+        ostringstream oss;
+        const auto pt_csv = pt_config.get_child_optional("run.contact_matrices");
+        if (pt_csv) {
+                for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+                        const auto key = ToString(Type(t));
+                        oss << key << "=" << Fingerprint::FileStamp(
+                                        InstallDirs::GetDataDir() /= pt_csv->get<string>(key + ".file", ""))
+                                << "*" << pt_csv->get<string>(key + ".scale", "1") << ";";
+                }
+        } else {
+                oss << Fingerprint::FileStamp(InstallDirs::GetDataDir()
+                        /= pt_config.get("run.age_contact_matrix_file", "contact_matrix.xml"));
+        }
+        return oss.str();
+}
+
+} // namespace
@@ -0,0 +1,66 @@
+#ifndef CONTACT_MATRIX_READER_H_INCLUDED
+#define CONTACT_MATRIX_READER_H_INCLUDED
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Header for the ContactMatrixReader class.
+ */
+
+#include "core/ContactMatrix.h"
+
+#include <boost/filesystem.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <cstdint>
+#include <string>
+
+namespace stride {
+
+/**
+ * Reads the contact matrices for all cluster types, as configured:
+ *
+ * - run.contact_matrices: per cluster type (household, school, work, primary_community,
+ *   secondary_community) the reference CSV <file> in the data directory and an optional
+ *   <scale> factor for its rates, e.g. 10 for household and 2.5 for work in the default set.
+ * - otherwise run.age_contact_matrix_file in the data directory: either a compiled binary
+ *   matrix file (extension .bin) or a contact matrix XML. With a run.snapshot_dir, an XML
+ *   file is compiled into that directory on first use, under a hash of its content; later
+ *   runs read the compiled file while the XML is unchanged.
+ */
+class ContactMatrixReader
+{
+public:
+	/// Read the matrices as configured.
+	static ContactMatrices Read(const boost::property_tree::ptree& pt_config);
+
+	/// Read the matrices from a contact matrix XML tree.
+	static ContactMatrices ReadXml(const boost::property_tree::ptree& pt_contacts);
+
+	/// Read compiled matrices; the key of the inputs they were compiled from is optionally returned.
+	static ContactMatrices ReadBinary(const boost::filesystem::path& file_path, std::uint64_t* key = nullptr);
+
+	/// Write compiled matrices, recording the key of the inputs they were compiled from.
+	static void WriteBinary(const ContactMatrices& matrices,
+	        const boost::filesystem::path& file_path, std::uint64_t key = 0U);
+
+	/// Identification of the configured input files (and scale factors).
+	static std::string GetStamp(const boost::property_tree::ptree& pt_config);
+};
+
+} // namespace
+
+#endif // end-of-include-guard
@@ -26,16 +26,18 @@ using namespace std;
 using namespace boost::property_tree;
 
 ContactProfile::ContactProfile(ClusterType cluster_type,  const ptree& pt_contacts)
+        : ContactProfile(ContactMatrix(cluster_type, pt_contacts))
 {
-        const string key = "matrices." + ToString(cluster_type);
-        ContactProfile mean_nums;
-        unsigned int i = 0U;
-        for(const auto& participant: pt_contacts.get_child(key)) {
+}
+
+ContactProfile::ContactProfile(const ContactMatrix& matrix)
+{
+        for (size_t i = 0; i < size(); i++) {
                 double total_contacts = 0;
-                for (const auto& contact: participant.second.get_child("contacts")) {
-                        total_contacts += contact.second.get<double>("rate");
+                for (const auto rate : matrix[i]) {
+                        total_contacts += rate;
                 }
-                (*this)[i++] = total_contacts;
+                (*this)[i] = total_contacts;
         }
 }
 
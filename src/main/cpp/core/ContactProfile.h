@@ -21,6 +21,7 @@
  */
 
 #include "core/ClusterType.h"
+#include "core/ContactMatrix.h"
 #include "pop/Age.h"
 
 #include <boost/property_tree/ptree.hpp>
@@ -36,6 +37,9 @@ public:
 
         /// Explicitly initialize
         ContactProfile(ClusterType cluster_type,  const boost::property_tree::ptree& pt_contacts);
+
+        /// Total contact rate per participant age, i.e. the row sums of the matrix.
+        explicit ContactProfile(const ContactMatrix& matrix);
 };
 
 } // namespace
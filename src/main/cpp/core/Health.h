@@ -29,6 +29,9 @@ enum class HealthStatus {Susceptible = 0U, Exposed = 1U, Infectious = 2U,
 class Health
 {
 public:
+	/// Uninitialized health (for storage that is filled in later).
+	Health() = default;
+
 	///
 	Health(unsigned int start_infectiousness, unsigned int start_symptomatic,
 	        unsigned int time_infectious, unsigned int time_symptomatic);
@@ -67,6 +70,14 @@ public:
                         || m_status == HealthStatus::InfectiousAndSymptomatic;
         }
 
+        /// Is this person infectious, or still to become so (the disease counter only goes up)?
+        bool MayInfect() const
+        {
+                return IsInfectious() || (IsInfected() && m_disease_counter < m_start_infectiousness);
+        }
+        /// Was this person infected since the last update?
+        bool IsNewlyInfected() const { return m_status == HealthStatus::Exposed && m_disease_counter == 0U; }
+
         ///
         bool IsRecovered() const { return m_status == HealthStatus::Recovered; }
 
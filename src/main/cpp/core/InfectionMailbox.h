@@ -0,0 +1,83 @@
+#ifndef INFECTION_MAILBOX_H_INCLUDED
+#define INFECTION_MAILBOX_H_INCLUDED
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Header for the InfectionMailbox class.
+ */
+
+#include "core/ClusterType.h"
+#include "pop/Person.h"
+
+#include <vector>
+
+namespace stride {
+
+/**
+ * Outgoing infections of one partition (thread) in the partitioned cluster pass.
+ * Infections of persons owned by another partition are not applied on the spot
+ * but posted, and delivered by the owner at the end of the day.
+ */
+class InfectionMailbox
+{
+public:
+	/// An infection posted for the owner of the infected person.
+	struct Letter
+	{
+		Person*        infector;
+		Person*        infected;
+		ClusterType    cluster_type;
+	};
+
+public:
+	/// Mailbox of the partition, given the owner partition of every person (by position in the population).
+	InfectionMailbox(unsigned int partition, unsigned int num_partitions,
+	        const std::vector<unsigned int>& owners, const Person* first_person)
+		: m_partition(partition), m_owners(&owners), m_first_person(first_person), m_outbox(num_partitions)
+	{
+	}
+
+	/// Is the person owned by the partition of this mailbox?
+	bool IsLocal(const Person* p) const { return (*m_owners)[p - m_first_person] == m_partition; }
+
+	/// Post the infection for the owner of the infected person.
+	void Post(Person* infector, Person* infected, ClusterType cluster_type)
+	{
+		m_outbox[(*m_owners)[infected - m_first_person]].push_back(Letter { infector, infected, cluster_type });
+	}
+
+	/// Infections posted for the partition.
+	const std::vector<Letter>& GetPosted(unsigned int partition) const { return m_outbox[partition]; }
+
+	/// Empty the outbox.
+	void Clear()
+	{
+		for (auto& letters : m_outbox) {
+			letters.clear();
+		}
+	}
+
+private:
+	unsigned int                       m_partition;      ///< Partition this mailbox belongs to.
+	const std::vector<unsigned int>*   m_owners;         ///< Owner partition for every person.
+	const Person*                      m_first_person;   ///< Start of the population.
+	std::vector<std::vector<Letter>>   m_outbox;         ///< Posted infections per owner partition.
+};
+
+} // end_of_namespace
+
+#endif // include-guard
@@ -23,11 +23,15 @@
 #include "core/Health.h"
 #include "core/Infector.h"
 #include "core/LogMode.h"
+#include "pop/Age.h"
 #include "pop/Person.h"
 
 #include <spdlog/spdlog.h>
 #include "RngHandler.h"
+#include <algorithm>
+#include <array>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -104,33 +108,184 @@ public:
         }
 };
 
+/**
+ * Infections found by the Infector: applied to the infected person (logged, and with the
+ * R0 policy) when that person is local to the mailbox's partition or there is no mailbox;
+ * posted to the person's partition otherwise.
+ */
+template<LogMode log_level, bool track_index_case>
+class Transmission
+{
+public:
+        Transmission(ClusterType cluster_type, InfectionMailbox* mailbox, shared_ptr<const Calendar> calendar)
+                : m_logger(spdlog::get("contact_logger")), m_cluster_type(cluster_type), m_mailbox(mailbox),
+                  m_calendar(calendar) {}
+
+        /// Does the infection of p2 need its infector, for the log or to post it?
+        bool NeedsInfector(const Person* p2) const
+        {
+                return log_level == LogMode::Transmissions || !IsLocal(p2);
+        }
+
+        /// Infection of p2 by p1 (which may be nullptr when NeedsInfector says so).
+        void Transmit(Person* p1, Person* p2) const
+        {
+                if (IsLocal(p2)) {
+                        Infect(m_logger, p1, p2, m_cluster_type, m_calendar);
+                } else {
+                        m_mailbox->Post(p1, p2, m_cluster_type);
+                }
+        }
+
+        /// Infect p2 (infected by p1 in a cluster of the given type).
+        static void Infect(const shared_ptr<spdlog::logger>& logger, Person* p1, Person* p2,
+                ClusterType cluster_type, const shared_ptr<const Calendar>& calendar)
+        {
+                LOG_POLICY<log_level>::Execute(logger, p1, p2, cluster_type, calendar);
+                p2->GetHealth().StartInfection();
+                R0_POLICY<track_index_case>::Execute(p2);
+        }
+
+private:
+        bool IsLocal(const Person* p2) const { return m_mailbox == nullptr || m_mailbox->IsLocal(p2); }
+
+private:
+        shared_ptr<spdlog::logger>      m_logger;
+        ClusterType                     m_cluster_type;
+        InfectionMailbox*               m_mailbox;
+        shared_ptr<const Calendar>      m_calendar;
+};
+
+/// Infectors with the running total of their share of a force of infection.
+using Infectors = vector<pair<Person*, double>>;
+
+/// The infector, in proportion to its share of the force of infection, for x uniform in [0, total share[.
+inline Person* PickInfector(const Infectors& infectors, double x)
+{
+        return lower_bound(infectors.begin(), infectors.end() - 1, x,
+                [](const pair<Person*, double>& a, double b) { return a.second <= b; })->first;
+}
+
 //--------------------------------------------------------------------------
 // Definition for primary template covers the situation for
 // LogMode::None & LogMode::Transmissions, both with
 // track_index_case false and true..
 //--------------------------------------------------------------------------
 template<LogMode log_level, bool track_index_case>
-void Infector<log_level, track_index_case>::Execute(
+bool Infector<log_level, track_index_case>::Execute(
         Cluster& cluster, DiseaseProfile disease_profile,
-        RngHandler& contact_handler, shared_ptr<const Calendar> calendar)
+        RngHandler& contact_handler, shared_ptr<const Calendar> calendar,
+        bool is_work_off, bool is_school_off, InfectionMailbox* mailbox, const MeanFieldRule& mean_field,
+        const AgeMixing* age_mixing)
 {
         // check if the cluster has infected members and sort
         bool infectious_cases;
         size_t num_cases;
         tie(infectious_cases, num_cases) = cluster.SortMembers();
 
+        bool aggregate = false;
         if (infectious_cases) {
-                cluster.UpdateMemberPresence();
+                cluster.UpdateMemberPresence(is_work_off, is_school_off);
 
                 // Set up some stuff
-                auto logger            = spdlog::get("contact_logger");
                 const auto c_type      = cluster.m_cluster_type;
                 const auto c_immune    = cluster.m_index_immune;
-                const auto& c_members  = cluster.m_members;
+                const auto c_members   = cluster.m_members.data();
                 const auto transmission_rate = disease_profile.GetTransmissionRate();
+                const Transmission<log_level, track_index_case> transmission(c_type, mailbox, calendar);
+
+                // Age-structured mixing: the contact rates of the infectious members present, by age
+                // group, then a force of infection per age group of the susceptibles.
+                if (age_mixing != nullptr) {
+                        using Groups = array<double, MaximumAge() + 1U>;
+                        Groups members {};
+                        Groups rates {};
+                        Groups scale {};
+                        Groups force;
+                        force.fill(-1.0);
+                        const size_t num_bins = age_mixing->GetNumBins();
+                        for (size_t i = 0; i < cluster.GetSize(); i++) {
+                                ++members[age_mixing->GetBin(c_members[i].first->GetAge())];
+                        }
+                        for (size_t i_infected = 0; i_infected < num_cases; i_infected++) {
+                                const auto p1 = c_members[i_infected].first;
+                                if (c_members[i_infected].second && p1->GetHealth().IsInfectious()) {
+                                        rates[age_mixing->GetBin(p1->GetAge())] += cluster.GetContactRate(p1);
+                                }
+                        }
+                        // An infectious group spreads its contact rates over the members by matrix weight.
+                        for (size_t a = 0; a < num_bins; a++) {
+                                if (rates[a] > 0.0) {
+                                        double total = 0.0;
+                                        for (size_t b = 0; b < num_bins; b++) {
+                                                total += age_mixing->GetWeight(c_type, a, b) * members[b];
+                                        }
+                                        scale[a] = (total > 0.0) ? cluster.GetSize() / total : 0.0;
+                                }
+                        }
+                        // The infectors of each age group of susceptibles, when first needed.
+                        vector<Infectors> infectors;
+                        for (size_t i_contact = num_cases; i_contact < c_immune; i_contact++) {
+                                if ( !c_members[i_contact].second ) {
+                                        continue;
+                                }
+                                auto p2 = c_members[i_contact].first;
+                                const size_t b = age_mixing->GetBin(p2->GetAge());
+                                if (force[b] < 0.0) {
+                                        force[b] = 0.0;
+                                        for (size_t a = 0; a < num_bins; a++) {
+                                                force[b] += rates[a] * scale[a] * age_mixing->GetWeight(c_type, a, b);
+                                        }
+                                }
+                                if (contact_handler.HasTransmission(force[b], transmission_rate)) {
+                                        Person* p1 = nullptr;
+                                        if (transmission.NeedsInfector(p2)) {
+                                                infectors.resize(num_bins);
+                                                if (infectors[b].empty()) {
+                                                        double share = 0.0;
+                                                        for (size_t i_infected = 0; i_infected < num_cases; i_infected++) {
+                                                                const auto p = c_members[i_infected].first;
+                                                                if (c_members[i_infected].second && p->GetHealth().IsInfectious()) {
+                                                                        const size_t a = age_mixing->GetBin(p->GetAge());
+                                                                        share += cluster.GetContactRate(p) * scale[a] * age_mixing->GetWeight(c_type, a, b);
+                                                                        infectors[b].emplace_back(p, share);
+                                                                }
+                                                        }
+                                                }
+                                                p1 = PickInfector(infectors[b], contact_handler.NextDouble() * force[b]);
+                                        }
+                                        transmission.Transmit(p1, p2);
+                                }
+                        }
+                }
+
+                // Large clusters with many infectious members: transmission from the force of infection
+                // of all infectious members present together, with one draw per susceptible.
+                else if (mean_field.Applies(cluster.GetSize(), num_cases)) {
+                        Infectors infectors;
+                        double force = 0.0;
+                        for (size_t i_infected = 0; i_infected < num_cases; i_infected++) {
+                                const auto p1 = c_members[i_infected].first;
+                                if (c_members[i_infected].second && p1->GetHealth().IsInfectious()) {
+                                        force += cluster.GetContactRate(p1);
+                                        infectors.emplace_back(p1, force);
+                                }
+                        }
+                        aggregate = !infectors.empty() && mean_field.Applies(cluster.GetSize(), infectors.size());
+                        for (size_t i_contact = num_cases; aggregate && i_contact < c_immune; i_contact++) {
+                                if (c_members[i_contact].second && contact_handler.HasTransmission(force, transmission_rate)) {
+                                        auto p2 = c_members[i_contact].first;
+                                        Person* p1 = infectors.front().first;
+                                        if (transmission.NeedsInfector(p2)) {
+                                                p1 = PickInfector(infectors, contact_handler.NextDouble() * force);
+                                        }
+                                        transmission.Transmit(p1, p2);
+                                }
+                        }
+                }
 
                 // Match infectious in first part with susceptible in second part, skip last part (immune)
-                for (size_t i_infected = 0; i_infected < num_cases; i_infected++) {
+                for (size_t i_infected = 0; age_mixing == nullptr && !aggregate && i_infected < num_cases; i_infected++) {
                         // check if member is present today
                         if (c_members[i_infected].second) {
                                 const auto p1 = c_members[i_infected].first;
@@ -141,9 +296,7 @@ void Infector<log_level, track_index_case>::Execute(
                                                 if (c_members[i_contact].second) {
                                                         auto p2 = c_members[i_contact].first;
                                                         if (contact_handler.HasTransmission(contact_rate, transmission_rate)) {
-                                                                LOG_POLICY<log_level>::Execute(logger, p1, p2, c_type, calendar);
-                                                                p2->GetHealth().StartInfection();
-                                                                R0_POLICY<track_index_case>::Execute(p2);
+                                                                transmission.Transmit(p1, p2);
                                                         }
                                                 }
                                         }
@@ -151,23 +304,122 @@ void Infector<log_level, track_index_case>::Execute(
                         }
                 }
         }
+        return aggregate;
 }
 
+template<LogMode log_level, bool track_index_case>
+void Infector<log_level, track_index_case>::ExecutePathogens(
+        Cluster& cluster, DiseaseProfile disease_profile,
+        RngHandler& contact_handler, PathogenTracks& pathogens, unsigned int thread,
+        shared_ptr<const Calendar> calendar, bool is_work_off, bool is_school_off)
+{
+        // The members are sorted for the first pathogen: its cases, susceptibles and immune.
+        bool infectious_cases;
+        size_t num_cases;
+        tie(infectious_cases, num_cases) = cluster.SortMembers();
+
+        const auto c_immune  = cluster.m_index_immune;
+        const auto c_members = cluster.m_members.data();
+        const size_t c_size  = cluster.GetSize();
+
+        // Is any member infectious with any pathogen?
+        bool any_infectious = infectious_cases;
+        for (size_t i = 0; !any_infectious && i < c_size; i++) {
+                any_infectious = pathogens.infectious[c_members[i].first->GetId()] != 0U;
+        }
+        if ( !any_infectious ) {
+                return;
+        }
+        cluster.UpdateMemberPresence(is_work_off, is_school_off);
+
+        // The members present today that are susceptible to some pathogen, with those pathogens.
+        static thread_local vector<pair<size_t, uint32_t>> susceptibles;
+        susceptibles.clear();
+        for (size_t i = 0; i < c_size; i++) {
+                if (c_members[i].second) {
+                        const uint32_t bits = (i >= num_cases && i < c_immune)
+                                | pathogens.susceptible[c_members[i].first->GetId()];
+                        if (bits != 0U) {
+                                susceptibles.emplace_back(i, bits);
+                        }
+                }
+        }
+
+        // Match the infectious members present with the susceptible ones, pathogen by pathogen: the
+        // first pathogen has the pairs, in the order, of Execute.
+        const auto transmission_rate = disease_profile.GetTransmissionRate();
+        const Transmission<log_level, track_index_case> transmission(cluster.m_cluster_type, nullptr, calendar);
+        for (size_t i_infected = 0; i_infected < c_size; i_infected++) {
+                if ( !c_members[i_infected].second ) {
+                        continue;
+                }
+                const auto p1 = c_members[i_infected].first;
+                const uint32_t infectious = (i_infected < num_cases && p1->GetHealth().IsInfectious())
+                        | pathogens.infectious[p1->GetId()];
+                if (infectious == 0U) {
+                        continue;
+                }
+                // The transmission probability of each pathogen the member is infectious with.
+                const double contact_rate = cluster.GetContactRate(p1);
+                array<double, 32> probability;
+                for (size_t k = 0; (infectious >> k) != 0U; k++) {
+                        const double rate = (k == 0U) ? transmission_rate : pathogens.tracks[k - 1].disease_profile.GetTransmissionRate();
+                        probability[k] = contact_handler.RateToProbability(rate * contact_rate);
+                }
+                for (const auto& contact : susceptibles) {
+                        const uint32_t bits = infectious & contact.second;
+                        if (bits == 0U) {
+                                continue;
+                        }
+                        auto p2 = c_members[contact.first].first;
+                        if ((bits & 1U) && contact_handler.NextDouble() < probability[0]) {
+                                transmission.Transmit(p1, p2);
+                        }
+                        for (size_t k = 1; (bits >> k) != 0U; k++) {
+                                if (((bits >> k) & 1U) && pathogens.tracks[k - 1].rng_handler[thread].NextDouble() < probability[k]) {
+                                        // Another infector may have been first today.
+                                        Health& health = pathogens.tracks[k - 1].health[p2->GetId()];
+                                        if (health.IsSusceptible()) {
+                                                health.StartInfection();
+                                                if (track_index_case) {
+                                                        health.StopInfection();
+                                                }
+                                        }
+                                }
+                        }
+                }
+        }
+}
+
+template<LogMode log_level, bool track_index_case>
+void Infector<log_level, track_index_case>::Deliver(
+        const vector<InfectionMailbox::Letter>& letters, shared_ptr<const Calendar> calendar)
+{
+        auto logger = spdlog::get("contact_logger");
+        for (const auto& letter : letters) {
+                // Another letter or a local contact may have infected the person already.
+                if (letter.infected->GetHealth().IsSusceptible()) {
+                        Transmission<log_level, track_index_case>::Infect(logger, letter.infector, letter.infected,
+                                letter.cluster_type, calendar);
+                }
+        }
+}
 
 //--------------------------------------------------------------------------
 // Definition of partial specialization for LogMode::Contacts.
 //--------------------------------------------------------------------------
 template<bool track_index_case>
-void Infector<LogMode::Contacts, track_index_case>::Execute(
+bool Infector<LogMode::Contacts, track_index_case>::Execute(
         Cluster& cluster, DiseaseProfile disease_profile,
-        RngHandler& contact_handler, shared_ptr<const Calendar> calendar)
+        RngHandler& contact_handler, shared_ptr<const Calendar> calendar,
+        bool is_work_off, bool is_school_off, InfectionMailbox*, const MeanFieldRule&, const AgeMixing*)
 {
-        cluster.UpdateMemberPresence();
+        cluster.UpdateMemberPresence(is_work_off, is_school_off);
 
         // set up some stuff
         auto logger            = spdlog::get("contact_logger");
         const auto c_type      = cluster.m_cluster_type;
-        const auto& c_members  = cluster.m_members;
+        const auto c_members   = cluster.m_members.data();
         //const auto c_size      = cluster.GetSize();
 
         // check all contacts
@@ -176,7 +428,7 @@ void Infector<LogMode::Contacts, track_index_case>::Execute(
                 if (c_members[i_person1].second && c_members[i_person1].first->IsParticipatingInSurvey()) {
                         auto p1 = c_members[i_person1].first;
                         const double contact_rate = cluster.GetContactRate(p1);
-                        for (size_t i_person2 = 0; i_person2 < c_members.size(); i_person2++) {
+                        for (size_t i_person2 = 0; i_person2 < cluster.m_members.size(); i_person2++) {
                                 // check if member is present today
                                 if ((i_person1 != i_person2) && c_members[i_person2].second) {
                                         auto p2 = c_members[i_person2].first;
@@ -205,6 +457,7 @@ void Infector<LogMode::Contacts, track_index_case>::Execute(
                         }
                 }
         }
+        return false;
 }
 
 //--------------------------------------------------------------------------
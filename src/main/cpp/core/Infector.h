@@ -20,10 +20,15 @@
  * Header for the Infector class.
  */
 
+#include "core/AgeMixing.h"
 #include "core/DiseaseProfile.h"
+#include "core/InfectionMailbox.h"
 #include "core/LogMode.h"
+#include "core/MeanFieldRule.h"
+#include "core/PathogenTrack.h"
 
 #include <memory>
+#include <vector>
 
 namespace stride {
 
@@ -38,9 +43,30 @@ template<LogMode log_level, bool track_index_case>
 class Infector
 {
 public:
-	///
-	static void Execute(Cluster& cluster, DiseaseProfile disease_profile,
-	        RngHandler& contact_handler, std::shared_ptr<const Calendar> sim_state);
+	/// Contacts and transmission in the cluster, given today's days off. With a mailbox, infections
+	/// of persons that are not local to the mailbox's partition are posted rather than applied.
+	/// Returns whether the transmission was computed from the force of infection of the cluster
+	/// as a whole, which happens when the given mean field rule applies. With age mixing, every
+	/// susceptible gets the force of infection of its age group; the rule does not combine with it
+	/// (the builder rejects configs with both).
+	static bool Execute(Cluster& cluster, DiseaseProfile disease_profile,
+	        RngHandler& contact_handler, std::shared_ptr<const Calendar> sim_state,
+	        bool is_work_off, bool is_school_off, InfectionMailbox* mailbox = nullptr,
+	        const MeanFieldRule& mean_field = MeanFieldRule(), const AgeMixing* age_mixing = nullptr);
+
+	/// Contacts and transmission of several pathogens in the cluster in one pass: the first one
+	/// in the health of the persons, with the transmissions Execute has, the others in the tracks
+	/// (with the masks of who is infectious with and susceptible to them set by their Update).
+	/// The presence of the members and the contact rate of each infectious member are computed
+	/// once; each contact of a member infectious with a pathogen and a member susceptible to it
+	/// has one transmission draw, from the random stream of that pathogen for the given thread.
+	static void ExecutePathogens(Cluster& cluster, DiseaseProfile disease_profile,
+	        RngHandler& contact_handler, PathogenTracks& pathogens, unsigned int thread,
+	        std::shared_ptr<const Calendar> calendar, bool is_work_off, bool is_school_off);
+
+	/// Apply posted infections to the persons that are still susceptible.
+	static void Deliver(const std::vector<InfectionMailbox::Letter>& letters,
+	        std::shared_ptr<const Calendar> calendar);
 };
 
 /**
@@ -50,9 +76,22 @@ template<bool track_index_case>
 class Infector<LogMode::Contacts, track_index_case>
 {
 public:
-        ///
-        static void Execute(Cluster& cluster, DiseaseProfile disease_profile,
-                RngHandler& contact_handler, std::shared_ptr<const Calendar> calendar);
+        /// Contacts in the cluster (no transmission, hence nothing is ever posted nor computed in aggregate).
+        static bool Execute(Cluster& cluster, DiseaseProfile disease_profile,
+                RngHandler& contact_handler, std::shared_ptr<const Calendar> calendar,
+                bool is_work_off, bool is_school_off, InfectionMailbox* mailbox = nullptr,
+                const MeanFieldRule& mean_field = MeanFieldRule(), const AgeMixing* age_mixing = nullptr);
+
+        /// Contacts in the cluster, as Execute (whatever the pathogens).
+        static void ExecutePathogens(Cluster& cluster, DiseaseProfile disease_profile,
+                RngHandler& contact_handler, PathogenTracks&, unsigned int,
+                std::shared_ptr<const Calendar> calendar, bool is_work_off, bool is_school_off)
+        {
+                Execute(cluster, disease_profile, contact_handler, calendar, is_work_off, is_school_off);
+        }
+
+        /// Nothing is ever posted in this mode.
+        static void Deliver(const std::vector<InfectionMailbox::Letter>&, std::shared_ptr<const Calendar>) {}
 };
 
 /// Explicit instantiation in cpp file.
@@ -0,0 +1,70 @@
+#ifndef MEAN_FIELD_RULE_H_INCLUDED
+#define MEAN_FIELD_RULE_H_INCLUDED
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Header for the MeanFieldRule class.
+ */
+
+#include <cstddef>
+#include <string>
+
+namespace stride {
+
+/**
+ * When the Infector computes the transmission in a cluster from the force of infection
+ * of all its infectious members together, rather than per (infector, contact) pair:
+ * in clusters of at least a minimum size in which at least a minimum fraction of the
+ * members is infectious and present. Every present susceptible member is then infected
+ * with probability 1 - exp(-transmission rate * sum of the contact rates of the present
+ * infectious members), which is the probability that at least one of the pairwise trials
+ * transmits: one random draw per susceptible instead of one per pair.
+ */
+class MeanFieldRule
+{
+public:
+	/// Never applies.
+	MeanFieldRule() : m_min_size(0U), m_min_prevalence(0.0) {}
+
+	/// Applies to clusters of at least min_size members (0 for none) with at least the given prevalence.
+	MeanFieldRule(std::size_t min_size, double min_prevalence)
+		: m_min_size(min_size), m_min_prevalence(min_prevalence) {}
+
+	/// Does the rule apply to any cluster?
+	bool IsEnabled() const { return m_min_size > 0U; }
+
+	/// Does it apply to a cluster of the given size with the given number of infectious members present?
+	bool Applies(std::size_t size, std::size_t num_infectious) const
+	{
+		return IsEnabled() && size >= m_min_size && num_infectious >= m_min_prevalence * size;
+	}
+
+	/// Description of the rule, for reports.
+	std::string ToString() const
+	{
+		return IsEnabled() ? ("clusters of at least " + std::to_string(m_min_size) + " members with prevalence >= "
+		        + std::to_string(m_min_prevalence)) : "none";
+	}
+
+private:
+	std::size_t   m_min_size;         ///< Minimum number of members (0: the rule never applies).
+	double        m_min_prevalence;   ///< Minimum fraction of members infectious and present.
+};
+
+} // end_of_namespace
+
+#endif // include-guard
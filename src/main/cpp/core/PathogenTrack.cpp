@@ -0,0 +1,54 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Implementation of the PathogenTracks struct.
+ */
+
+#include "PathogenTrack.h"
+
+namespace stride {
+
+using namespace std;
+
+pair<size_t, size_t> PathogenTracks::Update()
+{
+        const size_t num_persons = tracks.empty() ? 0U : tracks.front().health.size();
+        infectious.resize(num_persons);
+        susceptible.resize(num_persons);
+
+        size_t num_infectious = 0U;
+        size_t num_may_infect = 0U;
+        for (size_t id = 0; id < num_persons; id++) {
+                uint32_t infectious_with = 0U;
+                uint32_t susceptible_to  = 0U;
+                bool may_infect = false;
+                for (size_t k = 0; k < tracks.size(); k++) {
+                        Health& health = tracks[k].health[id];
+                        health.Update();
+                        may_infect = may_infect || health.MayInfect();
+                        infectious_with |= static_cast<uint32_t>(health.IsInfectious()) << (k + 1U);
+                        susceptible_to  |= static_cast<uint32_t>(health.IsSusceptible()) << (k + 1U);
+                }
+                infectious[id]  = infectious_with;
+                susceptible[id] = susceptible_to;
+                num_infectious += (infectious_with != 0U);
+                num_may_infect += may_infect;
+        }
+        return make_pair(num_infectious, num_may_infect);
+}
+
+} // end_of_namespace
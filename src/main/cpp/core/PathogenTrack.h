@@ -0,0 +1,70 @@
+#ifndef PATHOGEN_TRACK_H_INCLUDED
+#define PATHOGEN_TRACK_H_INCLUDED
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Header for the PathogenTrack and PathogenTracks structs.
+ */
+
+#include "core/DiseaseProfile.h"
+#include "core/Health.h"
+#include "core/RngHandler.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace stride {
+
+/**
+ * Course of a further pathogen in a population, next to the one in the health of its
+ * persons: the disease profile, the health of every person with this pathogen (by person
+ * id) and the random streams of its transmissions (one per thread).
+ */
+struct PathogenTrack
+{
+	DiseaseProfile                  disease_profile;        ///< Profile of the disease.
+	std::vector<Health>             health;                 ///< Health of the persons, by id.
+	std::vector<RngHandler>         rng_handler;            ///< Random streams, one per thread.
+};
+
+/**
+ * The further pathogens of a population (at most 31), with for each person the ones that
+ * person is infectious with and susceptible to at the start of the day's cluster pass, as
+ * bit masks (bit k for the pathogen in tracks[k - 1]; bit 0 is for the health of the persons).
+ */
+struct PathogenTracks
+{
+	/// Update the disease of every person with every pathogen, and set the masks; returns
+	/// the number of persons that are infectious with, and that may infect with, some pathogen.
+	std::pair<std::size_t, std::size_t> Update();
+
+	/// Are there no further pathogens?
+	bool empty() const { return tracks.empty(); }
+
+	/// Number of further pathogens.
+	std::size_t size() const { return tracks.size(); }
+
+	std::vector<PathogenTrack>      tracks;                 ///< The pathogens.
+	std::vector<std::uint32_t>      infectious;             ///< Pathogens a person is infectious with, by id.
+	std::vector<std::uint32_t>      susceptible;            ///< Pathogens a person is susceptible to, by id.
+};
+
+} // end_of_namespace
+
+#endif // end-of-include-guard
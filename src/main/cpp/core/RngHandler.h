@@ -23,6 +23,8 @@
 #include "util/Random.h"
 #include "math.h"
 
+#include <string>
+
 namespace stride {
 
 /**
@@ -50,6 +52,15 @@ public:
 			return m_rng.NextDouble() < RateToProbability(transmission_rate * contact_rate);
 	}
 
+	/// Uniform number in [0, 1[.
+	double NextDouble() { return m_rng.NextDouble(); }
+
+	/// State of the random number engine.
+	std::string GetState() const { return m_rng.GetState(); }
+
+	/// Continue from the given state of the random number engine.
+	void SetState(const std::string& state) { m_rng.SetState(state); }
+
 	/// Check if two individuals have contact.
 	bool HasContact(double contact_rate)
 	{
@@ -0,0 +1,56 @@
+#ifndef OFFSPRING_FILE_H_INCLUDED
+#define OFFSPRING_FILE_H_INCLUDED
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Header for the OffspringFile class.
+ */
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace stride {
+namespace output {
+
+/**
+ * Produces a file with the offspring distribution of index case trials.
+ */
+class OffspringFile
+{
+public:
+	/// Constructor: initialize.
+	OffspringFile(const std::string& file = "stride_offspring");
+
+	/// Destructor: close the file stream.
+	~OffspringFile();
+
+	/// Print the number of trials with 0, 1, 2, ... offspring, one line each.
+	void Print(const std::vector<unsigned int>& distribution);
+
+private:
+	/// Generate file name and open the file stream.
+	void Initialize(const std::string& file);
+
+private:
+	std::ofstream 	m_fstream;  ///< The file stream.
+};
+
+} // end_of_namespace
+} // end_of_namespace
+
+#endif // end of include guard
@@ -0,0 +1,68 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Implementation of the RegionsFile class.
+ */
+
+#include "RegionsFile.h"
+
+#include "sim/Metapopulation.h"
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace stride {
+namespace output {
+
+using namespace std;
+
+RegionsFile::RegionsFile(const std::string& file)
+{
+	Initialize(file);
+}
+
+RegionsFile::~RegionsFile()
+{
+	m_fstream.close();
+}
+
+void RegionsFile::Initialize(const std::string& file)
+{
+	m_fstream.open((file + "_regions.csv").c_str());
+}
+
+void RegionsFile::Print(const Metapopulation& metapopulation, const vector<vector<unsigned int>>& cases)
+{
+	m_fstream << "city_id,city_name,population,commuters";
+	for (unsigned int d = 0; d < (cases.empty() ? 0U : cases[0].size()); d++) {
+		m_fstream << ",day_" << d;
+	}
+	m_fstream << endl;
+	for (size_t r = 0; r < metapopulation.GetNumRegions(); r++) {
+		const auto& region = metapopulation.GetRegion(r);
+		m_fstream << region.id << ",\"" << region.name << "\"," << region.num_persons << "," << region.num_commuters;
+		for (const auto c : cases[r]) {
+			m_fstream << "," << c;
+		}
+		m_fstream << endl;
+	}
+}
+
+} // end_of_namespace
+} // end_of_namespace
@@ -0,0 +1,59 @@
+#ifndef REGIONS_FILE_H_INCLUDED
+#define REGIONS_FILE_H_INCLUDED
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Header for the RegionsFile class.
+ */
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace stride {
+
+class Metapopulation;
+
+namespace output {
+
+/**
+ * Produces a file with the daily cases count of each region of a metapopulation.
+ */
+class RegionsFile
+{
+public:
+	/// Constructor: initialize.
+	RegionsFile(const std::string& file = "stride_regions");
+
+	/// Destructor: close the file stream.
+	~RegionsFile();
+
+	/// Print a line per region: its id, name, residents, commuters and cases by day.
+	void Print(const Metapopulation& metapopulation, const std::vector<std::vector<unsigned int>>& cases);
+
+private:
+	/// Generate file name and open the file stream.
+	void Initialize(const std::string& file);
+
+private:
+	std::ofstream 	m_fstream;  ///< The file stream.
+};
+
+} // end_of_namespace
+} // end_of_namespace
+
+#endif // end of include guard
@@ -38,7 +38,7 @@ SummaryFile::SummaryFile(const std::string& file)
 	// add header
 	m_fstream << "pop_file,num_days,pop_size,seeding_rate,"
 	        << "R0,transm_rate,immunity_rate,num_threads,rng_seed,run_time,"
-	        << "total_time,num_cases,AR" << endl;
+	        << "total_time,num_cases,AR,thread_layout,engine_days" << endl;
 }
 
 SummaryFile::~SummaryFile()
@@ -51,7 +51,9 @@ void SummaryFile::Print(
         unsigned int population_size,
         unsigned int num_cases,
         unsigned int run_time,
-        unsigned int total_time)
+        unsigned int total_time,
+        const string& thread_layout,
+        const string& engine_days)
 {
 	unsigned int num_threads = 0;
 
@@ -71,7 +73,9 @@ void SummaryFile::Print(
 		<< num_threads << ","
 		<< pt_config.get<unsigned int>("run.rng_seed") << ","
 		<< run_time << "," << total_time << "," << num_cases << ","
-		<< static_cast<double>(num_cases) / population_size << endl;
+		<< static_cast<double>(num_cases) / population_size << ","
+		<< thread_layout << ","
+		<< engine_days << endl;
 }
 
 } // end namespace
@@ -0,0 +1,60 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Implementation of the TimingsFile class.
+ */
+
+#include "TimingsFile.h"
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace stride {
+namespace output {
+
+using namespace std;
+
+TimingsFile::TimingsFile(const std::string& file)
+{
+	Initialize(file);
+}
+
+TimingsFile::~TimingsFile()
+{
+	m_fstream.close();
+}
+
+void TimingsFile::Initialize(const std::string& file)
+{
+	m_fstream.open((file + "_timings.csv").c_str());
+}
+
+void TimingsFile::Print(const vector<double>& times)
+{
+	if (times.empty()) {
+		return;
+	}
+	for(unsigned int i = 0; i < (times.size()-1); i++) {
+		m_fstream << times[i] << "," ;
+	}
+	m_fstream << times[times.size()-1] << endl;
+}
+
+} // end_of_namespace
+} // end_of_namespace
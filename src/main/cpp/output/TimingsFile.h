@@ -0,0 +1,56 @@
+#ifndef TIMINGS_FILE_H_INCLUDED
+#define TIMINGS_FILE_H_INCLUDED
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Header for the TimingsFile class.
+ */
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace stride {
+namespace output {
+
+/**
+ * Produces a file with the run time of each day, in milliseconds.
+ */
+class TimingsFile
+{
+public:
+	/// Constructor: initialize.
+	TimingsFile(const std::string& file = "stride_timings");
+
+	/// Destructor: close the file stream.
+	~TimingsFile();
+
+	/// Print the given run times.
+	void Print(const std::vector<double>& times);
+
+private:
+	/// Generate file name and open the file stream.
+	void Initialize(const std::string& file);
+
+private:
+	std::ofstream 	m_fstream;  ///< The file stream.
+};
+
+} // end_of_namespace
+} // end_of_namespace
+
+#endif // end of include guard
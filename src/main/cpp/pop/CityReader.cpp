@@ -0,0 +1,99 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Implementation of the CityReader class.
+ */
+
+#include "CityReader.h"
+
+#include "util/InstallDirs.h"
+#include "util/StringUtils.h"
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+namespace stride {
+
+using namespace std;
+using namespace stride::util;
+
+vector<CityReader::City> CityReader::Read(const string& regions_file, const string& commuting_file)
+{
+        // Cities and their share of the population.
+        vector<City> cities;
+        map<unsigned int, size_t> city_of;
+        for (const auto& fields : ReadTable(regions_file)) {
+                if (fields.size() < 4U) {
+                        throw runtime_error(string(__func__) + "> Bad line in " + regions_file);
+                }
+                const auto id = StringUtils::FromString<unsigned int>(fields[0]);
+                city_of[id] = cities.size();
+                cities.push_back(City { id, fields[1], StringUtils::FromString<double>(fields[3]), {} });
+        }
+        if (cities.empty() || city_of.size() != cities.size()) {
+                throw runtime_error(string(__func__) + "> No cities or duplicate cities in " + regions_file);
+        }
+
+        // Where the workers of each city work, among the cities of the regions file.
+        if ( !commuting_file.empty() ) {
+                for (const auto& fields : ReadTable(commuting_file)) {
+                        if (fields.size() < 3U) {
+                                throw runtime_error(string(__func__) + "> Bad line in " + commuting_file);
+                        }
+                        const auto from = city_of.find(StringUtils::FromString<unsigned int>(fields[0]));
+                        const auto to   = city_of.find(StringUtils::FromString<unsigned int>(fields[1]));
+                        if (from != city_of.end() && to != city_of.end()) {
+                                cities[from->second].destinations.emplace_back(to->second,
+                                        StringUtils::FromString<double>(fields[2]));
+                        }
+                }
+        }
+        return cities;
+}
+
+vector<vector<string>> CityReader::ReadTable(const string& file_name)
+{
+        const auto file_path = InstallDirs::GetDataDir() / file_name;
+        std::ifstream file(file_path.string());
+        if ( !file ) {
+                throw runtime_error(string(__func__) + "> No file " + file_path.string());
+        }
+        stringstream ss;
+        ss << file.rdbuf();
+        string text = ss.str();
+        replace(text.begin(), text.end(), '\r', '\n');
+
+        vector<vector<string>> lines;
+        istringstream is(text);
+        string line;
+        getline(is, line);
+        while (getline(is, line)) {
+                if (StringUtils::Trim(line).empty()) {
+                        continue;
+                }
+                lines.push_back(StringUtils::Split(StringUtils::Trim(line), ",;"));
+                for (auto& field : lines.back()) {
+                        field = StringUtils::Trim(field, "\"");
+                }
+        }
+        return lines;
+}
+
+} // end_of_namespace
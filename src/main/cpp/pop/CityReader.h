@@ -0,0 +1,59 @@
+#ifndef CITY_READER_H_INCLUDED
+#define CITY_READER_H_INCLUDED
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Header for the CityReader class.
+ */
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace stride {
+
+/**
+ * Reads the reference data on cities in the data directory: the cities with their share
+ * of the population (regions file: city_id, city_name, province, population share, ...)
+ * and the commuting between them (commuting file: city_depart, city_arrival, proportion).
+ */
+class CityReader
+{
+public:
+	/// A city of the regions file.
+	struct City
+	{
+		unsigned int                                     id;             ///< City id.
+		std::string                                      name;           ///< City name.
+		double                                           share;          ///< Share of the population.
+		std::vector<std::pair<std::size_t, double>>      destinations;   ///< Cities of work (index) and their proportion.
+	};
+
+	/// The cities of the regions file, in its order, with the destinations of their workers
+	/// in the commuting file (none without one): the cities of the regions file, the city
+	/// itself included, and the proportion of the workers that works there.
+	static std::vector<City> Read(const std::string& regions_file, const std::string& commuting_file = "");
+
+	/// The lines after the header of a reference file in the data directory (lines may end in
+	/// a carriage return only), split at commas and semicolons into unquoted fields.
+	static std::vector<std::vector<std::string>> ReadTable(const std::string& file_name);
+};
+
+} // end_of_namespace
+
+#endif // end-of-include-guard
@@ -43,34 +43,22 @@ unsigned int Person::GetClusterId(ClusterType cluster_type) const
         }
 }
 
-bool Person::IsInCluster(ClusterType c) const
+bool Person::IsInCluster(ClusterType c, bool is_work_off, bool is_school_off) const
 {
+        const bool is_off = is_work_off || (m_age <= MinAdultAge() && is_school_off);
         switch(c) {
-                case ClusterType::Household:           return m_at_household;
-                case ClusterType::School:              return m_at_school;
-                case ClusterType::Work:                return m_at_work;
-                case ClusterType::PrimaryCommunity:    return m_at_primary_community;
-                case ClusterType::SecondaryCommunity:  return m_at_secondary_community;
+                case ClusterType::Household:           return true;
+                case ClusterType::School:              return !is_off;
+                case ClusterType::Work:                return !is_off;
+                case ClusterType::PrimaryCommunity:    return is_off;
+                case ClusterType::SecondaryCommunity:  return !is_off;
                 default: throw runtime_error(string(__func__)  + "> Should not reach default.");
         }
 }
 
-void Person::Update(bool is_work_off, bool is_school_off)
+void Person::Update()
 {
         m_health.Update();
-
-        // Update presence in clusters.
-        if (is_work_off || (m_age <= MinAdultAge() && is_school_off)) {
-        		m_at_school             = false;
-                m_at_work               = false;
-                m_at_secondary_community = false;
-                m_at_primary_community  = true;
-        } else {
-        		m_at_school             = true;
-        		m_at_work               = true;
-                m_at_secondary_community = true;
-                m_at_primary_community  = false;
-        }
 }
 
 } // end_of_namespace
@@ -37,6 +37,9 @@ enum class ClusterType;
 class Person
 {
 public:
+	/// Uninitialized person (for storage that is filled in later).
+	Person() = default;
+
 	/// Constructor: set the person data.
 	Person(unsigned int id, double age, unsigned int household_id, unsigned int school_id,
 			unsigned int work_id,unsigned int primary_community_id, unsigned int secondary_community_id, unsigned int start_infectiousness,
@@ -44,7 +47,6 @@ public:
 		: m_id(id), m_age(age), m_gender('M'),
 		  m_household_id(household_id), m_school_id(school_id),
 		  m_work_id(work_id), m_primary_community_id(primary_community_id), m_secondary_community_id(secondary_community_id),
-		  m_at_household(true), m_at_school(true),m_at_work(true),m_at_primary_community(true), m_at_secondary_community(true),
 		  m_health(start_infectiousness, start_symptomatic, time_infectious, time_symptomatic),
 		  m_is_participant(false) {}
 
@@ -69,8 +71,9 @@ public:
 	/// Get the id.
         unsigned int GetId() const { return m_id; }
 
-    /// Check if a person is present today in a given cluster
-    bool IsInCluster(ClusterType c) const;
+    /// Check if a person is present today in a given cluster, given today's days off. Presence
+    /// is not stored, so that only persons whose health changes are written during a day.
+    bool IsInCluster(ClusterType c, bool is_work_off, bool is_school_off) const;
 
 	/// Does this person participates in the social contact study?
 	bool IsParticipatingInSurvey() const { return m_is_participant; }
@@ -78,8 +81,8 @@ public:
 	/// Participate in social contact study and log person details
 	void ParticipateInSurvey() { m_is_participant = true; }
 
-	/// Update the health status and presence in clusters.
-	void Update(bool is_work_off, bool is_school_off);
+	/// Update the health status.
+	void Update();
 
 private:
 	unsigned int    m_id;                     ///< The id.
@@ -92,12 +95,6 @@ private:
 	unsigned int    m_primary_community_id;   ///< The primary community id
 	unsigned int    m_secondary_community_id; ///< The secondary community id
 
-	bool            m_at_household;           ///< Is person present at household today?
-	bool            m_at_school;              ///< Is person present at school today?
-	bool            m_at_work;                ///< Is person present at work today?
-	bool            m_at_primary_community;   ///< Is person present at primary_community today?
-	bool            m_at_secondary_community;  ///< Is person present at secundary_community today?
-
 	Health          m_health;                ///< Health info for this person.
 
 	bool            m_is_participant;        ///< Is participating in the social contact study
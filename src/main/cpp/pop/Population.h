@@ -23,6 +23,8 @@
 #include "Person.h"
 #include "core/Health.h"
 
+#include "util/NumaAllocator.h"
+
 #include <numeric>
 #include <vector>
 
@@ -31,9 +33,18 @@ namespace stride {
 /**
  * Container for persons in population.
  */
-class Population : public std::vector<Person>
+class Population : public std::vector<Person, util::NumaAllocator<Person>>
 {
 public:
+	/// Empty population, kept in memory.
+	Population() = default;
+
+	/// Empty population, kept as the allocator's storage says.
+	explicit Population(const allocator_type& allocator) : vector(allocator) {}
+
+	/// Copy of the persons of another population, kept as the allocator's storage says.
+	Population(const Population& other, const allocator_type& allocator) : vector(other, allocator) {}
+
 	/// Get the cumulative number of cases.
 	unsigned int GetInfectedCount() const
 	{
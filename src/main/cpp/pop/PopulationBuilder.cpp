@@ -20,9 +20,13 @@
 
 #include "PopulationBuilder.h"
 
+#include "core/ClusterType.h"
 #include "core/Health.h"
 #include "pop/Person.h"
 #include "pop/Population.h"
+#include "pop/PopulationOrdering.h"
+#include "util/AliasTable.h"
+#include "util/InputBuffer.h"
 #include "util/InstallDirs.h"
 #include "util/Random.h"
 #include "util/StringUtils.h"
@@ -31,16 +35,110 @@
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/xml_parser.hpp>
 #include <boost/filesystem.hpp>
-#include <boost/filesystem/fstream.hpp>
+#include <omp.h>
 
-#include <fstream>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <functional>
 #include <iostream>
+#include <limits>
 #include <memory>
+#include <numeric>
 #include <string>
 #include <vector>
 
 namespace stride {
 
+namespace {
+
+/// Position right after the end of the line starting at first (or last).
+inline const char* NextLine(const char* first, const char* last)
+{
+        if (first == last) {
+                return last;
+        }
+        const void* nl = memchr(first, '\n', static_cast<size_t>(last - first));
+        return (nl != nullptr) ? static_cast<const char*>(nl) + 1 : last;
+}
+
+/// Does the line starting at first contain nothing but blanks?
+inline bool IsBlank(const char* first, const char* last)
+{
+        for (const char* it = first; it != last && *it != '\n'; ++it) {
+                if (*it != ' ' && *it != '\t' && *it != '\r') {
+                        return false;
+                }
+        }
+        return true;
+}
+
+/**
+ * Parse the comma separated unsigned fields of the line starting at first. Quotes
+ * and blanks in front of a field are skipped; anything following the digits of a field
+ * (e.g. the fractional part of an age) is ignored up to the next comma.
+ */
+template<std::size_t N>
+bool ParseRecord(const char* first, const char* last, std::array<unsigned int, N>& values)
+{
+        const char* eol = NextLine(first, last);
+        const char* it  = first;
+        for (std::size_t i = 0; i < N; i++) {
+                while (it != eol && (*it == ' ' || *it == '\t' || *it == '"')) {
+                        ++it;
+                }
+                const char* digits_end = util::StringUtils::ParseUnsigned(it, eol, values[i]);
+                if (digits_end == it) {
+                        return false;
+                }
+                it = std::find(digits_end, eol, ',');
+                if (i + 1 < N) {
+                        if (it == eol) {
+                                return false;
+                        }
+                        ++it;
+                }
+        }
+        return true;
+}
+
+/**
+ * Sample the disease characteristics of the persons with id first_id, ..., last_id - 1, each
+ * from its own segment of the random stream, and hand them to set(id, start_infectiousness,
+ * start_symptomatic, time_infectious, time_symptomatic). The one definition of these draws,
+ * for every way of building a population.
+ * The random stream is left as is: the caller steps over the draws of all persons.
+ */
+template<typename Setter>
+void SampleCharacteristics(const boost::property_tree::ptree& pt_disease, std::size_t first_id, std::size_t last_id,
+        unsigned int num_draws_per_person, const util::Random& rng, Setter set)
+{
+        using util::AliasTable;
+        const auto distrib_start_infectiousness = AliasTable::FromCumulative(PopulationBuilder::GetDistribution(pt_disease, "disease.start_infectiousness"));
+        const auto distrib_start_symptomatic    = AliasTable::FromCumulative(PopulationBuilder::GetDistribution(pt_disease, "disease.start_symptomatic"));
+        const auto distrib_time_infectious      = AliasTable::FromCumulative(PopulationBuilder::GetDistribution(pt_disease, "disease.time_infectious"));
+        const auto distrib_time_symptomatic     = AliasTable::FromCumulative(PopulationBuilder::GetDistribution(pt_disease, "disease.time_symptomatic"));
+
+        const std::size_t n = last_id - first_id;
+        const std::size_t num_chunks = std::max<std::size_t>(1U, std::min<std::size_t>(n / 4096U, 8U * static_cast<std::size_t>(omp_get_max_threads())));
+        #pragma omp parallel for schedule(dynamic)
+        for (std::size_t c = 0; c < num_chunks; c++) {
+                const std::size_t chunk_first = first_id + n * c / num_chunks;
+                const std::size_t chunk_last  = first_id + n * (c + 1) / num_chunks;
+                util::Random chunk_rng(rng);
+                chunk_rng.Discard(num_draws_per_person * chunk_first);
+                for (std::size_t id = chunk_first; id < chunk_last; id++) {
+                        const auto start_infectiousness = distrib_start_infectiousness.Sample(chunk_rng.NextDouble());
+                        const auto start_symptomatic    = distrib_start_symptomatic.Sample(chunk_rng.NextDouble());
+                        const auto time_infectious      = distrib_time_infectious.Sample(chunk_rng.NextDouble());
+                        const auto time_symptomatic     = distrib_time_symptomatic.Sample(chunk_rng.NextDouble());
+                        set(id, start_infectiousness, start_symptomatic, time_infectious, time_symptomatic);
+                }
+        }
+}
+
+}
+
 using namespace std;
 using namespace boost::filesystem;
 using namespace boost::property_tree;
@@ -49,16 +147,57 @@ using namespace stride::util;
 shared_ptr<Population> PopulationBuilder::Build(
         const boost::property_tree::ptree& pt_config,
         const boost::property_tree::ptree& pt_disease,
-        util::Random& rng)
+        util::Random& rng,
+        shared_ptr<const Storage> storage)
+{
+        const auto file_name = pt_config.get<string>("run.population_file");
+        const auto file_path = InstallDirs::GetDataDir() /= file_name;
+        if ( !is_regular_file(file_path) ) {
+                throw runtime_error(string(__func__)
+                        + "> Population file " + file_path.string() + " not present.");
+        }
+        const InputBuffer pop_buffer(file_path);
+
+        return Build(pt_config, [&](Population& population) {
+                AddPersons(population, pop_buffer, pt_disease, rng); }, rng, storage);
+}
+
+shared_ptr<Population> PopulationBuilder::Build(
+        const boost::property_tree::ptree& pt_config,
+        const boost::property_tree::ptree& pt_disease,
+        istream& pop_stream,
+        util::Random& rng,
+        shared_ptr<const Storage> storage)
+{
+        const InputBuffer pop_buffer(pop_stream);
+        return Build(pt_config, [&](Population& population) {
+                AddPersons(population, pop_buffer, pt_disease, rng); }, rng, storage);
+}
+
+shared_ptr<Population> PopulationBuilder::Build(
+        const boost::property_tree::ptree& pt_config,
+        const boost::property_tree::ptree& pt_disease,
+        const RecordSource& records,
+        util::Random& rng,
+        shared_ptr<const Storage> storage)
+{
+        return Build(pt_config, [&](Population& population) {
+                AddRecords(population, records, pt_disease, rng); }, rng, storage);
+}
+
+shared_ptr<Population> PopulationBuilder::Build(
+        const boost::property_tree::ptree& pt_config,
+        const function<void(Population&)>& add_persons,
+        util::Random& rng,
+        shared_ptr<const Storage> storage)
 {
         //------------------------------------------------
         // Setup.
         //------------------------------------------------
-        const auto pop                    = make_shared<Population>();
+        const auto pop                    = make_shared<Population>(Population::allocator_type(storage));
         Population& population            = *pop;
         const double seeding_rate         = pt_config.get<double>("run.seeding_rate");
         const double immunity_rate        = pt_config.get<double>("run.immunity_rate");
-        const string disease_config_file  = pt_config.get<string>("run.disease_config_file");
 
         //------------------------------------------------
         // Check input.
@@ -71,47 +210,7 @@ shared_ptr<Population> PopulationBuilder::Build(
         //------------------------------------------------
         // Add persons to population.
         //------------------------------------------------
-        const auto file_name = pt_config.get<string>("run.population_file");;
-        const auto file_path = InstallDirs::GetDataDir() /= file_name;
-        if ( !is_regular_file(file_path) ) {
-                throw runtime_error(string(__func__)
-                        + "> Population file " + file_path.string() + " not present.");
-        }
-
-        boost::filesystem::ifstream pop_file;
-        pop_file.open(file_path.string());
-        if ( !pop_file.is_open()) {
-                throw runtime_error(string(__func__)
-                        + "> Error opening population file " + file_path.string());
-        }
-
-        const auto distrib_start_infectiousness = GetDistribution(pt_disease, "disease.start_infectiousness");
-        const auto distrib_start_symptomatic    = GetDistribution(pt_disease, "disease.start_symptomatic");
-        const auto distrib_time_infectious      = GetDistribution(pt_disease, "disease.time_infectious");
-        const auto distrib_time_symptomatic     = GetDistribution(pt_disease, "disease.time_symptomatic");
-
-        string line;
-        getline(pop_file, line); // step over file header
-        unsigned int person_id = 0U;
-        while (getline(pop_file, line)) {
-                // Make use of stochastic disease characteristics.
-                const auto start_infectiousness = Sample(rng, distrib_start_infectiousness);
-                const auto start_symptomatic    = Sample(rng, distrib_start_symptomatic);
-                const auto time_infectious      = Sample(rng, distrib_time_infectious);
-                const auto time_symptomatic     = Sample(rng, distrib_time_symptomatic);
-                const auto values = StringUtils::Split(line, ",");
-                population.emplace_back(Person(person_id,
-                        StringUtils::FromString<unsigned int>(values[0]),
-                        StringUtils::FromString<unsigned int>(values[1]),
-                        StringUtils::FromString<unsigned int>(values[2]),
-                        StringUtils::FromString<unsigned int>(values[3]),
-                        StringUtils::FromString<unsigned int>(values[4]),
-                        StringUtils::FromString<unsigned int>(values[5]),
-                        start_infectiousness, start_symptomatic, time_infectious, time_symptomatic));
-                ++person_id;
-        }
-
-        pop_file.close();
+        add_persons(population);
 
         //------------------------------------------------
         // Customize the population.
@@ -121,6 +220,70 @@ shared_ptr<Population> PopulationBuilder::Build(
         if ( max_population_index <= 1U) {
                 throw runtime_error(string(__func__) + "> Problem with population size.");
         }
+        //------------------------------------------------
+        // Set survey participants, immunity and seeding.
+        //------------------------------------------------
+        InitializeHealth(pt_config, population, rng);
+
+        //------------------------------------------------
+        // Order persons in memory.
+        //------------------------------------------------
+        PopulationOrdering::Apply(pt_config, population);
+
+        //------------------------------------------------
+        // Done
+        //------------------------------------------------
+        return pop;
+}
+
+
+void PopulationBuilder::Reseed(
+        const boost::property_tree::ptree& pt_config,
+        const boost::property_tree::ptree& pt_disease,
+        Population& population,
+        util::Random& rng)
+{
+        const double seeding_rate  = pt_config.get<double>("run.seeding_rate");
+        const double immunity_rate = pt_config.get<double>("run.immunity_rate");
+        if ( !((seeding_rate <= 1) && (immunity_rate <= 1) && ((seeding_rate + immunity_rate) <= 1)) ) {
+                throw runtime_error(string(__func__) + "> Bad input data.");
+        }
+        if ( population.size() <= 2U ) {
+                throw runtime_error(string(__func__) + "> Problem with population size.");
+        }
+
+        // Persons may have been ordered in memory: go through them by id, which is the
+        // position of their record in the population file.
+        const size_t n = population.size();
+        vector<size_t> position(n);
+        for (size_t i = 0; i < n; i++) {
+                position[population[i].GetId()] = i;
+        }
+
+        // Same draws from the same segments of the random stream as AddPersons.
+        SampleCharacteristics(pt_disease, 0U, n, NumDrawsPerPerson(), rng, [&](size_t id,
+                unsigned int start_infectiousness, unsigned int start_symptomatic,
+                unsigned int time_infectious, unsigned int time_symptomatic) {
+                Person& p = population[position[id]];
+                p = Person(p.GetId(), p.GetAge(), p.GetClusterId(ClusterType::Household),
+                        p.GetClusterId(ClusterType::School), p.GetClusterId(ClusterType::Work),
+                        p.GetClusterId(ClusterType::PrimaryCommunity), p.GetClusterId(ClusterType::SecondaryCommunity),
+                        start_infectiousness, start_symptomatic, time_infectious, time_symptomatic);
+        });
+        rng.Discard(NumDrawsPerPerson() * n);
+
+        InitializeHealth(pt_config, population, rng);
+}
+
+void PopulationBuilder::InitializeHealth(const boost::property_tree::ptree& pt_config,
+        Population& population, util::Random& rng)
+{
+        // Subsets are drawn over the persons in the order of the population file.
+        vector<size_t> position(population.size());
+        for (size_t i = 0; i < population.size(); i++) {
+                position[population[i].GetId()] = i;
+        }
+
         //------------------------------------------------
         // Set participants in social contact survey.
         //------------------------------------------------
@@ -128,50 +291,168 @@ shared_ptr<Population> PopulationBuilder::Build(
         if ( log_level == "Contacts" ) {
                 const unsigned int num_participants = pt_config.get<double>("run.num_participants_survey");
 
-                // use a while-loop to obtain 'num_participant' unique participants (default sampling is with replacement)
-                // A for loop will not do because we might draw the same person twice.
-                unsigned int num_samples = 0;
+                const auto participants = DrawSubset(rng, population.size(), num_participants);
                 const shared_ptr<spdlog::logger> logger = spdlog::get("contact_logger");
-                while(num_samples < num_participants){
-                        Person& p = population[rng(max_population_index)];
-                        if ( !p.IsParticipatingInSurvey() ) {
+                for (size_t i = 0; i < population.size(); i++) {
+                        if (participants[i]) {
+                                Person& p = population[position[i]];
                                 p.ParticipateInSurvey();
                                 logger->info("[PART] {} {} {}", p.GetId(), p.GetAge(), p.GetGender());
-                                num_samples++;
                         }
                 }
         }
 
         //------------------------------------------------
-        // Set population immunity.
+        // Set population immunity and seed infected persons.
         //------------------------------------------------
-        unsigned int num_immune = floor(static_cast<double>(population.size()) * immunity_rate);
-        while (num_immune > 0) {
-                Person& p = population[rng(max_population_index)];
-                if (p.GetHealth().IsSusceptible()) {
-                        p.GetHealth().SetImmune();
-                        num_immune--;
+        vector<Health*> health(population.size());
+        for (size_t i = 0; i < population.size(); i++) {
+                health[i] = &population[position[i]].GetHealth();
+        }
+        DrawImmunityAndSeeding(pt_config, health, rng);
+}
+
+vector<Health> PopulationBuilder::DrawHealth(
+        const boost::property_tree::ptree& pt_config,
+        const boost::property_tree::ptree& pt_disease,
+        size_t num_persons,
+        util::Random& rng)
+{
+        const double seeding_rate  = pt_config.get<double>("run.seeding_rate");
+        const double immunity_rate = pt_config.get<double>("run.immunity_rate");
+        if ( !((seeding_rate <= 1) && (immunity_rate <= 1) && ((seeding_rate + immunity_rate) <= 1)) ) {
+                throw runtime_error(string(__func__) + "> Bad input data.");
+        }
+
+        vector<Health> health(num_persons);
+        SampleCharacteristics(pt_disease, 0U, num_persons, NumDrawsPerPerson(), rng, [&](size_t id,
+                unsigned int start_infectiousness, unsigned int start_symptomatic,
+                unsigned int time_infectious, unsigned int time_symptomatic) {
+                health[id] = Health(start_infectiousness, start_symptomatic, time_infectious, time_symptomatic);
+        });
+        rng.Discard(NumDrawsPerPerson() * num_persons);
+
+        vector<Health*> health_of(num_persons);
+        for (size_t id = 0; id < num_persons; id++) {
+                health_of[id] = &health[id];
+        }
+        DrawImmunityAndSeeding(pt_config, health_of, rng);
+        return health;
+}
+
+void PopulationBuilder::DrawImmunityAndSeeding(const boost::property_tree::ptree& pt_config,
+        const vector<Health*>& health, util::Random& rng)
+{
+        const double seeding_rate  = pt_config.get<double>("run.seeding_rate");
+        const double immunity_rate = pt_config.get<double>("run.immunity_rate");
+
+        // Draw the persons for both at once, then split them.
+        const size_t num_immune   = floor(static_cast<double>(health.size()) * immunity_rate);
+        const size_t num_infected = floor(static_cast<double>(health.size()) * seeding_rate);
+        const auto selected = DrawSubset(rng, health.size(), num_immune + num_infected);
+        vector<Health*> selected_health;
+        selected_health.reserve(num_immune + num_infected);
+        for (size_t i = 0; i < health.size(); i++) {
+                if (selected[i]) {
+                        selected_health.push_back(health[i]);
                 }
         }
+        const auto infected = DrawSubset(rng, selected_health.size(), num_infected);
+        for (size_t i = 0; i < selected_health.size(); i++) {
+                if (infected[i]) {
+                        selected_health[i]->StartInfection();
+                } else {
+                        selected_health[i]->SetImmune();
+                }
+        }
+}
 
-        //------------------------------------------------
-        // Seed infected persons.
-        //------------------------------------------------
-        unsigned int num_infected = floor(static_cast<double> (population.size()) * seeding_rate);
-        while (num_infected > 0) {
-                Person& p = population[rng(max_population_index)];
-                if (p.GetHealth().IsSusceptible()) {
-                        p.GetHealth().StartInfection();
-                        num_infected--;
+
+void PopulationBuilder::AddPersons(Population& population, const InputBuffer& pop_buffer,
+        const boost::property_tree::ptree& pt_disease, util::Random& rng)
+{
+        // Step over file header and split the remainder in newline-aligned chunks.
+        const char* first = NextLine(pop_buffer.begin(), pop_buffer.end());
+        const char* last  = pop_buffer.end();
+        const size_t num_chunks = max<size_t>(1U, min<size_t>(static_cast<size_t>(last - first) / (1U << 16U),
+                8U * static_cast<size_t>(omp_get_max_threads())));
+        const auto chunks = InputBuffer::SplitLines(first, last, num_chunks);
+
+        // Count the lines and the records (non-blank lines) in every chunk: this
+        // fixes the person id of every record and lets us size the population up front.
+        vector<size_t> line_offset(chunks.size() + 1, 0U);
+        vector<size_t> person_offset(chunks.size() + 1, 0U);
+        #pragma omp parallel for schedule(dynamic)
+        for (size_t i = 0; i < chunks.size(); i++) {
+                for (const char* it = chunks[i].first; it < chunks[i].second; it = NextLine(it, chunks[i].second)) {
+                        ++line_offset[i + 1];
+                        person_offset[i + 1] += !IsBlank(it, chunks[i].second);
                 }
         }
+        partial_sum(line_offset.begin(), line_offset.end(), line_offset.begin());
+        partial_sum(person_offset.begin(), person_offset.end(), person_offset.begin());
+        population.resize(person_offset.back());
 
-        //------------------------------------------------
-        // Done
-        //------------------------------------------------
-        return pop;
+        // Parse the chunks.
+        size_t bad_line = numeric_limits<size_t>::max();
+        #pragma omp parallel for schedule(dynamic)
+        for (size_t i = 0; i < chunks.size(); i++) {
+                size_t line_index = line_offset[i];
+                size_t person_id  = person_offset[i];
+                for (const char* it = chunks[i].first; it < chunks[i].second; it = NextLine(it, chunks[i].second)) {
+                        if (IsBlank(it, chunks[i].second)) {
+                                ++line_index;
+                                continue;
+                        }
+                        array<unsigned int, 6> values;
+                        if ( !ParseRecord(it, chunks[i].second, values) ) {
+                                #pragma omp critical(population_parse_error)
+                                bad_line = min(bad_line, line_index);
+                                break;
+                        }
+                        population[person_id] = Person(person_id, values[0], values[1], values[2], values[3],
+                                values[4], values[5], 0U, 0U, 0U, 0U);
+                        ++line_index;
+                        ++person_id;
+                }
+        }
+        if (bad_line != numeric_limits<size_t>::max()) {
+                // Report line numbers one-based and counting the header.
+                throw runtime_error(string(__func__) + "> Bad population file data at line "
+                        + to_string(bad_line + 2));
+        }
+
+        // A person's disease characteristics are drawn from that person's own segment of the
+        // random stream, so they do not depend on the chunking or the thread count. Then leave
+        // the random stream where the sequential draws would have left it.
+        SampleCharacteristics(pt_disease, 0U, population.size(), NumDrawsPerPerson(), rng, [&](size_t id,
+                unsigned int start_infectiousness, unsigned int start_symptomatic,
+                unsigned int time_infectious, unsigned int time_symptomatic) {
+                population[id].GetHealth() = Health(start_infectiousness, start_symptomatic, time_infectious, time_symptomatic);
+        });
+        rng.Discard(NumDrawsPerPerson() * population.size());
 }
 
+void PopulationBuilder::AddRecords(Population& population, const RecordSource& records,
+        const boost::property_tree::ptree& pt_disease, util::Random& rng)
+{
+        // Every batch in turn: a person's disease characteristics are drawn from the same
+        // segment of the random stream as for the record in a population file.
+        records([&](const vector<Record>& batch) {
+                const size_t first_id = population.size();
+                population.resize(first_id + batch.size());
+                SampleCharacteristics(pt_disease, first_id, population.size(), NumDrawsPerPerson(), rng, [&](size_t id,
+                        unsigned int start_infectiousness, unsigned int start_symptomatic,
+                        unsigned int time_infectious, unsigned int time_symptomatic) {
+                        const Record& r = batch[id - first_id];
+                        population[id] = Person(id, r[0], r[1], r[2], r[3], r[4], r[5], start_infectiousness,
+                                start_symptomatic, time_infectious, time_symptomatic);
+                });
+        });
+
+        // Leave the random stream where the sequential draws would have left it.
+        rng.Discard(NumDrawsPerPerson() * population.size());
+}
 
 vector<double> PopulationBuilder::GetDistribution(const boost::property_tree::ptree& pt_root, const string& xml_tag)
 {
@@ -183,16 +464,26 @@ vector<double> PopulationBuilder::GetDistribution(const boost::property_tree::pt
         return values;
 }
 
-unsigned int PopulationBuilder::Sample(Random& rng, const vector<double>& distribution)
+vector<bool> PopulationBuilder::DrawSubset(Random& rng, size_t n, size_t k)
 {
-        double random_value = rng.NextDouble();
-        for(unsigned int i = 0; i < distribution.size(); i++) {
-                if (random_value <= distribution[i]) {
-                        return i;
-                }
+        if (k > n) {
+                throw runtime_error(string(__func__) + "> Cannot draw " + to_string(k)
+                        + " out of " + to_string(n) + ".");
+        }
+
+        // Floyd's algorithm: one draw per selected element, no rejections. For
+        // large subsets, select the (smaller) complement instead.
+        const bool complement = (k > n / 2);
+        const size_t m = complement ? n - k : k;
+        vector<bool> selected(n, false);
+        for (size_t j = n - m; j < n; j++) {
+                const size_t t = rng(static_cast<unsigned int>(j + 1));
+                selected[selected[t] ? j : t] = true;
+        }
+        if (complement) {
+                selected.flip();
         }
-        cerr << "WARNING: PROBLEM WITH DISEASE DISTRIBUTION [PopulationBuilder]" << endl;
-        return distribution.size();
+        return selected;
 }
 
 } // end_of_namespace
@@ -21,39 +21,141 @@
  */
 
 #include "Population.h"
+#include "core/Health.h"
 #include "util/Random.h"
 
 #include <boost/property_tree/ptree.hpp>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <istream>
 #include <memory>
 #include <string>
 #include <vector>
 
 namespace stride {
 
+namespace util {
+class InputBuffer;
+}
+
 /**
  * Initializes Population objects.
  */
 class PopulationBuilder
 {
 public:
+	/// Record of a person as in the population files: age and the ids of household, school,
+	/// work, primary community and secondary community (0 for none).
+	using Record = std::array<unsigned int, 6>;
+
+	/// Takes the records of the next persons of a population.
+	using RecordSink = std::function<void(const std::vector<Record>&)>;
+
+	/// Hands the records of all persons of a population to the sink, batch by batch.
+	using RecordSource = std::function<void(const RecordSink&)>;
+
 	/**
 	 * Initializes a Population: add persons, set immunity, seed infection.
 	 *
 	 * @param pt_config       Property_tree with generalconfiguration settings.
 	 * @param pt_disease      Property_tree with disease configuration settings.
+	 * @param storage         Where the persons are kept (in memory if none).
 	 * @return                Pointer to the initialized population.
 	 */
 	static std::shared_ptr<Population> Build(
 	        const boost::property_tree::ptree& pt_config,
 	        const boost::property_tree::ptree& pt_disease,
+	        util::Random& rng,
+	        std::shared_ptr<const util::Storage> storage = nullptr);
+
+	/**
+	 * Initializes a Population as above, but reads the persons from a stream
+	 * (plain or gzip compressed) instead of the configured population file.
+	 */
+	static std::shared_ptr<Population> Build(
+	        const boost::property_tree::ptree& pt_config,
+	        const boost::property_tree::ptree& pt_disease,
+	        std::istream& pop_stream,
+	        util::Random& rng,
+	        std::shared_ptr<const util::Storage> storage = nullptr);
+
+	/**
+	 * Initializes a Population as above, from the records of the source instead of the
+	 * configured population file: the same population as from a file with these records,
+	 * without their text. Only one batch of records needs to be in memory at a time.
+	 */
+	static std::shared_ptr<Population> Build(
+	        const boost::property_tree::ptree& pt_config,
+	        const boost::property_tree::ptree& pt_disease,
+	        const RecordSource& records,
+	        util::Random& rng,
+	        std::shared_ptr<const util::Storage> storage = nullptr);
+
+	/**
+	 * Re-draws the disease characteristics, survey participation, immunity and seeding of
+	 * the persons of a population built earlier (with any seed), exactly as a build from
+	 * the same file with this configuration and random stream would have drawn them. The
+	 * persons keep their position in memory and the random stream is left where such a
+	 * build leaves it.
+	 */
+	static void Reseed(
+	        const boost::property_tree::ptree& pt_config,
+	        const boost::property_tree::ptree& pt_disease,
+	        Population& population,
+	        util::Random& rng);
+
+	/**
+	 * Draws the health of the persons 0, ..., num_persons - 1 (by id) with another disease:
+	 * disease characteristics, immunity and seeding as a build with this configuration, but
+	 * without survey participants. For the course of a further pathogen in a population.
+	 */
+	static std::vector<Health> DrawHealth(
+	        const boost::property_tree::ptree& pt_config,
+	        const boost::property_tree::ptree& pt_disease,
+	        std::size_t num_persons,
 	        util::Random& rng);
 
-private:
 	/// Get distribution associateed with tag values.
 	static std::vector<double> GetDistribution(const boost::property_tree::ptree& pt_root, const std::string& xml_tag);
 
-	/// Sample from the distribution.
-	static unsigned int Sample(util::Random& rng, const std::vector<double>& distribution);
+	/// Draw a uniformly random subset of k out of {0, ..., n - 1}, without replacement and
+	/// with a number of random draws that depends on n and k only. Returns membership flags.
+	static std::vector<bool> DrawSubset(util::Random& rng, std::size_t n, std::size_t k);
+
+private:
+	/// Initializes a Population with the persons that add_persons adds.
+	static std::shared_ptr<Population> Build(
+	        const boost::property_tree::ptree& pt_config,
+	        const std::function<void(Population&)>& add_persons,
+	        util::Random& rng,
+	        std::shared_ptr<const util::Storage> storage);
+
+	/// Parse the persons in the buffer (in parallel) and sample their disease characteristics.
+	static void AddPersons(Population& population, const util::InputBuffer& pop_buffer,
+	        const boost::property_tree::ptree& pt_disease, util::Random& rng);
+
+	/// Add the persons of the records and sample their disease characteristics.
+	static void AddRecords(Population& population, const RecordSource& records,
+	        const boost::property_tree::ptree& pt_disease, util::Random& rng);
+
+	/// Draw the survey participants (when logging contacts), the immune persons and the
+	/// infected persons, over the persons in the order of the population file.
+	static void InitializeHealth(const boost::property_tree::ptree& pt_config,
+	        Population& population, util::Random& rng);
+
+	/// Draw the immune and the infected persons, over the health of the persons in the
+	/// order of the population file, and set their health. These are exact numbers of persons
+	/// (the rates times the population size), drawn without replacement by DrawSubset from
+	/// the one random stream: serial, but with one draw per selected person. Independent
+	/// draws per person on split streams, as for the disease characteristics, would give
+	/// only the expected numbers.
+	static void DrawImmunityAndSeeding(const boost::property_tree::ptree& pt_config,
+	        const std::vector<Health*>& health, util::Random& rng);
+
+	/// Number of random draws used for the disease characteristics of a person.
+	static constexpr unsigned int NumDrawsPerPerson() { return 4U; }
+
 };
 
 } // end_of_namespace
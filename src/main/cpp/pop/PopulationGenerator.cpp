@@ -0,0 +1,360 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Implementation of the PopulationGenerator class.
+ */
+
+#include "PopulationGenerator.h"
+
+#include "pop/CityReader.h"
+#include "util/Fingerprint.h"
+#include "util/Random.h"
+#include "util/StringUtils.h"
+
+#include <omp.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace stride {
+
+using namespace std;
+using namespace stride::util;
+
+namespace {
+
+/// The counts in the last column of a reference file, at the value of the given column minus the offset.
+vector<double> ReadCounts(const string& file_name, size_t column, unsigned int offset)
+{
+        vector<double> counts;
+        for (const auto& fields : CityReader::ReadTable(file_name)) {
+                if (fields.size() <= column) {
+                        throw runtime_error(string(__func__) + "> Bad line in " + file_name);
+                }
+                const auto key = StringUtils::FromString<unsigned int>(fields[column]);
+                if (key < offset) {
+                        throw runtime_error(string(__func__) + "> Bad line in " + file_name);
+                }
+                counts.resize(max<size_t>(counts.size(), key - offset + 1U), 0.0);
+                counts[key - offset] = StringUtils::FromString<double>(fields.back());
+        }
+        if (counts.empty()) {
+                throw runtime_error(string(__func__) + "> No counts in " + file_name);
+        }
+        return counts;
+}
+
+/// Table for the ages first to last (or the last one in the counts) by their counts.
+AliasTable AgeTable(const vector<double>& counts, unsigned int first, unsigned int last)
+{
+        if (first >= counts.size()) {
+                throw runtime_error(string(__func__) + "> No persons of age " + to_string(first) + " or older.");
+        }
+        const auto end = counts.begin() + min<size_t>(last + 1U, counts.size());
+        return AliasTable(vector<double>(counts.begin() + first, end));
+}
+
+/// Table of the household sizes (minus one), from the persons by household size.
+AliasTable HouseholdTable(const vector<double>& counts)
+{
+        vector<double> households;
+        for (size_t i = 0; i < counts.size(); i++) {
+                households.push_back(counts[i] / (i + 1U));
+        }
+        return AliasTable(households);
+}
+
+/// Append an unsigned number to the string.
+inline void Append(string& s, unsigned int value)
+{
+        char digits[10];
+        unsigned int n = 0U;
+        do {
+                digits[n++] = static_cast<char>('0' + value % 10U);
+                value /= 10U;
+        } while (value > 0U);
+        while (n > 0U) {
+                s += digits[--n];
+        }
+}
+
+}
+
+PopulationGenerator::PopulationGenerator(const string& regions_file, const string& commuting_file,
+        const string& household_file, const string& age_file)
+        : m_household_counts(ReadCounts(household_file, 1U, 1U)), m_age_counts(ReadCounts(age_file, 0U, 0U)),
+          m_household_size(HouseholdTable(m_household_counts)), m_adult_age(AgeTable(m_age_counts, 18U, 1000U)),
+          m_parent_age(AgeTable(m_age_counts, 20U, 59U)), m_child_age(AgeTable(m_age_counts, 0U, 17U)),
+          m_child_rate(1.0)
+{
+        // Cities, their share of the population and where their workers work: the remainder
+        // of the proportions at home.
+        m_cities = CityReader::Read(regions_file, commuting_file);
+        for (const auto& city : m_cities) {
+                vector<double> proportions;
+                double total = 0.0;
+                for (const auto& d : city.destinations) {
+                        proportions.push_back(d.second);
+                        total += max(d.second, 0.0);
+                }
+                proportions.push_back(max(1.0 - total, 0.0));
+                m_destination.push_back((total > 0.0) ? AliasTable(proportions) : AliasTable({ 1.0 }));
+        }
+
+        // Further household members are children as often as gives the share of children in
+        // the population (with all of them children, there would be too many).
+        double persons = 0.0;
+        double children_if_all = 0.0;
+        for (size_t i = 0; i < m_household_counts.size(); i++) {
+                persons += m_household_counts[i];
+                children_if_all += (i >= 2U) ? m_household_counts[i] * (i - 1U) / (i + 1U) : 0.0;
+        }
+        double children = 0.0;
+        double everyone = 0.0;
+        for (size_t a = 0; a < m_age_counts.size(); a++) {
+                children += (a < 18U) ? m_age_counts[a] : 0.0;
+                everyone += m_age_counts[a];
+        }
+        if (children_if_all > 0.0) {
+                m_child_rate = min(1.0, (children / everyone) / (children_if_all / persons));
+        }
+}
+
+void PopulationGenerator::Write(ostream& os, size_t num_persons, unsigned long seed, unsigned int num_threads) const
+{
+        num_threads = max(num_threads, 1U);
+
+        // Each batch of records in chunks, written in parallel and then to the stream.
+        os << "\"age\",\"household_id\",\"school_id\",\"work_id\",\"primary_community\",\"secondary_community\"\n";
+        Generate(num_persons, seed, [&](const vector<PopulationBuilder::Record>& records) {
+                vector<string> texts(4U * num_threads);
+                #pragma omp parallel for num_threads(num_threads) schedule(dynamic)
+                for (size_t i = 0; i < texts.size(); i++) {
+                        const size_t first = records.size() * i / texts.size();
+                        const size_t last  = records.size() * (i + 1U) / texts.size();
+                        texts[i].reserve((last - first) * 24U);
+                        for (size_t r = first; r < last; r++) {
+                                Append(texts[i], records[r][0]);
+                                for (size_t t = 1; t < records[r].size(); t++) {
+                                        texts[i] += ',';
+                                        Append(texts[i], records[r][t]);
+                                }
+                                texts[i] += '\n';
+                        }
+                }
+                for (const auto& text : texts) {
+                        os.write(text.data(), static_cast<streamsize>(text.size()));
+                }
+        }, num_threads);
+}
+
+void PopulationGenerator::Generate(size_t num_persons, unsigned long seed, const PopulationBuilder::RecordSink& sink,
+        unsigned int num_threads) const
+{
+        num_threads = max(num_threads, 1U);
+        const size_t n = m_cities.size();
+        const Plan plan = MakePlan(num_persons);
+
+        // The cities in batches: generated in parallel, numbered on and handed to the sink,
+        // so that the batch rather than the population is in memory.
+        unsigned int offsets[5] = { 0U, 0U, 0U, 0U, 0U };
+        const size_t batch_size = 4U * num_threads;
+        vector<PopulationBuilder::Record> records;
+        for (size_t begin = 0; begin < n; begin += batch_size) {
+                const size_t end = min(n, begin + batch_size);
+                vector<City> cities(end - begin);
+                vector<array<unsigned int, 5>> city_offsets(end - begin);
+                vector<size_t> first_record(end - begin + 1U, 0U);
+                #pragma omp parallel num_threads(num_threads)
+                {
+                        #pragma omp for schedule(dynamic)
+                        for (size_t c = begin; c < end; c++) {
+                                cities[c - begin] = GenerateCity(c, plan.num_persons[c], seed, plan);
+                        }
+                        #pragma omp single
+                        {
+                                for (size_t i = 0; i < cities.size(); i++) {
+                                        for (size_t t = 0; t < 5U; t++) {
+                                                city_offsets[i][t] = offsets[t];
+                                                offsets[t] += cities[i].num_ids[t];
+                                        }
+                                        first_record[i + 1U] = first_record[i] + cities[i].rows.size();
+                                }
+                                records.resize(first_record.back());
+                        }
+                        #pragma omp for schedule(dynamic)
+                        for (size_t i = 0; i < cities.size(); i++) {
+                                size_t r = first_record[i];
+                                for (const auto& row : cities[i].rows) {
+                                        records[r][0] = row.age;
+                                        for (size_t t = 0; t < 5U; t++) {
+                                                const unsigned int offset = (t == 2U)
+                                                        ? plan.first_workplace[row.work_city] - 1U : city_offsets[i][t];
+                                                records[r][t + 1U] = row.ids[t] > 0U ? row.ids[t] + offset : 0U;
+                                        }
+                                        ++r;
+                                }
+                                vector<Row>().swap(cities[i].rows);
+                        }
+                }
+                sink(records);
+        }
+}
+
+vector<vector<PopulationGenerator::Row>> PopulationGenerator::GenerateCities(size_t num_persons,
+        unsigned long seed, unsigned int num_threads) const
+{
+        const Plan plan = MakePlan(num_persons);
+        vector<vector<Row>> rows(m_cities.size());
+        #pragma omp parallel for num_threads(max(num_threads, 1U)) schedule(dynamic)
+        for (size_t c = 0; c < m_cities.size(); c++) {
+                rows[c] = move(GenerateCity(c, plan.num_persons[c], seed, plan).rows);
+        }
+        return rows;
+}
+
+PopulationGenerator::Plan PopulationGenerator::MakePlan(size_t num_persons) const
+{
+        const size_t n = m_cities.size();
+        Plan plan;
+
+        // The persons of each city: the rounded cumulative shares, so that they add up.
+        double total_share = 0.0;
+        for (const auto& city : m_cities) {
+                total_share += city.share;
+        }
+        plan.num_persons.resize(n);
+        double cumulative = 0.0;
+        size_t previous = 0U;
+        for (size_t c = 0; c < n; c++) {
+                cumulative += m_cities[c].share;
+                const size_t upto = (c + 1U == n) ? num_persons
+                        : min(num_persons, static_cast<size_t>(llround(num_persons * cumulative / total_share)));
+                plan.num_persons[c] = upto - min(upto, previous);
+                previous = max(previous, upto);
+        }
+
+        // The workplaces of each city, for the workers that are expected to work there.
+        double working_age = 0.0;
+        double everyone = 0.0;
+        for (size_t a = 0; a < m_age_counts.size(); a++) {
+                working_age += (a >= m_parameters.min_work_age && a <= m_parameters.max_work_age) ? m_age_counts[a] : 0.0;
+                everyone += m_age_counts[a];
+        }
+        const double worker_rate = m_parameters.employment_rate * working_age / everyone;
+        vector<double> workers(n, 0.0);
+        for (size_t c = 0; c < n; c++) {
+                double commuting = 0.0;
+                for (const auto& d : m_cities[c].destinations) {
+                        workers[d.first] += plan.num_persons[c] * worker_rate * max(d.second, 0.0);
+                        commuting += max(d.second, 0.0);
+                }
+                workers[c] += plan.num_persons[c] * worker_rate * max(1.0 - commuting, 0.0);
+        }
+        unsigned int next_workplace = 1U;
+        for (size_t c = 0; c < n; c++) {
+                plan.num_workplaces.push_back(max(1U, static_cast<unsigned int>(lround(workers[c] / m_parameters.work_size))));
+                plan.first_workplace.push_back(next_workplace);
+                next_workplace += plan.num_workplaces.back();
+        }
+        return plan;
+}
+
+PopulationGenerator::City PopulationGenerator::GenerateCity(size_t c, size_t num_persons, unsigned long seed,
+        const Plan& plan) const
+{
+        const unsigned long key[2] = { seed, c };
+        Random rng(Fingerprint::Hash(key, sizeof(key)));
+        const CityReader::City& reference = m_cities[c];
+        const Parameters& p = m_parameters;
+        const unsigned int max_age = 18U + static_cast<unsigned int>(m_adult_age.size()) - 1U;
+
+        // Households, with their primary community (the next one once a community is full)
+        // and their secondary community (any one in the city).
+        City city;
+        city.rows.reserve(num_persons);
+        const auto num_secondary = max(1U, static_cast<unsigned int>(lround(num_persons / p.secondary_size)));
+        unsigned int num_households = 0U;
+        unsigned int num_primary = 0U;
+        size_t primary_persons = 0U;
+        while (city.rows.size() < num_persons) {
+                const size_t size = min<size_t>(m_household_size.Sample(rng.NextDouble()) + 1U,
+                        num_persons - city.rows.size());
+                ++num_households;
+                if (num_primary == 0U || primary_persons >= p.primary_size) {
+                        ++num_primary;
+                        primary_persons = 0U;
+                }
+                primary_persons += size;
+                const unsigned int secondary = 1U + rng(num_secondary);
+
+                // The reference adult (of an age to have children, when there are more than two
+                // persons), a partner of about the same age and the further members.
+                const unsigned int adult = (size < 3U) ? 18U + m_adult_age.Sample(rng.NextDouble())
+                        : 20U + m_parent_age.Sample(rng.NextDouble());
+                for (size_t i = 0; i < size; i++) {
+                        unsigned int age = adult;
+                        if (i == 1U) {
+                                const int partner = static_cast<int>(adult + rng(11U)) - 5;
+                                age = static_cast<unsigned int>(min(max(partner, 18), static_cast<int>(max_age)));
+                        } else if (i > 1U) {
+                                if (rng.NextDouble() < m_child_rate) {
+                                        do {
+                                                age = m_child_age.Sample(rng.NextDouble());
+                                        } while (age + 16U > adult);
+                                } else {
+                                        age = 18U + m_adult_age.Sample(rng.NextDouble());
+                                }
+                        }
+                        city.rows.push_back(Row { age, { num_households, 0U, 0U, num_primary, secondary }, static_cast<unsigned int>(c) });
+                }
+        }
+
+        // Schools, for the pupils of the city.
+        size_t num_pupils = 0U;
+        for (const auto& row : city.rows) {
+                num_pupils += (row.age >= p.min_school_age && row.age <= p.max_school_age);
+        }
+        const auto num_schools = (num_pupils > 0U)
+                ? max(1U, static_cast<unsigned int>(lround(num_pupils / p.school_size))) : 0U;
+
+        // Pupils and workers, to a workplace at home or at their destination.
+        for (auto& row : city.rows) {
+                if (row.age >= p.min_school_age && row.age <= p.max_school_age) {
+                        row.ids[1] = 1U + rng(num_schools);
+                } else if (row.age >= p.min_work_age && row.age <= p.max_work_age
+                        && rng.NextDouble() < p.employment_rate) {
+                        const auto d = m_destination[c].Sample(rng.NextDouble());
+                        const size_t w = (d < reference.destinations.size()) ? reference.destinations[d].first : c;
+                        row.ids[2]    = 1U + rng(plan.num_workplaces[w]);
+                        row.work_city = static_cast<unsigned int>(w);
+                }
+        }
+
+        city.num_ids[0] = num_households;
+        city.num_ids[1] = num_schools;
+        city.num_ids[2] = 0U;
+        city.num_ids[3] = num_primary;
+        city.num_ids[4] = num_secondary;
+        return city;
+}
+
+} // end_of_namespace
@@ -0,0 +1,147 @@
+#ifndef POPULATION_GENERATOR_H_INCLUDED
+#define POPULATION_GENERATOR_H_INCLUDED
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Header for the PopulationGenerator class.
+ */
+
+#include "pop/CityReader.h"
+#include "pop/PopulationBuilder.h"
+#include "util/AliasTable.h"
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace stride {
+
+/**
+ * Synthetic population in the format of the population files, of any size, from the
+ * reference data in the data directory: the cities with their share of the population
+ * (belgium_population.csv), the commuting between them (belgium_commuting.csv), the
+ * persons by household size (ref_2011_BE_hh_size.csv) and by age (ref_2011_BE_demo_pjan.csv).
+ *
+ * Every city gets its share of the persons, in whole households. A household has a
+ * reference adult, for two or more persons a partner of about the same age and for more
+ * the other members: children of the reference adult, or adults, in the proportion that
+ * gives the reference share of persons under 18. Persons of school age go to one of the
+ * schools of their city, employed persons of working age to a workplace in their city or,
+ * with the commuting proportions, in another. Households as a whole belong to a primary
+ * community (neighbouring households) and a secondary community (any in the city).
+ *
+ * The cities are generated independently, in parallel, each from its own random stream
+ * derived from the seed: the population only depends on the size and the seed.
+ */
+class PopulationGenerator
+{
+public:
+	/// A generated person: age, the ids of household, school, work, primary and secondary
+	/// community (0 for none), each from 1 in the city of the cluster, and the city of work.
+	struct Row
+	{
+		unsigned int   age;
+		unsigned int   ids[5];
+		unsigned int   work_city;
+	};
+
+	/// Sizes and rates of the generated clusters.
+	struct Parameters
+	{
+		unsigned int   min_school_age     = 3U;       ///< Youngest age at school.
+		unsigned int   max_school_age     = 17U;      ///< Oldest age at school.
+		unsigned int   min_work_age       = 18U;      ///< Youngest age at work.
+		unsigned int   max_work_age       = 64U;      ///< Oldest age at work.
+		double         employment_rate    = 0.7;      ///< Share of the persons of working age that work.
+		double         school_size        = 80.0;     ///< Mean number of pupils of a school.
+		double         work_size          = 8.0;      ///< Mean number of workers of a workplace.
+		double         primary_size       = 1500.0;   ///< Number of persons of a primary community.
+		double         secondary_size     = 1000.0;   ///< Mean number of persons of a secondary community.
+	};
+
+	/// Reference data from the given files in the data directory.
+	PopulationGenerator(const std::string& regions_file = "belgium_population.csv",
+	        const std::string& commuting_file = "belgium_commuting.csv",
+	        const std::string& household_file = "ref_2011_BE_hh_size.csv",
+	        const std::string& age_file = "ref_2011_BE_demo_pjan.csv");
+
+	/// Number of cities.
+	std::size_t GetNumCities() const { return m_cities.size(); }
+
+	/// The cities, in the order of the regions file.
+	const std::vector<CityReader::City>& GetCities() const { return m_cities; }
+
+	/// Sizes and rates of the generated clusters.
+	const Parameters& GetParameters() const { return m_parameters; }
+
+	/// Set the sizes and rates of the generated clusters.
+	void SetParameters(const Parameters& parameters) { m_parameters = parameters; }
+
+	/// Write a population of the given number of persons, with the header of the population
+	/// files, generating (a batch of) cities in parallel on the given number of threads.
+	void Write(std::ostream& os, std::size_t num_persons, unsigned long seed, unsigned int num_threads = 1U) const;
+
+	/// Hand the records of the persons that Write writes to the sink, a batch of cities at a
+	/// time, so that no more than a batch is in memory.
+	void Generate(std::size_t num_persons, unsigned long seed, const PopulationBuilder::RecordSink& sink,
+	        unsigned int num_threads = 1U) const;
+
+	/// The persons of every city of the population that Write writes, generated in parallel
+	/// on the given number of threads, with the ids of their cities instead of the population.
+	std::vector<std::vector<Row>> GenerateCities(std::size_t num_persons, unsigned long seed,
+	        unsigned int num_threads = 1U) const;
+
+private:
+	/// The persons of a city, with household, school and community ids from 1 in the city.
+	struct City
+	{
+		std::vector<Row>   rows;         ///< The persons, household by household.
+		unsigned int       num_ids[5];   ///< Largest id of each cluster type (but work).
+	};
+
+	/// Persons and workplaces of each city, for a population of a given size.
+	struct Plan
+	{
+		std::vector<std::size_t>    num_persons;       ///< Persons of each city.
+		std::vector<unsigned int>   num_workplaces;    ///< Workplaces of each city.
+		std::vector<unsigned int>   first_workplace;   ///< Id of the first workplace of each city in the population.
+	};
+
+	/// The persons and workplaces of each city for a population of the given number of persons.
+	Plan MakePlan(std::size_t num_persons) const;
+
+	/// Generate a city of the given number of persons, with the workplaces of the plan.
+	City GenerateCity(std::size_t city, std::size_t num_persons, unsigned long seed, const Plan& plan) const;
+
+private:
+	Parameters                      m_parameters;         ///< Sizes and rates.
+	std::vector<CityReader::City>   m_cities;             ///< The cities.
+	std::vector<util::AliasTable>   m_destination;        ///< Per city: index in its destinations, or their number for home.
+	std::vector<double>             m_household_counts;   ///< Persons by household size minus one.
+	std::vector<double>             m_age_counts;         ///< Persons by age.
+	util::AliasTable                m_household_size;     ///< Household size minus one.
+	util::AliasTable                m_adult_age;          ///< Age minus 18 of an adult.
+	util::AliasTable                m_parent_age;         ///< Age minus 20 of a reference adult with children (20 to 59).
+	util::AliasTable                m_child_age;          ///< Age of a child (0 to 17).
+	double                          m_child_rate;         ///< Chance that a further household member is a child.
+};
+
+} // end_of_namespace
+
+#endif // end-of-include-guard
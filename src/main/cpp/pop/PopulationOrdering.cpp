@@ -0,0 +1,198 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Implementation of the PopulationOrdering class.
+ */
+
+#include "PopulationOrdering.h"
+
+#include "core/ClusterType.h"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+namespace stride {
+
+using namespace std;
+using boost::property_tree::ptree;
+
+namespace {
+
+/// Compressed adjacency lists: the neighbours of node i are targets[offsets[i]], ..., targets[offsets[i + 1] - 1].
+struct Adjacency
+{
+        vector<size_t> offsets;
+        vector<size_t> targets;
+};
+
+/// Adjacency lists from (node, target) pairs, keeping the order of the pairs per node.
+Adjacency MakeAdjacency(size_t num_nodes, const vector<pair<size_t, size_t>>& edges)
+{
+        Adjacency adj;
+        adj.offsets.assign(num_nodes + 1, 0U);
+        for (const auto& e : edges) {
+                adj.offsets[e.first + 1]++;
+        }
+        partial_sum(adj.offsets.begin(), adj.offsets.end(), adj.offsets.begin());
+        adj.targets.resize(edges.size());
+        vector<size_t> fill(adj.offsets.begin(), adj.offsets.end() - 1);
+        for (const auto& e : edges) {
+                adj.targets[fill[e.first]++] = e.second;
+        }
+        return adj;
+}
+
+/// Dense index (in increasing id order) for the non-zero ids of the cluster type; zero ids get num_ids.
+vector<size_t> DenseIndex(const Population& population, ClusterType type, size_t& num_ids)
+{
+        vector<unsigned int> ids;
+        ids.reserve(population.size());
+        for (const auto& p : population) {
+                ids.push_back(p.GetClusterId(type));
+        }
+        sort(ids.begin(), ids.end());
+        ids.erase(unique(ids.begin(), ids.end()), ids.end());
+        ids.erase(remove(ids.begin(), ids.end(), 0U), ids.end());
+        num_ids = ids.size();
+
+        vector<size_t> index(population.size());
+        for (size_t i = 0; i < population.size(); i++) {
+                const auto id = population[i].GetClusterId(type);
+                index[i] = (id == 0U) ? num_ids : lower_bound(ids.begin(), ids.end(), id) - ids.begin();
+        }
+        return index;
+}
+
+}
+
+void PopulationOrdering::Apply(const ptree& pt_config, Population& population)
+{
+        const auto person_order = pt_config.get<string>("run.person_order", "file");
+        if (person_order == "locality") {
+                Permute(population, Locality(population));
+        } else if (person_order != "file") {
+                throw runtime_error(string(__func__) + "> Invalid input for person_order: " + person_order);
+        }
+}
+
+vector<size_t> PopulationOrdering::Locality(const Population& population)
+{
+        const size_t n = population.size();
+
+        // Households; persons without one form a household on their own.
+        size_t num_households = 0U;
+        auto household = DenseIndex(population, ClusterType::Household, num_households);
+        for (size_t i = 0; i < n; i++) {
+                if (household[i] == num_households) {
+                        household[i] = num_households + i;
+                }
+        }
+        num_households += n;
+
+        // Schools and workplaces as one set of nodes: schools first, then workplaces.
+        size_t num_schools = 0U;
+        size_t num_works   = 0U;
+        const auto school  = DenseIndex(population, ClusterType::School, num_schools);
+        const auto work    = DenseIndex(population, ClusterType::Work, num_works);
+
+        vector<pair<size_t, size_t>> household_persons;
+        vector<pair<size_t, size_t>> household_nodes;
+        vector<pair<size_t, size_t>> node_households;
+        household_persons.reserve(n);
+        for (size_t i = 0; i < n; i++) {
+                household_persons.emplace_back(household[i], i);
+                if (school[i] < num_schools) {
+                        household_nodes.emplace_back(household[i], school[i]);
+                        node_households.emplace_back(school[i], household[i]);
+                }
+                if (work[i] < num_works) {
+                        household_nodes.emplace_back(household[i], num_schools + work[i]);
+                        node_households.emplace_back(num_schools + work[i], household[i]);
+                }
+        }
+        const auto members        = MakeAdjacency(num_households, household_persons);
+        const auto hh_to_nodes    = MakeAdjacency(num_households, household_nodes);
+        const auto node_to_hh     = MakeAdjacency(num_schools + num_works, node_households);
+
+        // Primary communities are the largest clusters and they are (mostly) made up of whole
+        // households: keep them contiguous by ordering households per community first.
+        size_t num_communities = 0U;
+        const auto primary = DenseIndex(population, ClusterType::PrimaryCommunity, num_communities);
+        vector<size_t> community(num_households, num_communities);
+        for (size_t i = n; i-- > 0; ) {
+                community[household[i]] = primary[i];
+        }
+        vector<size_t> starts(num_households);
+        iota(starts.begin(), starts.end(), 0U);
+        stable_sort(starts.begin(), starts.end(),
+                [&community](size_t a, size_t b) { return community[a] < community[b]; });
+
+        // Breadth first over the households of a community, starting from every one not yet reached.
+        vector<size_t> order;
+        order.reserve(n);
+        vector<bool> hh_done(num_households, false);
+        vector<size_t> node_stamp(num_schools + num_works, num_communities + 1);
+        vector<size_t> queue;
+        queue.reserve(num_households);
+        for (const size_t start : starts) {
+                if (hh_done[start] || members.offsets[start] == members.offsets[start + 1]) {
+                        continue;
+                }
+                const size_t c = community[start];
+                hh_done[start] = true;
+                queue.assign(1U, start);
+                for (size_t head = 0; head < queue.size(); head++) {
+                        const size_t hh = queue[head];
+                        for (size_t k = members.offsets[hh]; k < members.offsets[hh + 1]; k++) {
+                                order.push_back(members.targets[k]);
+                        }
+                        for (size_t k = hh_to_nodes.offsets[hh]; k < hh_to_nodes.offsets[hh + 1]; k++) {
+                                const size_t node = hh_to_nodes.targets[k];
+                                if (node_stamp[node] == c) {
+                                        continue;
+                                }
+                                node_stamp[node] = c;
+                                for (size_t l = node_to_hh.offsets[node]; l < node_to_hh.offsets[node + 1]; l++) {
+                                        const size_t next = node_to_hh.targets[l];
+                                        if ( !hh_done[next] && community[next] == c ) {
+                                                hh_done[next] = true;
+                                                queue.push_back(next);
+                                        }
+                                }
+                        }
+                }
+        }
+        return order;
+}
+
+void PopulationOrdering::Permute(Population& population, const vector<size_t>& order)
+{
+        if (order.size() != population.size()) {
+                throw runtime_error(string(__func__) + "> Order does not match the population size.");
+        }
+        Population permuted;
+        permuted.resize(population.size());
+        #pragma omp parallel for schedule(static)
+        for (size_t i = 0; i < order.size(); i++) {
+                permuted[i] = population[order[i]];
+        }
+        population.swap(permuted);
+}
+
+} // end_of_namespace
@@ -0,0 +1,59 @@
+#ifndef POPULATION_ORDERING_H_INCLUDED
+#define POPULATION_ORDERING_H_INCLUDED
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Header for the PopulationOrdering class.
+ */
+
+#include "Population.h"
+
+#include <boost/property_tree/ptree.hpp>
+#include <cstddef>
+#include <vector>
+
+namespace stride {
+
+/**
+ * Orders the persons in the population (before the clusters are built). The cluster
+ * members are visited in population order, so an order that keeps the members of
+ * a cluster close together in memory makes the cluster pass cache friendly.
+ * Person ids are not affected.
+ */
+class PopulationOrdering
+{
+public:
+	/// Order the population as configured in run.person_order: "file" (the default,
+	/// population file order) or "locality" (see Locality).
+	static void Apply(const boost::property_tree::ptree& pt_config, Population& population);
+
+	/**
+	 * Locality order: household members are contiguous, households are grouped by primary
+	 * community and within a community households that share a school or workplace are close
+	 * together. Per community, households are visited breadth first, where a household is
+	 * followed by the (not yet visited) households of its members' schools and workplaces.
+	 * Returns for every position the index of the person that goes there.
+	 */
+	static std::vector<std::size_t> Locality(const Population& population);
+
+	/// Permute the population: position i gets the person at position order[i].
+	static void Permute(Population& population, const std::vector<std::size_t>& order);
+};
+
+} // end_of_namespace
+
+#endif // include guard
@@ -0,0 +1,134 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Main program of the population generator: command line handling.
+ */
+
+#include "pop/PopulationGenerator.h"
+#include "pop/PopulationBuilder.h"
+#include "core/ContactMatrixReader.h"
+#include "sim/SimulatorBuilder.h"
+#include "util/InstallDirs.h"
+
+#include <boost/filesystem.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/xml_parser.hpp>
+#include <omp.h>
+#include <tclap/CmdLine.h>
+
+#include <chrono>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+using namespace stride;
+using namespace stride::util;
+using namespace boost::filesystem;
+using namespace boost::property_tree;
+using namespace TCLAP;
+
+/// Main program of the stride population generator.
+int main(int argc, char** argv)
+{
+	int exit_status = EXIT_SUCCESS;
+	try {
+		// -----------------------------------------------------------------------------------------
+		// Parse command line.
+		// -----------------------------------------------------------------------------------------
+		CmdLine cmd("stride-popgen", ' ', "1.0", false);
+		ValueArg<unsigned long>  size_Arg("n", "size", "Number of persons", true,
+		                                0UL, "SIZE", cmd);
+		ValueArg<unsigned long>  seed_Arg("s", "seed", "Random seed", false,
+		                                1UL, "SEED", cmd);
+		ValueArg<string>  format_Arg("f", "format", "Output format: csv or snapshot", false,
+		                                "csv", "FORMAT", cmd);
+		ValueArg<string>  output_file_Arg("o", "output", "Output File (csv format)", false,
+		                                "pop_synthetic.csv", "OUTPUT FILE", cmd);
+		ValueArg<string>  config_file_Arg("c", "config", "Config File (snapshot format)", false,
+		                                "./config/run_default.xml", "CONFIGURATION FILE", cmd);
+		ValueArg<string>  regions_file_Arg("", "regions", "Cities and their share of the population (in data dir)",
+		                                false, "belgium_population.csv", "REGIONS FILE", cmd);
+		ValueArg<string>  commuting_file_Arg("", "commuting", "Commuting between the cities (in data dir)",
+		                                false, "belgium_commuting.csv", "COMMUTING FILE", cmd);
+		cmd.parse(argc, argv);
+
+		unsigned int num_threads = 1U;
+		#pragma omp parallel
+		{
+			num_threads = omp_get_num_threads();
+		}
+		const auto start = chrono::steady_clock::now();
+		const PopulationGenerator generator(regions_file_Arg.getValue(), commuting_file_Arg.getValue());
+
+		if (format_Arg.getValue() == "csv") {
+			// -----------------------------------------------------------------------------------------
+			// Population file.
+			// -----------------------------------------------------------------------------------------
+			std::ofstream file(output_file_Arg.getValue());
+			if ( !file ) {
+				throw runtime_error(string(__func__) + "> Cannot write " + output_file_Arg.getValue());
+			}
+			generator.Write(file, size_Arg.getValue(), seed_Arg.getValue(), num_threads);
+			cout << "Population file:  " << output_file_Arg.getValue() << endl;
+		} else if (format_Arg.getValue() == "snapshot") {
+			// -----------------------------------------------------------------------------------------
+			// Snapshot of the simulator of the config, on the generated population: runs with the
+			// config and the synthetic population file of the size and seed (which does not exist)
+			// load it as if they had built it from that file.
+			// -----------------------------------------------------------------------------------------
+			ptree pt_config;
+			read_xml(canonical(system_complete(config_file_Arg.getValue())).string(), pt_config);
+			if (pt_config.get_optional<bool>("run.num_participants_survey") == false) {
+				pt_config.put("run.num_participants_survey", 1);
+			}
+			const auto population_name = "pop_synthetic_" + to_string(size_Arg.getValue()) + "_"
+				+ to_string(seed_Arg.getValue()) + ".csv";
+			pt_config.put("run.population_file", population_name);
+			const auto population_file = InstallDirs::GetDataDir() / population_name;
+			if (exists(population_file)) {
+				throw runtime_error(string(__func__) + "> Population file " + population_file.string()
+					+ " exists: runs would not take the snapshot for it.");
+			}
+			ptree pt_disease;
+			read_xml((InstallDirs::GetDataDir() / pt_config.get<string>("run.disease_config_file")).string(), pt_disease);
+
+			const auto path = SimulatorBuilder::Snapshot(pt_config, pt_disease, ContactMatrixReader::Read(pt_config),
+				[&](const PopulationBuilder::RecordSink& sink) {
+					generator.Generate(size_Arg.getValue(), seed_Arg.getValue(), sink, num_threads);
+				}, num_threads);
+			cout << "Snapshot file:    " << path.string() << endl;
+			cout << "Population file:  " << population_name << " (run.population_file of the runs)" << endl;
+		} else {
+			throw runtime_error(string(__func__) + "> Unknown format " + format_Arg.getValue());
+		}
+		cout << "Persons:          " << size_Arg.getValue() << " in " << generator.GetNumCities() << " cities" << endl;
+		cout << "Time:             " << chrono::duration_cast<chrono::milliseconds>(
+			chrono::steady_clock::now() - start).count() << " ms" << endl;
+	}
+	catch (exception& e) {
+		exit_status = EXIT_FAILURE;
+		cerr << "\nEXCEPION THROWN: " << e.what() << endl;
+	}
+	catch (...) {
+		exit_status = EXIT_FAILURE;
+		cerr << "\nEXCEPION THROWN: " << "Unknown exception." << endl;
+	}
+	return exit_status;
+}
@@ -0,0 +1,141 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Implementation of the ActiveClusters class.
+ */
+#include "ActiveClusters.h"
+
+#include <algorithm>
+
+namespace stride {
+
+using namespace std;
+
+void ActiveClusters::Initialize(const Population& population, const Clusters& clusters)
+{
+        array<uint32_t, NumOfClusterTypes()> none;
+        none.fill(NoCluster());
+        m_clusters.assign(population.size(), none);
+        m_num_clusters = 0U;
+        const Person* first = population.data();
+        for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+                const vector<Cluster>& type_clusters = *clusters[t];
+                for (size_t c = 0; c < type_clusters.size(); c++) {
+                        for (size_t i = 0; i < type_clusters[c].GetSize(); i++) {
+                                m_clusters[type_clusters[c].GetMember(i) - first][t] = static_cast<uint32_t>(c);
+                        }
+                }
+                m_num_clusters += type_clusters.size();
+                m_marked[t].clear();
+                m_is_marked[t].assign(type_clusters.size(), 0U);
+        }
+        MarkAll();
+}
+
+size_t ActiveClusters::CountClusters(const vector<uint32_t>& persons)
+{
+        size_t count = 0U;
+        vector<uint32_t> counted;
+        for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+                // The flags of the marked clusters are set again when done.
+                for (const auto p : persons) {
+                        const uint32_t c = m_clusters[p][t];
+                        if (c != NoCluster() && m_is_marked[t][c] != 2U) {
+                                counted.push_back(c);
+                                m_is_marked[t][c] = 2U;
+                        }
+                }
+                for (const auto c : counted) {
+                        m_is_marked[t][c] = 0U;
+                }
+                for (const auto c : m_marked[t]) {
+                        m_is_marked[t][c] = 1U;
+                }
+                count += counted.size();
+                counted.clear();
+        }
+        return count;
+}
+
+void ActiveClusters::Mark(size_t type, uint32_t cluster)
+{
+        if ( !m_is_marked[type][cluster] ) {
+                m_is_marked[type][cluster] = 1U;
+                m_marked[type].push_back(cluster);
+        }
+}
+
+void ActiveClusters::MarkPerson(uint32_t person)
+{
+        for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+                if (m_clusters[person][t] != NoCluster()) {
+                        Mark(t, m_clusters[person][t]);
+                }
+        }
+}
+
+void ActiveClusters::MarkAll()
+{
+        for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+                m_marked[t].resize(m_is_marked[t].size());
+                for (size_t c = 0; c < m_marked[t].size(); c++) {
+                        m_marked[t][c] = static_cast<uint32_t>(c);
+                }
+                fill(m_is_marked[t].begin(), m_is_marked[t].end(), 1U);
+        }
+        m_valid = true;
+}
+
+void ActiveClusters::MarkVisited(const Population& population, const Clusters& clusters)
+{
+        for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+                for (const auto c : m_marked[t]) {
+                        m_is_marked[t][c] = 0U;
+                }
+                m_marked[t].clear();
+                const vector<Cluster>& type_clusters = *clusters[t];
+                for (size_t c = 0; c < type_clusters.size(); c++) {
+                        if ( !type_clusters[c].IsSorted() ) {
+                                Mark(t, static_cast<uint32_t>(c));
+                        }
+                }
+        }
+        for (size_t i = 0; i < population.size(); i++) {
+                if (population[i].GetHealth().IsNewlyInfected()) {
+                        MarkPerson(static_cast<uint32_t>(i));
+                }
+        }
+        m_valid = true;
+}
+
+const vector<uint32_t>& ActiveClusters::Take(size_t type, const vector<uint32_t>& persons)
+{
+        for (const auto p : persons) {
+                if (m_clusters[p][type] != NoCluster()) {
+                        Mark(type, m_clusters[p][type]);
+                }
+        }
+        m_visit.swap(m_marked[type]);
+        m_marked[type].clear();
+        for (const auto c : m_visit) {
+                m_is_marked[type][c] = 0U;
+        }
+        sort(m_visit.begin(), m_visit.end());
+        return m_visit;
+}
+
+} // end_of_namespace
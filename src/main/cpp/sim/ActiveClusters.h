@@ -0,0 +1,101 @@
+#ifndef ACTIVE_CLUSTERS_H_INCLUDED
+#define ACTIVE_CLUSTERS_H_INCLUDED
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+
+/**
+ * @file
+ * Header for the ActiveClusters class.
+ */
+
+#include "core/Cluster.h"
+#include "core/ClusterType.h"
+#include "pop/Population.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace stride {
+
+/**
+ * The clusters a sparse cluster pass has to visit, so that it changes the persons and
+ * clusters exactly as a visit of every cluster would. A visit does something in a
+ * cluster with infectious members, and otherwise only sorts the members by health
+ * status. That sort leaves the member order as it is once it has been done on the
+ * current health status of the members, which then only changes for the members
+ * infected since. So the pass visits, besides the clusters of the infectious persons,
+ * the clusters whose last sort changed the member order and those with members
+ * infected since their last visit; these are marked to be visited.
+ */
+class ActiveClusters
+{
+public:
+	/// Cluster containers, in ClusterType order.
+	using Clusters = std::array<const std::vector<Cluster>*, NumOfClusterTypes()>;
+
+	/// Without clusters: to be initialized before use.
+	ActiveClusters() : m_valid(false), m_num_clusters(0U) {}
+
+	/// Index the clusters of every person, and mark all clusters.
+	void Initialize(const Population& population, const Clusters& clusters);
+
+	/// Are the marks those of the persons and clusters as they are? Not so after the
+	/// clusters have been restored or visited otherwise, until marked again.
+	bool IsValid() const { return m_valid; }
+
+	/// The persons and clusters have changed otherwise.
+	void Invalidate() { m_valid = false; }
+
+	/// Total number of clusters.
+	std::size_t GetNumClusters() const { return m_num_clusters; }
+
+	/// Number of clusters with one of the given persons (by position in the population) as member.
+	std::size_t CountClusters(const std::vector<std::uint32_t>& persons);
+
+	/// Mark a cluster of the given type, to be visited by the next pass over that type.
+	void Mark(std::size_t type, std::uint32_t cluster);
+
+	/// Mark the clusters of a person (by position in the population).
+	void MarkPerson(std::uint32_t person);
+
+	/// Mark all clusters.
+	void MarkAll();
+
+	/// Mark the clusters to visit after a pass that visited every cluster: those whose
+	/// member order changed and those of the persons infected today.
+	void MarkVisited(const Population& population, const Clusters& clusters);
+
+	/// The clusters of the given type to visit: the marked ones and those with one of
+	/// the given persons as member, in increasing order. The marks of the type are cleared.
+	const std::vector<std::uint32_t>& Take(std::size_t type, const std::vector<std::uint32_t>& persons);
+
+private:
+	/// No cluster of a type.
+	static constexpr std::uint32_t NoCluster() { return 0xFFFFFFFFU; }
+
+	bool                                                               m_valid;
+	std::size_t                                                        m_num_clusters;
+	std::vector<std::array<std::uint32_t, NumOfClusterTypes()>>        m_clusters;     ///< Clusters of each person.
+	std::array<std::vector<std::uint32_t>, NumOfClusterTypes()>        m_marked;       ///< Marked clusters, per type.
+	std::array<std::vector<std::uint8_t>, NumOfClusterTypes()>         m_is_marked;    ///< Flags of the marked clusters.
+	std::vector<std::uint32_t>                                         m_visit;        ///< Clusters to visit.
+};
+
+} // end_of_namespace
+
+#endif // include-guard
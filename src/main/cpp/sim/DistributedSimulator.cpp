@@ -0,0 +1,210 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Implementation of the DistributedSimulator class.
+ */
+
+#include "DistributedSimulator.h"
+
+#include "calendar/Calendar.h"
+#include "calendar/DaysOffInterface.h"
+#include "core/Cluster.h"
+#include "core/Infector.h"
+#include "core/LogMode.h"
+#include "pop/Population.h"
+#include "sim/Simulator.h"
+
+#include <omp.h>
+#ifdef USE_MPI
+#include <mpi.h>
+#endif
+#include <array>
+#include <stdexcept>
+#include <string>
+
+namespace stride {
+
+using namespace std;
+
+DistributedSimulator::DistributedSimulator(shared_ptr<Simulator> sim)
+        : m_sim(sim), m_rank(GetWorldRank()), m_num_ranks(GetWorldSize()), m_infected_count(0U), m_extinct(false)
+{
+        if ( !m_sim || !m_sim->m_population ) {
+                throw runtime_error(string(__func__) + "> Simulator has no population.");
+        }
+        if (m_sim->m_log_level != LogMode::None || m_sim->m_track_index_case) {
+                throw runtime_error(string(__func__) + "> Distributed runs do not log and do not track the index case.");
+        }
+        if ( !m_sim->m_partition.IsEmpty() ) {
+                throw runtime_error(string(__func__) + "> Distributed runs do not partition over threads.");
+        }
+        Simulator& s = *m_sim;
+        const Population& population = *s.m_population;
+        const array<const vector<Cluster>*, NumOfClusterTypes()> clusters { { &s.m_households,
+                &s.m_school_clusters, &s.m_work_clusters, &s.m_primary_community, &s.m_secondary_community } };
+        m_partition = Partition(population, { { clusters[0], clusters[1], clusters[2], clusters[3], clusters[4] } },
+                m_num_ranks);
+
+        // The persons this rank owns or meets in the clusters it owns.
+        const Person* first = population.data();
+        m_is_local.assign(population.size(), 0U);
+        for (const auto i : m_partition.GetPersons(m_rank)) {
+                m_is_local[i] = 1U;
+        }
+        for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+                for (const auto c : m_partition.GetClusters(m_rank, static_cast<ClusterType>(t))) {
+                        const Cluster& cluster = (*clusters[t])[c];
+                        for (size_t i = 0; i < cluster.GetSize(); i++) {
+                                m_is_local[cluster.GetMember(i) - first] = 1U;
+                        }
+                }
+        }
+        for (size_t i = 0; i < population.size(); i++) {
+                if (m_is_local[i]) {
+                        m_local.push_back(static_cast<uint32_t>(i));
+                }
+        }
+
+        // Random streams of this rank's threads, one of the streams of all threads of all ranks.
+        const unsigned int num_streams = m_num_ranks * s.m_num_threads;
+        s.m_rng_handler.clear();
+        for (unsigned int i = 0; i < s.m_num_threads; i++) {
+                s.m_rng_handler.emplace_back(RngHandler(s.m_rng_handler_seed, num_streams, m_rank * s.m_num_threads + i));
+        }
+
+        Reduce();
+}
+
+unsigned int DistributedSimulator::GetWorldRank()
+{
+        int rank = 0;
+#ifdef USE_MPI
+        int initialized = 0;
+        MPI_Initialized(&initialized);
+        if (initialized) {
+                MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        }
+#endif
+        return static_cast<unsigned int>(rank);
+}
+
+unsigned int DistributedSimulator::GetWorldSize()
+{
+        int size = 1;
+#ifdef USE_MPI
+        int initialized = 0;
+        MPI_Initialized(&initialized);
+        if (initialized) {
+                MPI_Comm_size(MPI_COMM_WORLD, &size);
+        }
+#endif
+        return static_cast<unsigned int>(size);
+}
+
+void DistributedSimulator::TimeStep()
+{
+        Simulator& s = *m_sim;
+        Population& population = *s.m_population;
+        if (m_extinct) {
+                s.m_calendar->AdvanceDay();
+                return;
+        }
+
+        const bool is_work_off   = s.m_days_off->IsWorkOff();
+        const bool is_school_off = s.m_days_off->IsSchoolOff();
+        for (const auto i : m_local) {
+                population[i].Update();
+        }
+
+        // The cluster pass over the clusters of this rank.
+        const array<vector<Cluster>*, NumOfClusterTypes()> clusters { { &s.m_households,
+                &s.m_school_clusters, &s.m_work_clusters, &s.m_primary_community, &s.m_secondary_community } };
+        #pragma omp parallel num_threads(s.m_num_threads)
+        {
+                const unsigned int thread = omp_get_thread_num();
+                for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+                        const auto& owned = m_partition.GetClusters(m_rank, static_cast<ClusterType>(t));
+                        vector<Cluster>& type_clusters = *clusters[t];
+                        #pragma omp for schedule(runtime)
+                        for (size_t i = 0; i < owned.size(); i++) {
+                                if (Infector<LogMode::None, false>::Execute(
+                                        type_clusters[owned[i]], s.m_disease_profile, s.m_rng_handler[thread], s.m_calendar,
+                                        is_work_off, is_school_off, nullptr, s.m_mean_field, s.m_age_mixing.get())) {
+                                        #pragma omp atomic
+                                        ++s.m_num_mean_field[t];
+                                }
+                        }
+                }
+        }
+
+        // Exchange: the infections of all ranks, for the persons this rank advances.
+        vector<uint32_t> infected;
+        for (const auto i : m_local) {
+                if (population[i].GetHealth().IsNewlyInfected()) {
+                        infected.push_back(i);
+                }
+        }
+        for (const auto i : Exchange(infected)) {
+                if (m_is_local[i] && population[i].GetHealth().IsSusceptible()) {
+                        population[i].GetHealth().StartInfection();
+                }
+        }
+
+        Reduce();
+        s.m_calendar->AdvanceDay();
+}
+
+vector<uint32_t> DistributedSimulator::Exchange(const vector<uint32_t>& infected) const
+{
+#ifdef USE_MPI
+        if (m_num_ranks > 1U) {
+                int count = static_cast<int>(infected.size());
+                vector<int> counts(m_num_ranks);
+                MPI_Allgather(&count, 1, MPI_INT, counts.data(), 1, MPI_INT, MPI_COMM_WORLD);
+                vector<int> displacements(m_num_ranks, 0);
+                for (unsigned int r = 1; r < m_num_ranks; r++) {
+                        displacements[r] = displacements[r - 1] + counts[r - 1];
+                }
+                vector<uint32_t> all(displacements.back() + counts.back());
+                MPI_Allgatherv(infected.data(), count, MPI_UINT32_T, all.data(), counts.data(),
+                        displacements.data(), MPI_UINT32_T, MPI_COMM_WORLD);
+                return all;
+        }
+#endif
+        return infected;
+}
+
+void DistributedSimulator::Reduce()
+{
+        const Population& population = *m_sim->m_population;
+        unsigned long counts[2] = { 0UL, 0UL };
+        for (const auto i : m_partition.GetPersons(m_rank)) {
+                const auto& health = population[i].GetHealth();
+                counts[0] += health.IsInfected() || health.IsRecovered();
+                counts[1] += health.MayInfect();
+        }
+#ifdef USE_MPI
+        if (m_num_ranks > 1U) {
+                unsigned long local[2] = { counts[0], counts[1] };
+                MPI_Allreduce(local, counts, 2, MPI_UNSIGNED_LONG, MPI_SUM, MPI_COMM_WORLD);
+        }
+#endif
+        m_infected_count = static_cast<unsigned int>(counts[0]);
+        m_extinct        = (counts[1] == 0UL);
+}
+
+} // end_of_namespace
@@ -0,0 +1,96 @@
+#ifndef DISTRIBUTED_SIMULATOR_H_INCLUDED
+#define DISTRIBUTED_SIMULATOR_H_INCLUDED
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Header for the DistributedSimulator class.
+ */
+
+#include "sim/Partition.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace stride {
+
+class Simulator;
+
+/**
+ * Runs a simulator over the processes (ranks) of MPI_COMM_WORLD, when built with MPI
+ * (USE_MPI) and started with mpirun; otherwise as the one rank. Every rank builds the
+ * same simulator; persons and clusters are partitioned over the ranks as over the threads
+ * with run.partitioning "graph" (households as a whole, few cluster memberships cut).
+ * A rank runs the cluster pass on the clusters it owns, with its own random streams, and
+ * advances the disease of the persons it owns or meets in those clusters only.
+ *
+ * The ranks are coupled once a day, after the cluster pass: each rank sends the positions
+ * of the persons it infected that day to all others, and applies those it receives to its
+ * own copy. The daily number of cases and the end of epidemic check come from a reduction
+ * over the persons each rank owns. The outcome depends on the number of ranks, and with
+ * one rank is that of the simulator on its own. Logging and index case tracking are not
+ * supported: the ranks would each log their own share.
+ */
+class DistributedSimulator
+{
+public:
+	/// Take over the simulator (built alike on every rank) and partition it over the ranks.
+	explicit DistributedSimulator(std::shared_ptr<Simulator> sim);
+
+	/// Rank of this process (0 without MPI or when MPI has not been initialized).
+	static unsigned int GetWorldRank();
+
+	/// Number of processes (1 without MPI or when MPI has not been initialized).
+	static unsigned int GetWorldSize();
+
+	/// Partition of persons and clusters over the ranks.
+	const Partition& GetPartition() const { return m_partition; }
+
+	/// Number of persons whose disease this rank advances.
+	std::size_t GetNumLocalPersons() const { return m_local.size(); }
+
+	/// Number of persons that are or were infected, over all ranks, after the last time step.
+	unsigned int GetInfectedCount() const { return m_infected_count; }
+
+	/// Is the epidemic over? True once no one on any rank is or will become infectious.
+	bool IsExtinct() const { return m_extinct; }
+
+	/// Run one time step on every rank (collective: all ranks call it).
+	void TimeStep();
+
+private:
+	/// The positions of the persons infected by any rank, given those infected by this one.
+	std::vector<std::uint32_t> Exchange(const std::vector<std::uint32_t>& infected) const;
+
+	/// Count the cases and the persons that may infect among the owned persons, summed over the ranks.
+	void Reduce();
+
+private:
+	std::shared_ptr<Simulator>    m_sim;              ///< The simulator, the same on every rank.
+	unsigned int                  m_rank;             ///< Rank of this process.
+	unsigned int                  m_num_ranks;        ///< Number of processes.
+	Partition                     m_partition;        ///< Persons and clusters of every rank.
+	std::vector<std::uint32_t>    m_local;            ///< Owned persons and the members of owned clusters.
+	std::vector<std::uint8_t>     m_is_local;         ///< Flags of the local persons.
+	unsigned int                  m_infected_count;   ///< Cases over all ranks.
+	bool                          m_extinct;          ///< No one is or will become infectious.
+};
+
+} // end_of_namespace
+
+#endif // end-of-include-guard
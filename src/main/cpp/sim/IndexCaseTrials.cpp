@@ -0,0 +1,193 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Implementation of the IndexCaseTrials class.
+ */
+
+#include "IndexCaseTrials.h"
+
+#include "calendar/Calendar.h"
+#include "calendar/DaysOffFactory.h"
+#include "core/Cluster.h"
+#include "core/DiseaseProfile.h"
+#include "core/Health.h"
+#include "pop/Population.h"
+#include "pop/PopulationBuilder.h"
+#include "sim/Simulator.h"
+#include "util/Fingerprint.h"
+#include "util/Random.h"
+
+#include <omp.h>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace stride {
+
+using namespace std;
+using namespace boost::property_tree;
+using namespace stride::util;
+
+namespace {
+
+/// What a trial knows of a person: not met yet, immune, susceptible or infected.
+enum : uint8_t { Unknown = 0U, Immune = 1U, Susceptible = 2U, Infected = 3U };
+
+}
+
+IndexCaseTrials::IndexCaseTrials(const Simulator& model, const ptree& pt_config, const ptree& pt_disease,
+        unsigned int num_threads)
+        : m_model(model), m_num_threads(max(num_threads, 1U)), m_seed(pt_config.get<unsigned long>("run.rng_seed")),
+          m_transmission_rate(0.0), m_immunity_rate(pt_config.get<double>("run.immunity_rate"))
+{
+        if ( !m_model.m_population || m_model.m_population->empty() ) {
+                throw runtime_error(string(__func__) + "> Model simulator has no population.");
+        }
+        const Population& population = *m_model.m_population;
+
+        DiseaseProfile disease_profile;
+        disease_profile.Initialize(pt_config, pt_disease);
+        m_transmission_rate = disease_profile.GetTransmissionRate();
+
+        // Disease characteristics, and the last day (after the infection) an index case may be infectious.
+        for (const auto tag : { "disease.start_infectiousness", "disease.start_symptomatic",
+                        "disease.time_infectious", "disease.time_symptomatic" }) {
+                m_distributions.push_back(AliasTable::FromCumulative(PopulationBuilder::GetDistribution(pt_disease, tag)));
+        }
+        const size_t max_days = m_distributions[0].size() + m_distributions[2].size();
+
+        // Days off, as the Simulator has them on each day from the start date.
+        auto calendar = make_shared<Calendar>(pt_config);
+        const auto days_off = DaysOffFactory::Create(pt_config.get<string>("run.days_off", "Standard"), calendar);
+        for (size_t d = 0; d < max_days; d++) {
+                m_days_off.emplace_back(days_off->IsWorkOff(), days_off->IsSchoolOff());
+                calendar->AdvanceDay();
+        }
+
+        // The cluster of each type of every person.
+        const array<const vector<Cluster>*, NumOfClusterTypes()> all_clusters { { &m_model.m_households,
+                &m_model.m_school_clusters, &m_model.m_work_clusters, &m_model.m_primary_community,
+                &m_model.m_secondary_community } };
+        array<uint32_t, NumOfClusterTypes()> none;
+        none.fill(NoCluster());
+        m_clusters.assign(population.size(), none);
+        const Person* first = population.data();
+        for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+                const vector<Cluster>& clusters = *all_clusters[t];
+                for (size_t c = 0; c < clusters.size(); c++) {
+                        for (size_t i = 0; i < clusters[c].GetSize(); i++) {
+                                m_clusters[clusters[c].GetMember(i) - first][t] = static_cast<uint32_t>(c);
+                        }
+                }
+        }
+}
+
+vector<IndexCaseTrials::Trial> IndexCaseTrials::Run(unsigned int num_trials) const
+{
+        vector<Trial> trials(num_trials);
+        #pragma omp parallel num_threads(m_num_threads)
+        {
+                vector<uint8_t> state(m_model.m_population->size(), Unknown);
+                vector<uint32_t> touched;
+
+                #pragma omp for schedule(dynamic, 16)
+                for (unsigned int t = 0; t < num_trials; t++) {
+                        trials[t] = RunTrial(t, state, touched);
+                }
+        }
+        return trials;
+}
+
+IndexCaseTrials::Trial IndexCaseTrials::RunTrial(unsigned int trial, vector<uint8_t>& state, vector<uint32_t>& touched) const
+{
+        const array<const vector<Cluster>*, NumOfClusterTypes()> all_clusters { { &m_model.m_households,
+                &m_model.m_school_clusters, &m_model.m_work_clusters, &m_model.m_primary_community,
+                &m_model.m_secondary_community } };
+        const Population& population = *m_model.m_population;
+        const Person* first = population.data();
+
+        const unsigned long key[2] = { m_seed, trial };
+        Random rng(Fingerprint::Hash(key, sizeof(key)));
+
+        // The index case, and the course of its infection. Immunity does not enter its
+        // choice: immune persons are a random subset, so the others are as likely to be any person.
+        const uint32_t index = rng(static_cast<unsigned int>(population.size()));
+        Health health(m_distributions[0].Sample(rng.NextDouble()), m_distributions[1].Sample(rng.NextDouble()),
+                m_distributions[2].Sample(rng.NextDouble()), m_distributions[3].Sample(rng.NextDouble()));
+        health.StartInfection();
+        state[index] = Infected;
+        touched.push_back(index);
+
+        // Seeded persons are infected before the first health update.
+        unsigned int offspring = 0U;
+        const Person& p1 = population[index];
+        for (size_t d = 0; d < m_days_off.size(); d++) {
+                health.Update();
+                if ( !health.MayInfect() ) {
+                        break;
+                }
+                if ( !health.IsInfectious() ) {
+                        continue;
+                }
+                const bool is_work_off   = m_days_off[d].first;
+                const bool is_school_off = m_days_off[d].second;
+                for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+                        const auto type = static_cast<ClusterType>(t);
+                        const uint32_t c = m_clusters[index][t];
+                        if (c == NoCluster() || !p1.IsInCluster(type, is_work_off, is_school_off)) {
+                                continue;
+                        }
+                        const Cluster& cluster = (*all_clusters[t])[c];
+                        const double q = 1.0 - exp(-m_transmission_rate * cluster.GetContactRate(&p1));
+                        for (size_t i = 0; i < cluster.GetSize(); i++) {
+                                const Person* p2 = cluster.GetMember(i);
+                                const uint32_t j = static_cast<uint32_t>(p2 - first);
+                                if (state[j] == Unknown) {
+                                        state[j] = (rng.NextDouble() < m_immunity_rate) ? Immune : Susceptible;
+                                        touched.push_back(j);
+                                }
+                                if (state[j] == Susceptible && p2->IsInCluster(type, is_work_off, is_school_off)
+                                        && rng.NextDouble() < q) {
+                                        state[j] = Infected;
+                                        ++offspring;
+                                }
+                        }
+                }
+        }
+
+        for (const auto j : touched) {
+                state[j] = Unknown;
+        }
+        touched.clear();
+        return Trial { index, offspring };
+}
+
+vector<unsigned int> IndexCaseTrials::GetDistribution(const vector<Trial>& trials)
+{
+        vector<unsigned int> distribution;
+        for (const auto& trial : trials) {
+                if (distribution.size() <= trial.offspring) {
+                        distribution.resize(trial.offspring + 1U, 0U);
+                }
+                ++distribution[trial.offspring];
+        }
+        return distribution;
+}
+
+} // end_of_namespace
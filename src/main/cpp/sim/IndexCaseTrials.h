@@ -0,0 +1,92 @@
+#ifndef INDEX_CASE_TRIALS_H_INCLUDED
+#define INDEX_CASE_TRIALS_H_INCLUDED
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Header for the IndexCaseTrials class.
+ */
+
+#include "core/ClusterType.h"
+#include "util/AliasTable.h"
+
+#include <boost/property_tree/ptree.hpp>
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace stride {
+
+class Simulator;
+
+/**
+ * Estimates R0 from independent index case trials on the persons and clusters of a
+ * model simulator. A trial follows one index case, drawn at random, through its
+ * infection: each day it is infectious, it meets the members of its own clusters that
+ * are present as in the Simulator (same contact rates, transmission rate and days off)
+ * and the contacts it infects are counted but do not infect others, as with the
+ * track_index_case policy. A trial ends when the index case can no longer infect. Only
+ * the clusters of the index case are visited; contacts are immune with probability
+ * immunity_rate, drawn when the trial first meets them.
+ *
+ * Each trial has its own random stream, a function of rng_seed and the trial number,
+ * so trials run in parallel over the shared (read-only) model and the results do not
+ * depend on the number of threads.
+ */
+class IndexCaseTrials
+{
+public:
+	/// Outcome of a trial.
+	struct Trial
+	{
+		std::uint32_t  person;      ///< Position of the index case in the population.
+		unsigned int   offspring;   ///< Number of persons the index case infected.
+	};
+
+	/// Trials of the configured disease and immunity on the persons and clusters of the model.
+	IndexCaseTrials(const Simulator& model,
+	        const boost::property_tree::ptree& pt_config,
+	        const boost::property_tree::ptree& pt_disease,
+	        unsigned int num_threads = 1U);
+
+	/// Run trials 0, ..., num_trials - 1.
+	std::vector<Trial> Run(unsigned int num_trials) const;
+
+	/// Number of trials with 0, 1, 2, ... offspring.
+	static std::vector<unsigned int> GetDistribution(const std::vector<Trial>& trials);
+
+private:
+	/// Run one trial, with per person state (reset on return) in the given vector.
+	Trial RunTrial(unsigned int trial, std::vector<std::uint8_t>& state, std::vector<std::uint32_t>& touched) const;
+
+private:
+	/// No cluster of a type.
+	static constexpr std::uint32_t NoCluster() { return 0xFFFFFFFFU; }
+
+	const Simulator&                                          m_model;             ///< Persons and clusters.
+	unsigned int                                              m_num_threads;       ///< Number of (OpenMP) threads.
+	unsigned long                                             m_seed;              ///< Seed of the trials.
+	double                                                    m_transmission_rate; ///< Of the disease profile.
+	double                                                    m_immunity_rate;     ///< Probability a contact is immune.
+	std::vector<util::AliasTable>                             m_distributions;     ///< Disease characteristics.
+	std::vector<std::pair<bool, bool>>                        m_days_off;          ///< Work and school off, by day.
+	std::vector<std::array<std::uint32_t, NumOfClusterTypes()>> m_clusters;        ///< Clusters of each person.
+};
+
+} // end_of_namespace
+
+#endif // end-of-include-guard
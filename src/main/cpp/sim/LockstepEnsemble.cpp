@@ -0,0 +1,471 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Implementation of the LockstepEnsemble class.
+ */
+
+#include "LockstepEnsemble.h"
+
+#include "calendar/Calendar.h"
+#include "calendar/DaysOffFactory.h"
+#include "core/Cluster.h"
+#include "core/ClusterType.h"
+#include "core/DiseaseProfile.h"
+#include "core/Health.h"
+#include "pop/Population.h"
+#include "pop/PopulationBuilder.h"
+#include "sim/Simulator.h"
+
+#include <omp.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace stride {
+
+using namespace std;
+using namespace boost::property_tree;
+using namespace stride::util;
+
+namespace {
+
+/// What common random numbers are drawn for (first key of the hash).
+enum : uint64_t { Transmission = 1U, Characteristics = 2U, Selection = 3U };
+
+/// Number of (infector lane, susceptible lane) pairs to skip before the next transmission,
+/// for transmission probability q given log(1 - q).
+inline uint64_t NextGap(Random& rng, double log_no_transmission)
+{
+        const double gap = floor(log(1.0 - rng.NextDouble()) / log_no_transmission);
+        return (gap < 4.0e18) ? static_cast<uint64_t>(gap) : numeric_limits<uint64_t>::max();
+}
+
+/// Number of set bits.
+inline unsigned int Count(uint64_t lanes)
+{
+        return static_cast<unsigned int>(__builtin_popcountll(lanes));
+}
+
+/// Finalizer of the splitmix64 generator: a bijective mixing of the bits of x.
+inline uint64_t Mix(uint64_t x)
+{
+        x += 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30U)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27U)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31U);
+}
+
+/// Uniform number in [0, 1[ that is a function of the keys only.
+inline double Uniform(uint64_t k1, uint64_t k2, uint64_t k3, uint64_t k4 = 0U, uint64_t k5 = 0U, uint64_t k6 = 0U)
+{
+        const uint64_t h = Mix(Mix(Mix(Mix(Mix(Mix(k1) ^ k2) ^ k3) ^ k4) ^ k5) ^ k6);
+        return static_cast<double>(h >> 11U) * (1.0 / 9007199254740992.0);
+}
+
+}
+
+LockstepEnsemble::LockstepEnsemble(const Simulator& model, const ptree& pt_config, const ptree& pt_disease,
+        const vector<unsigned int>& seeds, unsigned int num_threads, bool track_index_case)
+        : m_model(model), m_calendar(make_shared<Calendar>(pt_config)), m_num_threads(max(num_threads, 1U)),
+          m_track_index_case(track_index_case), m_crn(false), m_day(0),
+          m_num_pending(0U), m_num_infectious(0U), m_rng(seeds.empty() ? 0U : seeds.front())
+{
+        vector<ptree> lane_configs(seeds.size(), pt_config);
+        for (size_t k = 0; k < seeds.size(); k++) {
+                lane_configs[k].put("run.rng_seed", seeds[k]);
+        }
+        Initialize(lane_configs, vector<ptree>(lane_configs.size(), pt_disease));
+}
+
+LockstepEnsemble::LockstepEnsemble(const Simulator& model, const vector<ptree>& lane_configs, const ptree& pt_disease,
+        unsigned int num_threads, bool track_index_case, bool common_random_numbers)
+        : m_model(model), m_calendar(make_shared<Calendar>(lane_configs.empty() ? ptree() : lane_configs.front())),
+          m_num_threads(max(num_threads, 1U)), m_track_index_case(track_index_case), m_crn(common_random_numbers),
+          m_day(0), m_num_pending(0U), m_num_infectious(0U),
+          m_rng(lane_configs.empty() ? 0U : lane_configs.front().get<unsigned int>("run.rng_seed"))
+{
+        Initialize(lane_configs, vector<ptree>(lane_configs.size(), pt_disease));
+}
+
+LockstepEnsemble::LockstepEnsemble(const Simulator& model, const vector<ptree>& lane_configs,
+        const vector<ptree>& lane_diseases, unsigned int num_threads, bool track_index_case, bool common_random_numbers)
+        : m_model(model), m_calendar(make_shared<Calendar>(lane_configs.empty() ? ptree() : lane_configs.front())),
+          m_num_threads(max(num_threads, 1U)), m_track_index_case(track_index_case), m_crn(common_random_numbers),
+          m_day(0), m_num_pending(0U), m_num_infectious(0U),
+          m_rng(lane_configs.empty() ? 0U : lane_configs.front().get<unsigned int>("run.rng_seed"))
+{
+        Initialize(lane_configs, lane_diseases);
+}
+
+void LockstepEnsemble::Initialize(const vector<ptree>& lane_configs, const vector<ptree>& lane_diseases)
+{
+        if (lane_configs.empty() || lane_configs.size() > MaxReplicas()) {
+                throw runtime_error(string(__func__) + "> Need 1 to " + to_string(MaxReplicas())
+                        + " lanes, got " + to_string(lane_configs.size()) + ".");
+        }
+        if (lane_diseases.size() != lane_configs.size()) {
+                throw runtime_error(string(__func__) + "> Need a disease configuration for each of the "
+                        + to_string(lane_configs.size()) + " lanes, got " + to_string(lane_diseases.size()) + ".");
+        }
+        if ( !m_model.m_population ) {
+                throw runtime_error(string(__func__) + "> Model simulator has no population.");
+        }
+        const Population& population = *m_model.m_population;
+        const size_t n = population.size();
+
+        // Disease characteristics of each distinct disease, and the disease of each lane.
+        const size_t num_lanes = lane_configs.size();
+        vector<const ptree*> diseases;
+        for (uint32_t lane = 0; lane < num_lanes; lane++) {
+                const ptree& pt_disease = lane_diseases[lane];
+                const size_t d = find_if(diseases.begin(), diseases.end(),
+                        [&pt_disease](const ptree* x) { return *x == pt_disease; }) - diseases.begin();
+                if (d == diseases.size()) {
+                        diseases.push_back(&pt_disease);
+                        m_distributions.emplace_back();
+                        for (const auto tag : { "disease.start_infectiousness", "disease.start_symptomatic",
+                                        "disease.time_infectious", "disease.time_symptomatic" }) {
+                                m_distributions.back().push_back(
+                                        AliasTable::FromCumulative(PopulationBuilder::GetDistribution(pt_disease, tag)));
+                        }
+                }
+                m_lane_disease.push_back(static_cast<uint32_t>(d));
+        }
+
+        // Lanes by seed, by transmission rate and by days off scheme.
+        vector<string> days_off_names;
+        for (uint32_t lane = 0; lane < num_lanes; lane++) {
+                const ptree& pt_config = lane_configs[lane];
+                const ptree& pt_disease = lane_diseases[lane];
+                const Lanes bit = Lanes(1U) << lane;
+
+                const uint64_t seed = pt_config.get<uint64_t>("run.rng_seed");
+                m_lane_seed.push_back(seed);
+                auto s = find_if(m_seeds.begin(), m_seeds.end(),
+                        [seed](const pair<uint64_t, Lanes>& x) { return x.first == seed; });
+                if (s == m_seeds.end()) {
+                        m_seeds.emplace_back(seed, bit);
+                } else {
+                        s->second |= bit;
+                }
+
+                DiseaseProfile disease_profile;
+                disease_profile.Initialize(pt_config, pt_disease);
+                const double rate = disease_profile.GetTransmissionRate();
+                auto r = find_if(m_rates.begin(), m_rates.end(),
+                        [rate](const pair<double, Lanes>& x) { return x.first == rate; });
+                if (r == m_rates.end()) {
+                        m_rates.emplace_back(rate, bit);
+                } else {
+                        r->second |= bit;
+                }
+
+                const auto name = pt_config.get<string>("run.days_off", "Standard");
+                const size_t d = find(days_off_names.begin(), days_off_names.end(), name) - days_off_names.begin();
+                if (d == days_off_names.size()) {
+                        days_off_names.push_back(name);
+                        m_days_off.emplace_back(DaysOffFactory::Create(name, m_calendar), bit);
+                } else {
+                        m_days_off[d].second |= bit;
+                }
+        }
+
+        // Everyone is susceptible in every lane, until the lane's immunity and seeding.
+        const Lanes all = (num_lanes == 64U) ? ~Lanes(0U) : ((Lanes(1U) << num_lanes) - 1U);
+        m_susceptible.assign(n, all);
+        m_infectious.assign(n, 0U);
+        m_cases.assign(num_lanes, 0U);
+
+        // Immune and infected persons of each lane. Independent lanes draw them as the
+        // PopulationBuilder draws them (over the persons in the order of the population file).
+        // With common random numbers, the lanes of a seed take their infected and then their
+        // immune persons from the front of one random order of the persons.
+        vector<uint32_t> position(n);
+        for (size_t i = 0; i < n; i++) {
+                position[population[i].GetId()] = i;
+        }
+        vector<vector<uint32_t>> seed_order(m_seeds.size());
+        for (uint32_t lane = 0; lane < num_lanes; lane++) {
+                const double immunity_rate = lane_configs[lane].get<double>("run.immunity_rate");
+                const double seeding_rate  = lane_configs[lane].get<double>("run.seeding_rate");
+                const size_t num_immune    = floor(static_cast<double>(n) * immunity_rate);
+                const size_t num_infected  = floor(static_cast<double>(n) * seeding_rate);
+                if (num_immune + num_infected > n) {
+                        throw runtime_error(string(__func__) + "> Bad input data.");
+                }
+
+                Random rng(m_lane_seed[lane]);
+                vector<uint32_t> infected;
+                vector<uint32_t> immune;
+                if (m_crn) {
+                        const size_t s = find_if(m_seeds.begin(), m_seeds.end(),
+                                [this, lane](const pair<uint64_t, Lanes>& x) { return x.first == m_lane_seed[lane]; })
+                                - m_seeds.begin();
+                        auto& order = seed_order[s];
+                        if (order.size() < num_infected + num_immune) {
+                                vector<pair<double, uint32_t>> keys(n);
+                                for (uint32_t id = 0; id < n; id++) {
+                                        keys[id] = make_pair(Uniform(Selection, m_lane_seed[lane], id), id);
+                                }
+                                const auto last = keys.begin() + (num_infected + num_immune);
+                                partial_sort(keys.begin(), last, keys.end());
+                                order.clear();
+                                for (auto it = keys.begin(); it != last; ++it) {
+                                        order.push_back(position[it->second]);
+                                }
+                        }
+                        infected.assign(order.begin(), order.begin() + num_infected);
+                        immune.assign(order.begin() + num_infected, order.begin() + (num_infected + num_immune));
+                } else {
+                        const auto selected = PopulationBuilder::DrawSubset(rng, n, num_immune + num_infected);
+                        vector<uint32_t> selected_index;
+                        selected_index.reserve(num_immune + num_infected);
+                        for (size_t i = 0; i < n; i++) {
+                                if (selected[i]) {
+                                        selected_index.push_back(position[i]);
+                                }
+                        }
+                        const auto is_infected = PopulationBuilder::DrawSubset(rng, selected_index.size(), num_infected);
+                        for (size_t i = 0; i < selected_index.size(); i++) {
+                                (is_infected[i] ? infected : immune).push_back(selected_index[i]);
+                        }
+                }
+
+                for (const auto p : immune) {
+                        m_susceptible[p] &= ~(Lanes(1U) << lane);
+                }
+                for (const auto p : infected) {
+                        m_susceptible[p] &= ~(Lanes(1U) << lane);
+                        ++m_cases[lane];
+                        // Seeded persons are infected before the first health update.
+                        StartInfection(p, lane, -1, DrawCharacteristics(p, lane, rng));
+                }
+        }
+
+        m_thread_rng.assign(m_num_threads, Random(m_rng(numeric_limits<unsigned int>::max())));
+        for (unsigned int i = 0; i < m_num_threads; i++) {
+                m_thread_rng[i].Split(m_num_threads, i);
+        }
+        m_infections.resize(m_num_threads);
+}
+
+array<double, 4> LockstepEnsemble::DrawCharacteristics(uint32_t person, uint32_t lane, Random& rng) const
+{
+        array<double, 4> u;
+        if (m_crn) {
+                const uint64_t id = (*m_model.m_population)[person].GetId();
+                for (uint64_t k = 0; k < u.size(); k++) {
+                        u[k] = Uniform(Characteristics, m_lane_seed[lane], id, k);
+                }
+        } else {
+                for (auto& x : u) {
+                        x = rng.NextDouble();
+                }
+        }
+        return u;
+}
+
+void LockstepEnsemble::StartInfection(uint32_t person, uint32_t lane, long day, const array<double, 4>& u)
+{
+        const auto& distributions = m_distributions[m_lane_disease[lane]];
+        Health health(distributions[0].Sample(u[0]), distributions[1].Sample(u[1]),
+                distributions[2].Sample(u[2]), distributions[3].Sample(u[3]));
+        health.StartInfection();
+
+        // Follow the daily health updates, as the Simulator does them, up to the end of the infection.
+        const unsigned int last = max(health.GetEndInfectiousness(), health.GetEndSymptomatic()) + 1U;
+        bool infectious = false;
+        for (unsigned int d = 1U; d <= last && health.IsInfected(); d++) {
+                health.Update();
+                if (health.IsInfectious() != infectious) {
+                        infectious = !infectious;
+                        const size_t event_day = static_cast<size_t>(day + d);
+                        if (m_events.size() <= event_day) {
+                                m_events.resize(event_day + 1U);
+                        }
+                        m_events[event_day].push_back(Event { person, lane, infectious });
+                        ++m_num_pending;
+                }
+        }
+}
+
+void LockstepEnsemble::TimeStep()
+{
+        // Health updates: the starts and ends of infectious periods that fall on today.
+        if (static_cast<size_t>(m_day) < m_events.size()) {
+                for (const auto& e : m_events[m_day]) {
+                        const Lanes lane = Lanes(1U) << e.lane;
+                        m_infectious[e.person] = e.start ? (m_infectious[e.person] | lane) : (m_infectious[e.person] & ~lane);
+                        m_num_infectious = e.start ? m_num_infectious + 1U : m_num_infectious - 1U;
+                }
+                m_num_pending -= m_events[m_day].size();
+                vector<Event>().swap(m_events[m_day]);
+        }
+
+        array<Lanes, 4> off_lanes {{ 0U, 0U, 0U, 0U }};
+        for (const auto& d : m_days_off) {
+                off_lanes[2U * d.first->IsWorkOff() + d.first->IsSchoolOff()] |= d.second;
+        }
+        // Without infectious persons in any lane, there are no transmissions.
+        for (size_t t = 0; t < NumOfClusterTypes() && m_num_infectious > 0U; t++) {
+                UpdateClusters(t, off_lanes);
+        }
+
+        // Infected persons become infectious after the next health updates.
+        for (auto& infections : m_infections) {
+                for (const auto& i : infections) {
+                        ++m_cases[i.lane];
+                        if ( !m_track_index_case ) {
+                                StartInfection(i.person, i.lane, m_day, DrawCharacteristics(i.person, i.lane, m_rng));
+                        }
+                }
+                infections.clear();
+        }
+
+        m_calendar->AdvanceDay();
+        ++m_day;
+}
+
+void LockstepEnsemble::UpdateClusters(size_t type, const array<Lanes, 4>& off_lanes)
+{
+        const array<const vector<Cluster>*, NumOfClusterTypes()> all_clusters { { &m_model.m_households,
+                &m_model.m_school_clusters, &m_model.m_work_clusters, &m_model.m_primary_community,
+                &m_model.m_secondary_community } };
+        const vector<Cluster>& clusters = *all_clusters[type];
+        const ClusterType cluster_type  = static_cast<ClusterType>(type);
+        const Person* first = m_model.m_population->data();
+
+        #pragma omp parallel num_threads(m_num_threads)
+        {
+                const unsigned int thread = omp_get_thread_num();
+                Random& rng = m_thread_rng[thread];
+                vector<Infection>& infections = m_infections[thread];
+                vector<pair<uint32_t, Lanes>> present;
+                vector<pair<uint32_t, const Person*>> infectors;
+                vector<double> q(m_rates.size());
+
+                // Infect person j in one lane, unless another transmission already did.
+                const auto infect = [&](uint32_t j, Lanes lane) {
+                        Lanes before;
+                        #pragma omp atomic capture
+                        { before = m_susceptible[j]; m_susceptible[j] &= ~lane; }
+                        if (before & lane) {
+                                infections.push_back(Infection { j, static_cast<uint32_t>(__builtin_ctzll(lane)) });
+                        }
+                };
+
+                #pragma omp for schedule(runtime)
+                for (size_t c = 0; c < clusters.size(); c++) {
+                        const Cluster& cluster = clusters[c];
+
+                        // Lanes in which each member is present today, and the members infectious in any of them.
+                        present.clear();
+                        infectors.clear();
+                        for (size_t i = 0; i < cluster.GetSize(); i++) {
+                                const Person* p = cluster.GetMember(i);
+                                Lanes lanes = 0U;
+                                for (unsigned int off = 0; off < off_lanes.size(); off++) {
+                                        if (off_lanes[off] != 0U && p->IsInCluster(cluster_type, (off & 2U) != 0U, (off & 1U) != 0U)) {
+                                                lanes |= off_lanes[off];
+                                        }
+                                }
+                                if (lanes != 0U) {
+                                        const uint32_t index = static_cast<uint32_t>(p - first);
+                                        present.emplace_back(index, lanes);
+                                        if ((m_infectious[index] & lanes) != 0U) {
+                                                infectors.emplace_back(present.size() - 1U, p);
+                                        }
+                                }
+                        }
+
+                        for (const auto& infector : infectors) {
+                                const Lanes infectious = m_infectious[present[infector.first].first] & present[infector.first].second;
+                                const double contact_rate = cluster.GetContactRate(infector.second);
+                                for (size_t r = 0; r < m_rates.size(); r++) {
+                                        q[r] = 1.0 - exp(-m_rates[r].first * contact_rate);
+                                }
+
+                                if (m_crn) {
+                                        // One uniform number per seed for every (infector, contact) pair: lanes
+                                        // of a seed transmit when it is below their transmission probability.
+                                        const uint64_t infector_id = infector.second->GetId();
+                                        for (const auto& member : present) {
+                                                Lanes candidates;
+                                                #pragma omp atomic read
+                                                candidates = m_susceptible[member.first];
+                                                candidates &= infectious & member.second;
+                                                for (size_t s = 0; s < m_seeds.size() && candidates != 0U; s++) {
+                                                        const Lanes seed_lanes = candidates & m_seeds[s].second;
+                                                        if (seed_lanes == 0U) {
+                                                                continue;
+                                                        }
+                                                        candidates &= ~seed_lanes;
+                                                        const double u = Uniform(Transmission, m_seeds[s].first, m_day, type, c,
+                                                                (infector_id << 32U) | first[member.first].GetId());
+                                                        Lanes transmitted = 0U;
+                                                        for (size_t r = 0; r < m_rates.size(); r++) {
+                                                                transmitted |= (u < q[r]) ? m_rates[r].second : 0U;
+                                                        }
+                                                        transmitted &= seed_lanes;
+                                                        while (transmitted != 0U) {
+                                                                infect(member.first, transmitted & (~transmitted + 1U));
+                                                                transmitted &= transmitted - 1U;
+                                                        }
+                                                }
+                                        }
+                                        continue;
+                                }
+
+                                // The pairs of an infector's lanes (with one transmission rate) with the
+                                // susceptible lanes of the present members form one sequence of Bernoulli
+                                // trials: skip to the transmissions.
+                                for (size_t r = 0; r < m_rates.size(); r++) {
+                                        const Lanes lanes = infectious & m_rates[r].second;
+                                        if (lanes == 0U || q[r] <= 0.0) {
+                                                continue;
+                                        }
+                                        const double log_no_transmission = log1p(-q[r]);
+                                        uint64_t gap = NextGap(rng, log_no_transmission);
+                                        for (const auto& member : present) {
+                                                Lanes candidates;
+                                                #pragma omp atomic read
+                                                candidates = m_susceptible[member.first];
+                                                candidates &= lanes & member.second;
+                                                while (candidates != 0U) {
+                                                        const unsigned int count = Count(candidates);
+                                                        if (gap >= count) {
+                                                                gap -= count;
+                                                                break;
+                                                        }
+                                                        for (uint64_t k = 0; k < gap; k++) {
+                                                                candidates &= candidates - 1U;
+                                                        }
+                                                        infect(member.first, candidates & (~candidates + 1U));
+                                                        candidates &= candidates - 1U;
+                                                        gap = NextGap(rng, log_no_transmission);
+                                                }
+                                        }
+                                }
+                        }
+                }
+        }
+}
+
+} // end_of_namespace
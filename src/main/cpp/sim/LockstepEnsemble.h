@@ -0,0 +1,176 @@
+#ifndef LOCKSTEP_ENSEMBLE_H_INCLUDED
+#define LOCKSTEP_ENSEMBLE_H_INCLUDED
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Header for the LockstepEnsemble class.
+ */
+
+#include "util/AliasTable.h"
+#include "util/Random.h"
+
+#include <boost/property_tree/ptree.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace stride {
+
+class Calendar;
+class DaysOffInterface;
+class Simulator;
+
+/**
+ * Runs up to 64 replicas of a simulation in one pass over the persons and clusters
+ * of a model simulator. Every replica is a lane: bit k
+ * of a person's lane masks holds that person's state in replica k, so the susceptible
+ * and infectious sets of all replicas are words and one traversal of the clusters
+ * serves all of them.
+ *
+ * Transmission has the same per contact probability as in the Simulator, but the
+ * Bernoulli trials of all lanes of an infector are drawn at once by skipping over the
+ * (infector lane, susceptible lane) pairs with geometric distributed gaps, i.e. one
+ * random draw per transmission rather than one per pair. The course of an infection
+ * (the days the person is infectious) is worked out when the infection starts, from
+ * disease characteristics drawn at that time. Replicas hence follow the same model as
+ * Simulator runs, but not the same random streams.
+ *
+ * Lanes may also be scenarios: configurations that differ in r0, immunity_rate,
+ * seeding_rate or days_off. With common random numbers, every draw is a function of
+ * what it is drawn for: the transmission draw of lanes with the same seed is the same
+ * uniform number for the same (day, cluster, infector, contact), a person's disease
+ * characteristics are the same whenever that person is infected, and seeded and immune
+ * persons are taken from one random order of the persons. Differences between such lanes
+ * are then due to the scenarios rather than to chance, and results do not depend on
+ * the number of threads.
+ *
+ * Lanes may also differ in their disease: each lane then has its own disease configuration
+ * (its disease characteristics and, with its r0, its transmission rate), as a replica run
+ * with another disease file. Several pathogens in one population, with one course per
+ * pathogen, are rather a Simulator with a list of disease files (see SimulatorBuilder).
+ */
+class LockstepEnsemble
+{
+public:
+	/// Lane masks: one bit per replica.
+	using Lanes = std::uint64_t;
+
+	/// Maximum number of replicas.
+	static constexpr unsigned int MaxReplicas() { return 64U; }
+
+	/// Replicas for the given seeds (at most MaxReplicas()) of the configured simulation,
+	/// on the persons and clusters of the model (which is not modified).
+	LockstepEnsemble(const Simulator& model,
+	        const boost::property_tree::ptree& pt_config,
+	        const boost::property_tree::ptree& pt_disease,
+	        const std::vector<unsigned int>& seeds,
+	        unsigned int num_threads = 1U,
+	        bool track_index_case = false);
+
+	/// One lane per configuration (at most MaxReplicas()). Lanes may differ in rng_seed, r0,
+	/// immunity_rate, seeding_rate and days_off; the calendar is that of the first one.
+	LockstepEnsemble(const Simulator& model,
+	        const std::vector<boost::property_tree::ptree>& lane_configs,
+	        const boost::property_tree::ptree& pt_disease,
+	        unsigned int num_threads = 1U,
+	        bool track_index_case = false,
+	        bool common_random_numbers = false);
+
+	/// As above, with the disease configuration of each lane (as many as there are lanes).
+	LockstepEnsemble(const Simulator& model,
+	        const std::vector<boost::property_tree::ptree>& lane_configs,
+	        const std::vector<boost::property_tree::ptree>& lane_diseases,
+	        unsigned int num_threads = 1U,
+	        bool track_index_case = false,
+	        bool common_random_numbers = false);
+
+	/// Number of replicas.
+	unsigned int GetNumReplicas() const { return static_cast<unsigned int>(m_cases.size()); }
+
+	/// Cumulative number of cases (infected or recovered persons) in every replica.
+	const std::vector<unsigned int>& GetInfectedCounts() const { return m_cases; }
+
+	/// Is the epidemic over in all replicas? Later time steps then change nothing.
+	bool IsExtinct() const { return m_num_pending == 0U; }
+
+	/// Run one time step in all replicas.
+	void TimeStep();
+
+private:
+	/// Start or end of the infectious period of a person in one lane.
+	struct Event
+	{
+		std::uint32_t  person;
+		std::uint32_t  lane;
+		bool           start;
+	};
+
+	/// Infection of a person in one lane.
+	struct Infection
+	{
+		std::uint32_t  person;
+		std::uint32_t  lane;
+	};
+
+	/// Set up lanes, immunity and seeding.
+	void Initialize(const std::vector<boost::property_tree::ptree>& lane_configs,
+	        const std::vector<boost::property_tree::ptree>& lane_diseases);
+
+	/// Uniform numbers for the disease characteristics of a person infected in a lane.
+	std::array<double, 4> DrawCharacteristics(std::uint32_t person, std::uint32_t lane, util::Random& rng) const;
+
+	/// Schedule the infectious period of a person infected (after the health update)
+	/// on the given day, with the given uniform numbers for the disease characteristics.
+	void StartInfection(std::uint32_t person, std::uint32_t lane, long day, const std::array<double, 4>& u);
+
+	/// Transmissions in the clusters of one type, into the infections of each thread;
+	/// off_lanes are the lanes with each combination of work off (2) and school off (1).
+	void UpdateClusters(std::size_t type, const std::array<Lanes, 4>& off_lanes);
+
+private:
+	const Simulator&                         m_model;            ///< Persons and clusters.
+	std::shared_ptr<Calendar>                m_calendar;         ///< Management of calendar.
+	unsigned int                             m_num_threads;      ///< Number of (OpenMP) threads.
+	bool                                     m_track_index_case; ///< Only the seeded persons infect others.
+	bool                                     m_crn;              ///< Common random numbers.
+	long                                     m_day;              ///< Days simulated.
+
+	std::vector<std::uint64_t>                                       m_lane_seed;  ///< Seed of each lane.
+	std::vector<std::uint32_t>                                       m_lane_disease; ///< Disease of each lane.
+	std::vector<std::pair<std::uint64_t, Lanes>>                     m_seeds;      ///< Lanes by seed.
+	std::vector<std::pair<double, Lanes>>                            m_rates;      ///< Lanes by transmission rate.
+	std::vector<std::pair<std::shared_ptr<DaysOffInterface>, Lanes>> m_days_off;   ///< Lanes by days off scheme.
+
+	std::vector<Lanes>                       m_susceptible;      ///< Lanes in which each person is susceptible.
+	std::vector<Lanes>                       m_infectious;       ///< Lanes in which each person is infectious.
+	std::vector<unsigned int>                m_cases;            ///< Cumulative cases per lane.
+	std::vector<std::vector<Event>>          m_events;           ///< Events, by day.
+	std::size_t                              m_num_pending;      ///< Events still to come.
+	std::size_t                              m_num_infectious;   ///< Infectious (person, lane) pairs.
+
+	std::vector<std::vector<util::AliasTable>> m_distributions;  ///< Disease characteristics, by disease.
+	util::Random                             m_rng;              ///< Draws of disease characteristics.
+	std::vector<util::Random>                m_thread_rng;       ///< Transmission draws, per thread.
+	std::vector<std::vector<Infection>>      m_infections;       ///< Infections of the day, per thread.
+};
+
+} // end_of_namespace
+
+#endif // end-of-include-guard
@@ -0,0 +1,137 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Implementation of the MemoryPlacement class.
+ */
+
+#include "MemoryPlacement.h"
+
+#include "core/Cluster.h"
+#include "core/ClusterType.h"
+#include "pop/Population.h"
+#include "sim/Partition.h"
+#include "sim/Simulator.h"
+
+#include <omp.h>
+#include <array>
+#include <utility>
+#include <vector>
+
+namespace stride {
+
+using namespace std;
+
+void MemoryPlacement::Relocate(Cluster& cluster, const Person* old_first, Person* new_first, const vector<size_t>& position)
+{
+        ClusterMembers members;
+        members.reserve(cluster.m_members.size());
+        for (const auto& m : cluster.m_members) {
+                members.emplace_back(new_first + position[m.first - old_first], m.second);
+        }
+        cluster.m_members.swap(members);
+}
+
+void MemoryPlacement::Rebase(vector<Cluster>& clusters, const Person* old_first, Person* new_first)
+{
+        #pragma omp parallel for schedule(static)
+        for (size_t c = 0; c < clusters.size(); c++) {
+                Cluster& cluster = clusters[c];
+                ClusterMembers members;
+                members.reserve(cluster.m_members.size());
+                for (const auto& m : cluster.m_members) {
+                        members.emplace_back(new_first + (m.first - old_first), m.second);
+                }
+                cluster.m_members.swap(members);
+        }
+}
+
+void MemoryPlacement::Apply(Simulator& sim)
+{
+        const unsigned int num_threads = sim.m_num_threads;
+        if (num_threads <= 1U || !sim.m_population) {
+                return;
+        }
+        Population& population = *sim.m_population;
+        const Partition& partition = sim.m_partition;
+        const size_t n = population.size();
+        const array<vector<Cluster>*, NumOfClusterTypes()> clusters { { &sim.m_households,
+                &sim.m_school_clusters, &sim.m_work_clusters, &sim.m_primary_community, &sim.m_secondary_community } };
+
+        // New position of every person; thread i places the range [first[i], first[i + 1][.
+        vector<size_t> position(n);
+        vector<size_t> first(num_threads + 1U, n);
+        if (partition.IsEmpty()) {
+                for (size_t i = 0; i < n; i++) {
+                        position[i] = i;
+                }
+                for (unsigned int i = 0; i < num_threads; i++) {
+                        first[i] = n * i / num_threads;
+                }
+        } else {
+                size_t next = 0U;
+                for (unsigned int i = 0; i < num_threads; i++) {
+                        first[i] = next;
+                        for (const auto p : partition.GetPersons(i)) {
+                                position[p] = next++;
+                        }
+                }
+        }
+        vector<size_t> source(n);
+        for (size_t i = 0; i < n; i++) {
+                source[position[i]] = i;
+        }
+
+        // Storage of the new population is left untouched until its range's thread writes it.
+        Population placed(population.get_allocator());
+        placed.resize(n);
+        const Person* old_first = population.data();
+        Person* new_first = placed.data();
+
+        #pragma omp parallel num_threads(num_threads)
+        {
+                const unsigned int thread = omp_get_thread_num();
+                const unsigned int team   = omp_get_num_threads();
+                for (unsigned int i = thread; i < num_threads; i += team) {
+                        for (size_t j = first[i]; j < first[i + 1]; j++) {
+                                placed[j] = population[source[j]];
+                        }
+                }
+
+                if (partition.IsEmpty()) {
+                        for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+                                #pragma omp for schedule(static)
+                                for (size_t c = 0; c < clusters[t]->size(); c++) {
+                                        Relocate((*clusters[t])[c], old_first, new_first, position);
+                                }
+                        }
+                } else {
+                        for (unsigned int i = thread; i < num_threads; i += team) {
+                                for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+                                        for (const auto c : partition.GetClusters(i, static_cast<ClusterType>(t))) {
+                                                Relocate((*clusters[t])[c], old_first, new_first, position);
+                                        }
+                                }
+                        }
+                }
+        }
+        population.swap(placed);
+        if ( !partition.IsEmpty() ) {
+                sim.m_partition.Permute(position);
+        }
+}
+
+} // end_of_namespace
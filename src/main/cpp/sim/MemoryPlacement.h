@@ -0,0 +1,58 @@
+#ifndef MEMORY_PLACEMENT_H_INCLUDED
+#define MEMORY_PLACEMENT_H_INCLUDED
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Header for the MemoryPlacement class.
+ */
+
+#include <cstddef>
+#include <vector>
+
+namespace stride {
+
+class Cluster;
+class Person;
+class Simulator;
+
+/**
+ * Places the persons and cluster member lists of a built simulator on the NUMA
+ * nodes of the threads that will use them, by letting those threads write them
+ * first (first-touch policy of the operating system).
+ */
+class MemoryPlacement
+{
+public:
+	/// Re-create population and cluster member lists by the threads that will process
+	/// them. When the simulator is partitioned, the persons of each partition are moved
+	/// to a contiguous range; otherwise persons keep their positions and every thread
+	/// places an equal block. Nothing is done for a single thread.
+	static void Apply(Simulator& sim);
+
+	/// Point the members of clusters copied from another simulator to the persons at
+	/// the same positions in this simulator's copy of the population.
+	static void Rebase(std::vector<Cluster>& clusters, const Person* old_first, Person* new_first);
+
+private:
+	/// Point the members of the cluster to their new positions, in a member list allocated by the calling thread.
+	static void Relocate(Cluster& cluster, const Person* old_first, Person* new_first,
+	        const std::vector<std::size_t>& position);
+};
+
+} // end_of_namespace
+
+#endif // include-guard
@@ -0,0 +1,181 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Implementation of the Metapopulation class.
+ */
+
+#include "Metapopulation.h"
+
+#include "core/ContactMatrixReader.h"
+#include "core/Health.h"
+#include "pop/Population.h"
+#include "pop/PopulationBuilder.h"
+#include "pop/PopulationGenerator.h"
+#include "sim/Simulator.h"
+#include "sim/SimulatorBuilder.h"
+#include "util/InstallDirs.h"
+#include "util/Random.h"
+
+#include <boost/filesystem.hpp>
+#include <boost/property_tree/xml_parser.hpp>
+#include <omp.h>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace stride {
+
+using namespace std;
+using namespace boost::filesystem;
+using namespace boost::property_tree;
+using namespace stride::util;
+
+namespace {
+
+using Record = PopulationBuilder::Record;
+
+}
+
+Metapopulation::Metapopulation(const ptree& pt_config, unsigned int num_threads)
+        : m_num_threads(max(num_threads, 1U))
+{
+        // Disease and contact matrices, the same in every region.
+        ptree pt_disease;
+        const auto file_path_d = InstallDirs::GetDataDir() / pt_config.get<string>("run.disease_config_file");
+        if ( !is_regular_file(file_path_d) ) {
+                throw runtime_error(string(__func__) + "> No file " + file_path_d.string());
+        }
+        read_xml(file_path_d.string(), pt_disease);
+        const auto contact_matrices = ContactMatrixReader::Read(pt_config);
+
+        // The persons of each region, generated for the region: its households, schools and
+        // communities, and the workplaces of the region and of the regions its commuters go to.
+        const PopulationGenerator generator(pt_config.get<string>("run.regions_file"),
+                pt_config.get<string>("run.commuting_file", ""));
+        const auto size = pt_config.get<size_t>("run.metapopulation_size");
+        const auto rng_seed = pt_config.get<unsigned long>("run.rng_seed");
+        const auto persons = generator.GenerateCities(size, rng_seed, m_num_threads);
+        for (const auto& city : generator.GetCities()) {
+                m_regions.push_back(Region { city.id, city.name, 0U, 0U });
+        }
+
+        // The residents of each region, with a stand-in in the region of work for those that
+        // work in another region: a member of their work cluster there.
+        vector<vector<Record>> region_rows(m_regions.size());
+        vector<vector<Record>> stand_ins(m_regions.size());
+        for (size_t r = 0; r < m_regions.size(); r++) {
+                for (const auto& p : persons[r]) {
+                        const bool commutes = p.ids[2] > 0U && p.work_city != r;
+                        region_rows[r].push_back(Record { { p.age, p.ids[0], p.ids[1],
+                                commutes ? 0U : p.ids[2], p.ids[3], p.ids[4] } });
+                        if (commutes) {
+                                const uint32_t w = p.work_city;
+                                m_commuters.push_back(Commuter { static_cast<uint32_t>(r),
+                                        static_cast<uint32_t>(region_rows[r].size() - 1U), w,
+                                        static_cast<uint32_t>(persons[w].size() + stand_ins[w].size()) });
+                                stand_ins[w].push_back(Record { { p.age, 0U, 0U, p.ids[2], 0U, 0U } });
+                                ++m_regions[r].num_commuters;
+                        }
+                }
+                m_regions[r].num_persons = region_rows[r].size();
+        }
+
+        // Seed of each region.
+        Random rng(rng_seed);
+        vector<unsigned long> seeds;
+        for (size_t r = 0; r < m_regions.size(); r++) {
+                seeds.push_back(rng(numeric_limits<unsigned int>::max()));
+        }
+
+        // The simulator of each region, on its residents and then the stand-ins. Persons
+        // are at their position in the region's rows unless the layout reorders them.
+        vector<vector<uint32_t>> position(m_regions.size());
+        for (size_t r = 0; r < m_regions.size(); r++) {
+                const auto records = [&](const PopulationBuilder::RecordSink& sink) {
+                        sink(region_rows[r]);
+                        sink(stand_ins[r]);
+                };
+                ptree pt_region = pt_config;
+                pt_region.put("run.rng_seed", seeds[r]);
+                m_sims.push_back(SimulatorBuilder::Build(pt_region, pt_disease, contact_matrices, records, 1U));
+
+                const Population& population = *m_sims.back()->m_population;
+                position[r].resize(population.size());
+                m_residents.emplace_back();
+                for (size_t i = 0; i < population.size(); i++) {
+                        position[r][population[i].GetId()] = static_cast<uint32_t>(i);
+                        if (population[i].GetId() < m_regions[r].num_persons) {
+                                m_residents.back().push_back(static_cast<uint32_t>(i));
+                        }
+                }
+        }
+
+        // The stand-ins start with the health of their commuter.
+        for (auto& c : m_commuters) {
+                c.person   = position[c.home_region][c.person];
+                c.stand_in = position[c.work_region][c.stand_in];
+                m_sims[c.work_region]->SetHealth(c.stand_in,
+                        (*m_sims[c.home_region]->m_population)[c.person].GetHealth());
+        }
+}
+
+unsigned int Metapopulation::GetInfectedCount(size_t region) const
+{
+        const Population& population = *m_sims[region]->m_population;
+        unsigned int total = 0U;
+        for (const auto i : m_residents[region]) {
+                const auto& health = population[i].GetHealth();
+                total += health.IsInfected() || health.IsRecovered();
+        }
+        return total;
+}
+
+unsigned int Metapopulation::GetInfectedCount() const
+{
+        unsigned int total = 0U;
+        for (size_t r = 0; r < m_regions.size(); r++) {
+                total += GetInfectedCount(r);
+        }
+        return total;
+}
+
+void Metapopulation::TimeStep()
+{
+        #pragma omp parallel for num_threads(m_num_threads) schedule(dynamic)
+        for (size_t r = 0; r < m_sims.size(); r++) {
+                m_sims[r]->TimeStep();
+        }
+        Exchange();
+}
+
+void Metapopulation::Exchange()
+{
+        for (const auto& c : m_commuters) {
+                Simulator& home = *m_sims[c.home_region];
+                Simulator& work = *m_sims[c.work_region];
+                const Health& health = (*home.m_population)[c.person].GetHealth();
+                if ((*work.m_population)[c.stand_in].GetHealth().IsNewlyInfected() && health.IsSusceptible()) {
+                        Health infected = health;
+                        infected.StartInfection();
+                        home.SetHealth(c.person, infected);
+                }
+                work.SetHealth(c.stand_in, health);
+        }
+}
+
+} // end_of_namespace
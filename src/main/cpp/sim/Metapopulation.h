@@ -0,0 +1,109 @@
+#ifndef METAPOPULATION_H_INCLUDED
+#define METAPOPULATION_H_INCLUDED
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Header for the Metapopulation class.
+ */
+
+#include <boost/property_tree/ptree.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace stride {
+
+class Simulator;
+
+/**
+ * Regions (cities), each a Simulator of its own with its own persons and clusters, coupled
+ * by commuting. The regions are those of run.regions_file (city_id, city_name, province,
+ * population share, ...), each with its share of run.metapopulation_size persons, generated
+ * for the region by the PopulationGenerator: households, schools and communities of the
+ * size of those of a city, whatever the number of persons of the region. Workers work in
+ * another region with the proportion of run.commuting_file (city_depart, city_arrival,
+ * proportion) for that pair, and at home otherwise. A commuter lives in the home region, in
+ * all clusters but a work cluster, and has a stand-in in the region of work that is a member
+ * of only a work cluster there, one of the workplaces of that region.
+ *
+ * The regions take their time step in parallel, each on one thread, and are coupled only
+ * between time steps: a commuter becomes infected if the stand-in was infected at work that
+ * day, and each stand-in then takes over the health of its commuter. A stand-in is
+ * infectious at work on the days its commuter is infectious. Regions have their persons at
+ * their position in the region (ids are per region), have the settings of the configuration
+ * but for their own rng seed, drawn from run.rng_seed (which also seeds the generated
+ * persons), and the outcome does not depend on the number of threads.
+ */
+class Metapopulation
+{
+public:
+	/// A region.
+	struct Region
+	{
+		unsigned int   id;              ///< City id.
+		std::string    name;            ///< City name.
+		std::size_t    num_persons;     ///< Number of residents.
+		std::size_t    num_commuters;   ///< Number of residents that work in another region.
+	};
+
+	/// Build the regions and the commuting of the configuration.
+	Metapopulation(const boost::property_tree::ptree& pt_config, unsigned int num_threads = 1U);
+
+	/// Number of regions.
+	std::size_t GetNumRegions() const { return m_regions.size(); }
+
+	/// A region.
+	const Region& GetRegion(std::size_t region) const { return m_regions[region]; }
+
+	/// Simulator of a region: its residents and then the stand-ins of the commuters from other regions.
+	const std::shared_ptr<Simulator>& GetSimulator(std::size_t region) const { return m_sims[region]; }
+
+	/// Number of residents of a region that are or were infected.
+	unsigned int GetInfectedCount(std::size_t region) const;
+
+	/// Number of persons that are or were infected, in all regions.
+	unsigned int GetInfectedCount() const;
+
+	/// Run one time step in every region, then exchange the infections of the commuters.
+	void TimeStep();
+
+private:
+	/// Infect the commuters whose stand-in was infected and bring the stand-ins in line.
+	void Exchange();
+
+private:
+	/// A resident of one region that works in another.
+	struct Commuter
+	{
+		std::uint32_t  home_region;     ///< Region of residence.
+		std::uint32_t  person;          ///< Position of the commuter in the population of the home region.
+		std::uint32_t  work_region;     ///< Region of work.
+		std::uint32_t  stand_in;        ///< Position of the stand-in in the population of the work region.
+	};
+
+	unsigned int                               m_num_threads;   ///< Number of (OpenMP) threads.
+	std::vector<Region>                        m_regions;       ///< The regions.
+	std::vector<std::shared_ptr<Simulator>>    m_sims;          ///< Simulator of each region.
+	std::vector<std::vector<std::uint32_t>>    m_residents;     ///< Positions of the residents, per region.
+	std::vector<Commuter>                      m_commuters;     ///< All commuters.
+};
+
+} // end_of_namespace
+
+#endif // end-of-include-guard
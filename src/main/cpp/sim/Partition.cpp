@@ -0,0 +1,153 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Implementation of the Partition class.
+ */
+
+#include "Partition.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace stride {
+
+using namespace std;
+
+Partition::Partition(const Population& population, const Clusters& clusters, unsigned int num_partitions)
+        : m_owners(population.size(), 0U), m_persons(num_partitions), m_clusters(num_partitions),
+          m_num_memberships(0U), m_num_cut(0U)
+{
+        if (num_partitions == 0U) {
+                throw runtime_error(string(__func__) + "> Need at least one partition.");
+        }
+        const size_t n        = population.size();
+        const auto   first    = population.data();
+        const auto   no_index = numeric_limits<unsigned int>::max();
+        const auto   hh       = ToSizeType(ClusterType::Household);
+
+        // Cluster index of every membership.
+        array<vector<unsigned int>, NumOfClusterTypes()> cluster_of;
+        for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+                cluster_of[t].assign(n, no_index);
+                for (size_t c = 0; c < clusters[t]->size(); c++) {
+                        const auto& cluster = (*clusters[t])[c];
+                        for (size_t i = 0; i < cluster.GetSize(); i++) {
+                                cluster_of[t][cluster.GetMember(i) - first] = c;
+                        }
+                }
+        }
+
+        // Units that go to a partition as a whole: households, then persons without one.
+        vector<vector<size_t>> units;
+        units.reserve(clusters[hh]->size());
+        for (const auto& household : *clusters[hh]) {
+                units.emplace_back();
+                for (size_t i = 0; i < household.GetSize(); i++) {
+                        units.back().push_back(household.GetMember(i) - first);
+                }
+        }
+        for (size_t p = 0; p < n; p++) {
+                if (cluster_of[hh][p] == no_index) {
+                        units.emplace_back(1U, p);
+                }
+        }
+
+        // Streaming greedy assignment: prefer the partition that already holds most of the
+        // unit's school, work and community contacts, discounted by how full it is.
+        const double capacity = 1.02 * static_cast<double>(n) / num_partitions + 1.0;
+        vector<size_t> load(num_partitions, 0U);
+        vector<double> score(num_partitions);
+        array<vector<unsigned int>, NumOfClusterTypes()> count;
+        for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+                count[t].assign(clusters[t]->size() * num_partitions, 0U);
+        }
+        for (const auto& unit : units) {
+                fill(score.begin(), score.end(), 0.0);
+                for (const auto p : unit) {
+                        for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+                                const auto c = cluster_of[t][p];
+                                if (t != hh && c != no_index) {
+                                        for (unsigned int k = 0; k < num_partitions; k++) {
+                                                score[k] += count[t][c * num_partitions + k];
+                                        }
+                                }
+                        }
+                }
+                unsigned int best = 0U;
+                double best_score = -1.0;
+                for (unsigned int k = 0; k < num_partitions; k++) {
+                        if (load[k] + unit.size() > capacity && load[k] > 0U) {
+                                continue;
+                        }
+                        const double s = score[k] * (1.0 - load[k] / capacity);
+                        if (s > best_score || (s == best_score && load[k] < load[best])) {
+                                best = k;
+                                best_score = s;
+                        }
+                }
+                if (best_score < 0.0) {
+                        best = min_element(load.begin(), load.end()) - load.begin();
+                }
+                load[best] += unit.size();
+                for (const auto p : unit) {
+                        m_owners[p] = best;
+                        for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+                                const auto c = cluster_of[t][p];
+                                if (c != no_index) {
+                                        count[t][c * num_partitions + best]++;
+                                }
+                        }
+                }
+        }
+        for (size_t p = 0; p < n; p++) {
+                m_persons[m_owners[p]].push_back(p);
+        }
+
+        // Every cluster goes to the partition that owns most of its members.
+        for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+                for (size_t c = 0; c < clusters[t]->size(); c++) {
+                        const auto counts = count[t].begin() + c * num_partitions;
+                        const auto owner  = static_cast<unsigned int>(
+                                max_element(counts, counts + num_partitions) - counts);
+                        m_clusters[owner][t].push_back(c);
+                        m_num_memberships += (*clusters[t])[c].GetSize();
+                        m_num_cut         += (*clusters[t])[c].GetSize() - counts[owner];
+                }
+        }
+}
+
+void Partition::Permute(const vector<size_t>& position)
+{
+        if (position.size() != m_owners.size()) {
+                throw runtime_error(string(__func__) + "> Positions do not match the population size.");
+        }
+        vector<unsigned int> owners(m_owners.size());
+        for (size_t i = 0; i < position.size(); i++) {
+                owners[position[i]] = m_owners[i];
+        }
+        m_owners.swap(owners);
+        for (auto& persons : m_persons) {
+                for (auto& p : persons) {
+                        p = position[p];
+                }
+                sort(persons.begin(), persons.end());
+        }
+}
+
+} // end_of_namespace
@@ -0,0 +1,90 @@
+#ifndef PARTITION_H_INCLUDED
+#define PARTITION_H_INCLUDED
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Header for the Partition class.
+ */
+
+#include "core/Cluster.h"
+#include "core/ClusterType.h"
+#include "pop/Population.h"
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace stride {
+
+/**
+ * Assignment of persons and clusters to partitions, one per thread. A partition's
+ * thread processes the clusters it owns and is the only one to write the persons it
+ * owns. Persons go to partitions household by household, greedily minimizing the
+ * number of cluster memberships that cross partitions (linear deterministic greedy
+ * streaming partitioning of the person-cluster graph, with a balance constraint on
+ * the number of persons). A cluster goes to the partition owning most of its members.
+ */
+class Partition
+{
+public:
+	/// Cluster containers, in ClusterType order.
+	using Clusters = std::array<const std::vector<Cluster>*, NumOfClusterTypes()>;
+
+	/// Empty partition (no partitioning).
+	Partition() : m_num_memberships(0U), m_num_cut(0U) {}
+
+	/// Partition the population and clusters.
+	Partition(const Population& population, const Clusters& clusters, unsigned int num_partitions);
+
+	/// Is this the empty partition?
+	bool IsEmpty() const { return m_owners.empty(); }
+
+	/// Number of partitions.
+	unsigned int GetNumPartitions() const { return m_persons.size(); }
+
+	/// Owner partition of every person (by position in the population).
+	const std::vector<unsigned int>& GetOwners() const { return m_owners; }
+
+	/// Positions of the persons owned by the partition.
+	const std::vector<std::size_t>& GetPersons(unsigned int partition) const { return m_persons[partition]; }
+
+	/// Indices of the clusters of the given type owned by the partition.
+	const std::vector<std::size_t>& GetClusters(unsigned int partition, ClusterType type) const
+	{
+		return m_clusters[partition][ToSizeType(type)];
+	}
+
+	/// Total number of cluster memberships.
+	std::size_t GetNumMemberships() const { return m_num_memberships; }
+
+	/// Number of memberships where person and cluster are owned by different partitions.
+	std::size_t GetNumCut() const { return m_num_cut; }
+
+	/// Follow the persons to their new positions in the population (position[old] = new).
+	void Permute(const std::vector<std::size_t>& position);
+
+private:
+	std::vector<unsigned int>                                                  m_owners;
+	std::vector<std::vector<std::size_t>>                                      m_persons;
+	std::vector<std::array<std::vector<std::size_t>, NumOfClusterTypes()>>     m_clusters;
+	std::size_t                                                                m_num_memberships;
+	std::size_t                                                                m_num_cut;
+};
+
+} // end_of_namespace
+
+#endif // include-guard
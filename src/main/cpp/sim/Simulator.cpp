@@ -21,7 +21,7 @@
 #include "Simulator.h"
 
 #include "calendar/Calendar.h"
-#include "calendar/DaysOffStandard.h"
+#include "calendar/DaysOffInterface.h"
 #include "core/Cluster.h"
 #include "core/ClusterType.h"
 #include "core/Infector.h"
@@ -30,6 +30,8 @@
 
 #include <boost/property_tree/ptree.hpp>
 #include <omp.h>
+#include <array>
+#include <chrono>
 #include <memory>
 
 namespace stride {
@@ -39,8 +41,10 @@ using namespace boost::property_tree;
 using namespace stride::util;
 
 Simulator::Simulator()
-        : m_config_pt(), m_num_threads(1U), m_log_level(LogMode::Null), m_population(nullptr),
-          m_disease_profile(), m_track_index_case(false)
+        : m_config_pt(), m_num_threads(1U), m_rng_handler_seed(0U), m_log_level(LogMode::Null), m_population(nullptr),
+          m_disease_profile(), m_mean_field(), m_num_mean_field(), m_age_mixing(),
+          m_track_index_case(false), m_days_not_infectious(0U), m_extinct(false),
+          m_cluster_engine(ClusterEngine::Dense), m_pass_cost(), m_pass_day()
 {
 }
 
@@ -49,86 +53,334 @@ const shared_ptr<const Population> Simulator::GetPopulation() const
         return m_population;
 }
 
+unsigned int Simulator::GetInfectedCount(size_t pathogen) const
+{
+        if (pathogen == 0U) {
+                return m_population->GetInfectedCount();
+        }
+        unsigned int total {0U};
+        for (const auto& h : m_pathogens.tracks.at(pathogen - 1U).health) {
+                total += h.IsInfected() || h.IsRecovered();
+        }
+        return total;
+}
+
 void Simulator::SetTrackIndexCase(bool track_index_case)
 {
         m_track_index_case = track_index_case;
 }
 
 template<LogMode log_level, bool track_index_case>
-void Simulator::UpdateClusters()
+void Simulator::UpdateClusters(bool is_work_off, bool is_school_off)
 {
+        const array<vector<Cluster>*, NumOfClusterTypes()> clusters { { &m_households,
+                &m_school_clusters, &m_work_clusters, &m_primary_community, &m_secondary_community } };
+
         #pragma omp parallel num_threads(m_num_threads)
         {
                 const unsigned int thread = omp_get_thread_num();
 
-                #pragma omp for schedule(runtime)
-                for (size_t i = 0; i < m_households.size(); i++) {
-                        Infector<log_level, track_index_case>::Execute(
-                                m_households[i], m_disease_profile, m_rng_handler[thread], m_calendar);
+                for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+                        vector<Cluster>& type_clusters = *clusters[t];
+                        #pragma omp for schedule(runtime)
+                        for (size_t i = 0; i < type_clusters.size(); i++) {
+                                if ( !m_pathogens.empty() ) {
+                                        Infector<log_level, track_index_case>::ExecutePathogens(type_clusters[i],
+                                                m_disease_profile, m_rng_handler[thread], m_pathogens, thread,
+                                                m_calendar, is_work_off, is_school_off);
+                                } else if (Infector<log_level, track_index_case>::Execute(
+                                        type_clusters[i], m_disease_profile, m_rng_handler[thread], m_calendar,
+                                        is_work_off, is_school_off, nullptr, m_mean_field, m_age_mixing.get())) {
+                                        #pragma omp atomic
+                                        ++m_num_mean_field[t];
+                                }
+                        }
                 }
-                #pragma omp for schedule(runtime)
-                for (size_t i = 0; i < m_school_clusters.size(); i++) {
-                        Infector<log_level, track_index_case>::Execute(
-                                m_school_clusters[i], m_disease_profile, m_rng_handler[thread], m_calendar);
+        }
+}
+
+template<LogMode log_level, bool track_index_case>
+void Simulator::UpdateClustersPartitioned(bool is_work_off, bool is_school_off)
+{
+        const array<vector<Cluster>*, NumOfClusterTypes()> clusters { { &m_households,
+                &m_school_clusters, &m_work_clusters, &m_primary_community, &m_secondary_community } };
+        const unsigned int num_partitions = m_partition.GetNumPartitions();
+
+        #pragma omp parallel num_threads(m_num_threads)
+        {
+                // Should the runtime hand out fewer threads, each handles several partitions.
+                const unsigned int thread      = omp_get_thread_num();
+                const unsigned int num_threads = omp_get_num_threads();
+
+                // One cluster type after the other, as in UpdateClusters: a person is in one
+                // cluster of a type, so within a type no partition reads the health of a person
+                // that another one infects. The barrier keeps the types apart.
+                for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+                        for (unsigned int part = thread; part < num_partitions; part += num_threads) {
+                                for (const auto i : m_partition.GetClusters(part, static_cast<ClusterType>(t))) {
+                                        if (Infector<log_level, track_index_case>::Execute(
+                                                (*clusters[t])[i], m_disease_profile, m_rng_handler[part], m_calendar,
+                                                is_work_off, is_school_off, &m_mailboxes[part], m_mean_field, m_age_mixing.get())) {
+                                                #pragma omp atomic
+                                                ++m_num_mean_field[t];
+                                        }
+                                }
+                        }
+                        #pragma omp barrier
                 }
-                #pragma omp for schedule(runtime)
-                for (size_t i = 0; i < m_work_clusters.size(); i++) {
-                        Infector<log_level, track_index_case>::Execute(
-                                m_work_clusters[i], m_disease_profile, m_rng_handler[thread], m_calendar);
+
+                // Exchange: every partition applies the infections posted for its persons.
+                for (unsigned int part = thread; part < num_partitions; part += num_threads) {
+                        for (const auto& mailbox : m_mailboxes) {
+                                Infector<log_level, track_index_case>::Deliver(mailbox.GetPosted(part), m_calendar);
+                        }
                 }
-                #pragma omp for schedule(runtime)
-                for (size_t i = 0; i < m_primary_community.size(); i++) {
-                        Infector<log_level, track_index_case>::Execute(
-                                m_primary_community[i], m_disease_profile, m_rng_handler[thread], m_calendar);
+                #pragma omp barrier
+                for (unsigned int part = thread; part < num_partitions; part += num_threads) {
+                        m_mailboxes[part].Clear();
                 }
-                #pragma omp for schedule(runtime)
-                for (size_t i = 0; i < m_secondary_community.size(); i++) {
-                        Infector<log_level, track_index_case>::Execute(
-                                m_secondary_community[i], m_disease_profile, m_rng_handler[thread], m_calendar);
+        }
+}
+
+template<LogMode log_level, bool track_index_case>
+size_t Simulator::UpdateActiveClusters(bool is_work_off, bool is_school_off)
+{
+        const array<vector<Cluster>*, NumOfClusterTypes()> clusters { { &m_households,
+                &m_school_clusters, &m_work_clusters, &m_primary_community, &m_secondary_community } };
+        const Person* first = m_population->data();
+
+        size_t num_visited = 0U;
+        for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+                vector<Cluster>& type_clusters = *clusters[t];
+                const vector<uint32_t>& active = m_active_clusters.Take(t, m_infectious);
+                num_visited += active.size();
+
+                #pragma omp parallel for num_threads(m_num_threads) schedule(runtime)
+                for (size_t i = 0; i < active.size(); i++) {
+                        if (Infector<log_level, track_index_case>::Execute(
+                                type_clusters[active[i]], m_disease_profile, m_rng_handler[omp_get_thread_num()],
+                                m_calendar, is_work_off, is_school_off, nullptr, m_mean_field, m_age_mixing.get())) {
+                                #pragma omp atomic
+                                ++m_num_mean_field[t];
+                        }
+                }
+
+                // Visit again the clusters whose member order changed, and the clusters of the
+                // persons infected today (the later types today, the others tomorrow).
+                for (const auto c : active) {
+                        const Cluster& cluster = type_clusters[c];
+                        if ( !cluster.IsSorted() ) {
+                                m_active_clusters.Mark(t, c);
+                        }
+                        for (size_t i = 0; i < cluster.GetSize(); i++) {
+                                if (cluster.GetMember(i)->GetHealth().IsNewlyInfected()) {
+                                        m_active_clusters.MarkPerson(static_cast<uint32_t>(cluster.GetMember(i) - first));
+                                }
+                        }
+                }
+        }
+        return num_visited;
+}
+
+bool Simulator::IsSparseDay()
+{
+        if (m_cluster_engine == ClusterEngine::Dense || !m_partition.IsEmpty() || m_log_level == LogMode::Contacts) {
+                return false;
+        }
+        if (m_active_clusters.GetNumClusters() == 0U) {
+                m_active_clusters.Initialize(*m_population, { { &m_households, &m_school_clusters,
+                        &m_work_clusters, &m_primary_community, &m_secondary_community } });
+        }
+        if (m_cluster_engine == ClusterEngine::Sparse) {
+                return true;
+        }
+
+        // Each engine runs once, and again once its cost is a week old. Otherwise, the cost
+        // per visited cluster of the last pass of each engine gives the cheaper one today.
+        const size_t day = m_engine_days.size();
+        if (m_pass_cost[0] == 0.0 || m_pass_cost[1] == 0.0) {
+                return m_pass_cost[0] > 0.0;
+        }
+        if (day > m_pass_day[0] + 7U || day > m_pass_day[1] + 7U) {
+                return m_pass_day[1] < m_pass_day[0];
+        }
+        const size_t num_active = m_active_clusters.CountClusters(m_infectious);
+        return m_pass_cost[1] * num_active < m_pass_cost[0] * m_active_clusters.GetNumClusters();
+}
+
+void Simulator::SetHealth(size_t person, const Health& health)
+{
+        Health& current = (*m_population)[person].GetHealth();
+        const bool resorts = current.IsImmune() != health.IsImmune() || current.IsSusceptible() != health.IsSusceptible();
+        current = health;
+
+        // A change the sort of the cluster members tells apart: the clusters of the person
+        // are no longer at a fixed point of the sort.
+        if (resorts) {
+                m_days_not_infectious = 0U;
+                if (m_active_clusters.IsValid()) {
+                        m_active_clusters.MarkPerson(static_cast<uint32_t>(person));
                 }
         }
+        if (m_extinct && health.MayInfect()) {
+                m_extinct = false;
+                m_infected.clear();
+        }
 }
 
 void Simulator::TimeStep()
 {
-        shared_ptr<DaysOffInterface> days_off {nullptr};
+        // The days off scheme (run.days_off) applies to all clusters. If we want to make this
+        // cluster dependent then the days_off object has to be passed into the Update function.
+        const bool is_work_off {m_days_off->IsWorkOff() };
+        const bool is_school_off { m_days_off->IsSchoolOff() };
+
+        Population& population = *m_population;
+        if (m_extinct) {
+                // Only the disease clocks of the persons still infected and the calendar advance.
+                for (const auto i : m_infected) {
+                        population[i].Update();
+                }
+                m_pathogens.Update();
+                m_engine_days.push_back('-');
+                m_calendar->AdvanceDay();
+                return;
+        }
 
-        // Logic where you compute (on the basis of input/config for initial day
-        // or on the basis of number of sick persons, duration of epidemic etc)
-        // what kind of DaysOff scheme you apply. If we want to make this cluster
-        // dependent then the days_off object has to be passed into the Update function.
-        days_off = make_shared<DaysOffStandard>(m_calendar);
-        const bool is_work_off {days_off->IsWorkOff() };
-        const bool is_school_off { days_off->IsSchoolOff() };
+        size_t num_may_infect = 0U;
+        size_t num_infectious = 0U;
+        m_infectious.clear();
+        if (m_partition.IsEmpty()) {
+                const bool track_infectious = (m_cluster_engine != ClusterEngine::Dense);
+                for (size_t i = 0; i < population.size(); i++) {
+                        Person& p = population[i];
+                        p.Update();
+                        num_may_infect += p.GetHealth().MayInfect();
+                        if (p.GetHealth().IsInfectious()) {
+                                ++num_infectious;
+                                if (track_infectious) {
+                                        m_infectious.push_back(static_cast<uint32_t>(i));
+                                }
+                        }
+                }
+        } else {
+                // Persons are only ever written by the thread that owns them.
+                #pragma omp parallel for num_threads(m_num_threads) schedule(static, 1) reduction(+:num_may_infect,num_infectious)
+                for (unsigned int part = 0; part < m_partition.GetNumPartitions(); part++) {
+                        for (const auto i : m_partition.GetPersons(part)) {
+                                population[i].Update();
+                                num_may_infect += population[i].GetHealth().MayInfect();
+                                num_infectious += population[i].GetHealth().IsInfectious();
+                        }
+                }
+        }
+        if ( !m_pathogens.empty() ) {
+                const auto counts = m_pathogens.Update();
+                num_infectious += counts.first;
+                num_may_infect += counts.second;
+        }
 
-        for (auto& p : *m_population) {
-                p.Update(is_work_off, is_school_off);
+        // Without infectious persons there are no transmissions, and health only changes
+        // between infected and recovered, which the sort of the cluster members does not
+        // tell apart. Two such days in a row then leave the member order at a fixed point
+        // of the sort: from the third day on, the cluster pass changes nothing and is
+        // skipped. Logged contacts need the pass every day.
+        // Once no one is or will become infectious, the epidemic is over.
+        m_days_not_infectious = (num_infectious == 0U) ? m_days_not_infectious + 1U : 0U;
+        const bool skip_clusters = (m_days_not_infectious > 2U) && (m_log_level != LogMode::Contacts);
+        m_extinct = (num_may_infect == 0U) && (m_log_level != LogMode::Contacts);
+        if (m_extinct) {
+                for (size_t i = 0; i < population.size(); i++) {
+                        if (population[i].GetHealth().IsInfected()) {
+                                m_infected.push_back(i);
+                        }
+                }
+                m_engine_days.push_back('-');
+                m_calendar->AdvanceDay();
+                return;
+        }
+
+        // A sparse pass starts from all clusters, unless the marks are up to date.
+        const bool sparse = !skip_clusters && IsSparseDay();
+        if (sparse && !m_active_clusters.IsValid()) {
+                m_active_clusters.MarkAll();
         }
+        size_t num_visited = m_households.size() + m_school_clusters.size() + m_work_clusters.size()
+                + m_primary_community.size() + m_secondary_community.size();
+        const auto start = chrono::steady_clock::now();
 
-        if (m_track_index_case) {
+        if (skip_clusters) {
+                // Only the disease clocks and the calendar advance.
+        } else if (sparse) {
+                switch (m_log_level) {
+                        case LogMode::Transmissions:
+                                num_visited = m_track_index_case ? UpdateActiveClusters<LogMode::Transmissions, true>(is_work_off, is_school_off)
+                                        : UpdateActiveClusters<LogMode::Transmissions, false>(is_work_off, is_school_off); break;
+                        case LogMode::None:
+                                num_visited = m_track_index_case ? UpdateActiveClusters<LogMode::None, true>(is_work_off, is_school_off)
+                                        : UpdateActiveClusters<LogMode::None, false>(is_work_off, is_school_off); break;
+                        default:
+                                throw runtime_error(std::string(__func__) + "Log mode screwed up!");
+                }
+        } else if (!m_partition.IsEmpty()) {
                 switch (m_log_level) {
                         case LogMode::Contacts:
-                                UpdateClusters<LogMode::Contacts, true>(); break;
+                                m_track_index_case ? UpdateClustersPartitioned<LogMode::Contacts, true>(is_work_off, is_school_off)
+                                        : UpdateClustersPartitioned<LogMode::Contacts, false>(is_work_off, is_school_off); break;
                         case LogMode::Transmissions:
-                                UpdateClusters<LogMode::Transmissions, true>(); break;
+                                m_track_index_case ? UpdateClustersPartitioned<LogMode::Transmissions, true>(is_work_off, is_school_off)
+                                        : UpdateClustersPartitioned<LogMode::Transmissions, false>(is_work_off, is_school_off); break;
                         case LogMode::None:
-                                UpdateClusters<LogMode::None, true>(); break;
+                                m_track_index_case ? UpdateClustersPartitioned<LogMode::None, true>(is_work_off, is_school_off)
+                                        : UpdateClustersPartitioned<LogMode::None, false>(is_work_off, is_school_off); break;
+                        default:
+                                throw runtime_error(std::string(__func__) + "Log mode screwed up!");
+                }
+        } else if (m_track_index_case) {
+                switch (m_log_level) {
+                        case LogMode::Contacts:
+                                UpdateClusters<LogMode::Contacts, true>(is_work_off, is_school_off); break;
+                        case LogMode::Transmissions:
+                                UpdateClusters<LogMode::Transmissions, true>(is_work_off, is_school_off); break;
+                        case LogMode::None:
+                                UpdateClusters<LogMode::None, true>(is_work_off, is_school_off); break;
                         default:
                                 throw runtime_error(std::string(__func__) + "Log mode screwed up!");
                 }
         } else {
                 switch (m_log_level) {
                         case LogMode::Contacts:
-                                UpdateClusters<LogMode::Contacts, false>(); break;
+                                UpdateClusters<LogMode::Contacts, false>(is_work_off, is_school_off); break;
                         case LogMode::Transmissions:
-                                UpdateClusters<LogMode::Transmissions, false>();  break;
+                                UpdateClusters<LogMode::Transmissions, false>(is_work_off, is_school_off);  break;
                         case LogMode::None:
-                                UpdateClusters<LogMode::None, false>(); break;
+                                UpdateClusters<LogMode::None, false>(is_work_off, is_school_off); break;
                         default:
                                 throw runtime_error(std::string(__func__) + "Log mode screwed up!");
                 }
         }
 
+        // What the pass cost, per visited cluster.
+        if (skip_clusters) {
+                m_engine_days.push_back('-');
+        } else {
+                const chrono::duration<double> seconds = chrono::steady_clock::now() - start;
+                // After a dense pass, the clusters a sparse one has to visit follow from the clusters
+                // and persons, so the adaptive engine can switch without a visit of all clusters.
+                if ( !sparse && m_cluster_engine == ClusterEngine::Adaptive && m_partition.IsEmpty()
+                        && m_log_level != LogMode::Contacts) {
+                        m_active_clusters.MarkVisited(population, { { &m_households, &m_school_clusters,
+                                &m_work_clusters, &m_primary_community, &m_secondary_community } });
+                } else if ( !sparse ) {
+                        m_active_clusters.Invalidate();
+                }
+                if (num_visited > 0U) {
+                        m_pass_cost[sparse] = max(seconds.count() / num_visited, 1.0e-12);
+                        m_pass_day[sparse]  = m_engine_days.size();
+                }
+                m_engine_days.push_back(sparse ? 's' : 'd');
+        }
+
         m_calendar->AdvanceDay();
 }
 } // end_of_namespace
@@ -20,12 +20,22 @@
  * Header for the Simulator class.
  */
 
+#include "core/AgeMixing.h"
 #include "core/Cluster.h"
 #include "core/DiseaseProfile.h"
+#include "core/InfectionMailbox.h"
 #include "core/LogMode.h"
+#include "core/MeanFieldRule.h"
+#include "core/PathogenTrack.h"
 #include "core/RngHandler.h"
+#include "sim/ActiveClusters.h"
+#include "sim/Partition.h"
+#include "util/NumaAllocator.h"
 
 #include <boost/property_tree/ptree.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -34,6 +44,7 @@ namespace stride {
 
 class Population;
 class Calendar;
+class DaysOffInterface;
 
 /**
  * Main class that contains and direct the virtual world.
@@ -41,31 +52,90 @@ class Calendar;
 class Simulator
 {
 public:
+        /// Engine of the cluster pass (run.cluster_engine): a visit of every cluster, a visit
+        /// of the active clusters only (see ActiveClusters), or each day the one expected to
+        /// be cheaper, from the active clusters and what the pass cost on earlier days.
+        enum class ClusterEngine { Dense, Sparse, Adaptive };
+
         // Default constructor for empty Simulator.
         Simulator();
 
         /// Get the population.
         const std::shared_ptr<const Population> GetPopulation() const;
 
+        /// Number of pathogens (run.disease_config_file may list several); the first one is in
+        /// the health of the persons of the population.
+        std::size_t GetNumPathogens() const { return 1U + m_pathogens.size(); }
+
+        /// Number of persons infected, now or before, with the given pathogen.
+        unsigned int GetInfectedCount(std::size_t pathogen) const;
+
         /// Change track_index_case setting.
         void SetTrackIndexCase(bool track_index_case);
 
+        /// Get the partition of persons and clusters over threads (empty if not partitioned).
+        const Partition& GetPartition() const { return m_partition; }
+
+        /// Get the cpu each thread is pinned to (-1 if not pinned).
+        const std::vector<int>& GetThreadCpus() const { return m_thread_cpus; }
+
+        /// Get the rule for computing transmission in a cluster as a whole (run.mean_field_min_size
+        /// and run.mean_field_min_prevalence).
+        const MeanFieldRule& GetMeanFieldRule() const { return m_mean_field; }
+
+        /// Get the age-structured mixing within clusters (run.age_mixing), nullptr for uniform mixing.
+        const AgeMixing* GetAgeMixing() const { return m_age_mixing.get(); }
+
+        /// Number of cluster updates, per cluster type, that computed transmission as a whole.
+        const std::array<std::size_t, NumOfClusterTypes()>& GetNumMeanField() const { return m_num_mean_field; }
+
+        /// Get the engine of the cluster pass.
+        ClusterEngine GetClusterEngine() const { return m_cluster_engine; }
+
+        /// Engine of the cluster pass of each day this simulator ran: 'd' (dense), 's' (sparse)
+        /// or '-' (no pass). With one thread, the engines have the same outcome.
+        const std::string& GetEngineDays() const { return m_engine_days; }
+
+        /// Is the epidemic over? True once no one is or will become infectious (and contacts
+        /// are not logged): later time steps do not change the number of cases and only
+        /// advance the disease of the persons still infected, and the calendar.
+        bool IsExtinct() const { return m_extinct; }
+
         /// Run one time step, computing full simulation (default) or only index case.
         void TimeStep();
 
 private:
-        /// Update the contacts in the given clusters.
+        /// Update the contacts in the given clusters, given today's days off.
+	template<LogMode log_level, bool track_index_case = false>
+        void UpdateClusters(bool is_work_off, bool is_school_off);
+
+        /// Update the contacts in the given clusters, each partition processing the clusters it owns.
+	template<LogMode log_level, bool track_index_case = false>
+        void UpdateClustersPartitioned(bool is_work_off, bool is_school_off);
+
+        /// Update the contacts in the active clusters only; returns the number of clusters visited.
 	template<LogMode log_level, bool track_index_case = false>
-        void UpdateClusters();
+        std::size_t UpdateActiveClusters(bool is_work_off, bool is_school_off);
+
+        /// Should today's cluster pass be sparse?
+        bool IsSparseDay();
+
+        /// Set the health of a person (by position in the population) between time steps,
+        /// keeping the sparse pass and the end of epidemic check in line with it.
+        void SetHealth(std::size_t person, const Health& health);
 
 private:
 	boost::property_tree::ptree         m_config_pt;            ///< Configuration property tree.
 
 private:
 	unsigned int                        m_num_threads;          ///< The number of (OpenMP) threads.
+	std::vector<int>                    m_thread_cpus;          ///< Cpu each thread is pinned to (-1 if not pinned).
+	std::shared_ptr<const util::Storage> m_storage;            ///< Where persons and cluster members are kept.
     std::vector<RngHandler>             m_rng_handler;          ///< Pointer to the RngHandlers.
+    unsigned int                        m_rng_handler_seed;     ///< Seed the RngHandlers were split from.
     LogMode                             m_log_level;            ///< Specifies logging mode.
     std::shared_ptr<Calendar>           m_calendar;             ///< Management of calendar.
+    std::shared_ptr<DaysOffInterface>   m_days_off;             ///< Days off work and school.
 
 private:
     std::shared_ptr<Population>         m_population;           ///< Pointer to the Population.
@@ -77,11 +147,35 @@ private:
 	std::vector<Cluster>                m_secondary_community;  ///< Container with secondary community  Clusters.
 
 	DiseaseProfile                      m_disease_profile;      ///< Profile of disease.
+	MeanFieldRule                       m_mean_field;           ///< When to compute transmission per cluster.
+	std::array<std::size_t, NumOfClusterTypes()> m_num_mean_field; ///< Cluster updates that did, per type.
+	std::shared_ptr<const AgeMixing>    m_age_mixing;           ///< Age-structured mixing (if any).
+	PathogenTracks                      m_pathogens;            ///< The pathogens after the first one.
 
 	bool                                m_track_index_case;     ///< General simulation or tracking index case.
+	unsigned int                        m_days_not_infectious;  ///< Consecutive days without infectious persons.
+	bool                                m_extinct;              ///< No one is or will become infectious.
+	std::vector<std::size_t>            m_infected;             ///< Persons still infected once extinct.
+
+	Partition                           m_partition;            ///< Ownership of persons and clusters by thread.
+	std::vector<InfectionMailbox>       m_mailboxes;            ///< Infections across partitions, one per partition.
+
+	ClusterEngine                       m_cluster_engine;       ///< Engine of the cluster pass.
+	ActiveClusters                      m_active_clusters;      ///< Clusters for the sparse pass.
+	std::vector<std::uint32_t>          m_infectious;           ///< Infectious persons, for the sparse pass.
+	std::array<double, 2>               m_pass_cost;            ///< Seconds per cluster visit, dense and sparse (0: unknown).
+	std::array<std::size_t, 2>          m_pass_day;             ///< Day of the last dense and sparse pass.
+	std::string                         m_engine_days;          ///< Engine of the cluster pass, by day.
 
 private:
+	friend class DistributedSimulator;
+	friend class IndexCaseTrials;
+	friend class LockstepEnsemble;
+	friend class MemoryPlacement;
+	friend class Metapopulation;
 	friend class SimulatorBuilder;
+	friend class SimulatorCheckpoint;
+	friend class SimulatorSnapshot;
 };
 
 } // end_of_namespace
@@ -20,22 +20,40 @@
 
 #include "SimulatorBuilder.h"
 
+#include "MemoryPlacement.h"
+#include "SimulatorSnapshot.h"
 #include "calendar/Calendar.h"
+#include "calendar/DaysOffFactory.h"
+#include "core/AgeMixing.h"
 #include "core/Cluster.h"
 #include "core/ClusterType.h"
+#include "core/ContactMatrixReader.h"
 #include "core/ContactProfile.h"
 #include "core/Infector.h"
 #include "core/LogMode.h"
+#include "core/PathogenTrack.h"
+#include "pop/Age.h"
 #include "pop/Population.h"
 #include "pop/PopulationBuilder.h"
+#include "util/Fingerprint.h"
 #include "util/InstallDirs.h"
+#include "util/NumaAllocator.h"
+#include "util/StringUtils.h"
+#include "util/ThreadPinning.h"
 
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/xml_parser.hpp>
 #include <omp.h>
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <iostream>
 #include <memory>
+#include <numeric>
 #include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace stride {
 
@@ -63,7 +81,37 @@ shared_ptr<Simulator> SimulatorBuilder::Build(const string& config_file_name,
 shared_ptr<Simulator> SimulatorBuilder::Build(const ptree& pt_config,
         unsigned int num_threads, bool track_index_case)
 {
-        // Disease file.
+        // The simulator of the first pathogen, which the others then join.
+        const auto pathogens = GetPathogenConfigs(pt_config);
+        auto sim = BuildFirstPathogen(pathogens.front(), num_threads, track_index_case);
+        InitializePathogens(sim, pathogens);
+        return sim;
+}
+
+vector<ptree> SimulatorBuilder::GetPathogenConfigs(const ptree& pt_config)
+{
+        const auto disease_files = StringUtils::Split(pt_config.get<string>("run.disease_config_file"), ",");
+        if (disease_files.empty()) {
+                throw runtime_error(string(__func__) + "> No disease_config_file.");
+        }
+        vector<ptree> pathogens(disease_files.size(), pt_config);
+        for (size_t k = 0; k < pathogens.size(); k++) {
+                pathogens[k].put("run.disease_config_file", StringUtils::Trim(disease_files[k]));
+        }
+        for (const string key : { "run.r0", "run.seeding_rate", "run.immunity_rate" }) {
+                const auto values = StringUtils::Split(pt_config.get<string>(key), ",");
+                if (values.size() != 1U && values.size() != pathogens.size()) {
+                        throw runtime_error(string(__func__) + "> " + key + " needs one value, or one per disease_config_file.");
+                }
+                for (size_t k = 0; k < pathogens.size(); k++) {
+                        pathogens[k].put(key, StringUtils::Trim(values[values.size() == 1U ? 0U : k]));
+                }
+        }
+        return pathogens;
+}
+
+ptree SimulatorBuilder::ReadDisease(const ptree& pt_config)
+{
         ptree pt_disease;
         const auto file_name_d { pt_config.get<string>("run.disease_config_file") };
         const auto file_path_d { InstallDirs::GetDataDir() /= file_name_d };
@@ -71,22 +119,203 @@ shared_ptr<Simulator> SimulatorBuilder::Build(const ptree& pt_config,
                 throw runtime_error(std::string(__func__)  + "> No file " + file_path_d.string());
         }
         read_xml(file_path_d.string(), pt_disease);
+        return pt_disease;
+}
 
-        // Contact file.
-        ptree pt_contact;
-        const auto file_name_c { pt_config.get("run.age_contact_matrix_file", "contact_matrix.xml") };
-        const auto file_path_c { InstallDirs::GetDataDir() /= file_name_c };
-        if ( !is_regular_file(file_path_c) ) {
-                throw runtime_error(string(__func__)  + "> No file " + file_path_c.string());
+shared_ptr<Simulator> SimulatorBuilder::BuildFirstPathogen(const ptree& pt_config,
+        unsigned int num_threads, bool track_index_case)
+{
+        // Disease file.
+        const ptree pt_disease = ReadDisease(pt_config);
+
+        // Snapshot of an earlier build from the same inputs (if so configured).
+        const auto snapshot_dir    = pt_config.get<string>("run.snapshot_dir", "");
+        const bool snapshot_shared = pt_config.get<bool>("run.snapshot_shared", false);
+        boost::filesystem::path snapshot_path;
+        uint64_t snapshot_key = 0U;
+        if ( !snapshot_dir.empty() ) {
+                snapshot_key  = SimulatorSnapshot::GetKey(pt_config);
+                snapshot_path = SimulatorSnapshot::GetPath(absolute(snapshot_dir, InstallDirs::GetCurrentDir()), snapshot_key);
+                auto sim = Initialize(pt_config, pt_disease, num_threads, track_index_case);
+                if (SimulatorSnapshot::Load(*sim, snapshot_path, snapshot_key, snapshot_shared)) {
+                        InitializeAgeMixing(sim);
+                        InitializeRngHandlers(sim);
+                        InitializeLayout(sim);
+                        return sim;
+                }
+        }
+
+        // Contact matrices.
+        const auto contact_matrices = ContactMatrixReader::Read(pt_config);
+
+        // Build and, if so configured, snapshot for later runs. The snapshot is taken before the
+        // layout, so the persons it stores are in file order whatever the partitioning and threads.
+        auto sim = Build(pt_config, pt_disease, contact_matrices, nullptr, num_threads, track_index_case,
+                snapshot_path.empty());
+        if ( !snapshot_path.empty() ) {
+                create_directories(snapshot_path.parent_path());
+                SimulatorSnapshot::Save(*sim, snapshot_path, snapshot_key);
+
+                // Continue with the persons shared with the other runs that load the snapshot.
+                if (snapshot_shared) {
+                        auto shared_sim = Initialize(pt_config, pt_disease, num_threads, track_index_case);
+                        if (SimulatorSnapshot::Load(*shared_sim, snapshot_path, snapshot_key, true)) {
+                                shared_sim->m_age_mixing = sim->m_age_mixing;
+                                InitializeRngHandlers(shared_sim);
+                                InitializeLayout(shared_sim);
+                                return shared_sim;
+                        }
+                }
+                InitializeLayout(sim);
         }
-        read_xml(file_path_c.string(), pt_contact);
 
         // Done.
-        return Build(pt_config, pt_disease, pt_contact, num_threads, track_index_case);
+        return sim;
 }
 
 shared_ptr<Simulator> SimulatorBuilder::Build(const ptree& pt_config,
         const ptree& pt_disease, const ptree& pt_contact, unsigned int number_of_threads, bool track_index_case)
+{
+        return Build(pt_config, pt_disease, ContactMatrixReader::ReadXml(pt_contact), number_of_threads, track_index_case);
+}
+
+shared_ptr<Simulator> SimulatorBuilder::Build(const ptree& pt_config,
+        const ptree& pt_disease, const ContactMatrices& contact_matrices, unsigned int number_of_threads, bool track_index_case)
+{
+        return Build(pt_config, pt_disease, contact_matrices, nullptr, number_of_threads, track_index_case, true);
+}
+
+shared_ptr<Simulator> SimulatorBuilder::Build(const ptree& pt_config,
+        const ptree& pt_disease, const ContactMatrices& contact_matrices, istream& pop_stream,
+        unsigned int number_of_threads, bool track_index_case)
+{
+        return Build(pt_config, pt_disease, contact_matrices, [&](Random& rng,
+                shared_ptr<const Storage> storage) { return PopulationBuilder::Build(pt_config, pt_disease, pop_stream, rng, storage); },
+                number_of_threads, track_index_case, true);
+}
+
+shared_ptr<Simulator> SimulatorBuilder::Build(const ptree& pt_config,
+        const ptree& pt_disease, const ContactMatrices& contact_matrices, const PopulationBuilder::RecordSource& records,
+        unsigned int number_of_threads, bool track_index_case)
+{
+        return Build(pt_config, pt_disease, contact_matrices, [&](Random& rng,
+                shared_ptr<const Storage> storage) { return PopulationBuilder::Build(pt_config, pt_disease, records, rng, storage); },
+                number_of_threads, track_index_case, true);
+}
+
+boost::filesystem::path SimulatorBuilder::Snapshot(const ptree& pt_config,
+        const ptree& pt_disease, const ContactMatrices& contact_matrices, istream& pop_stream,
+        unsigned int number_of_threads)
+{
+        return Snapshot(pt_config, pt_disease, contact_matrices, [&](Random& rng,
+                shared_ptr<const Storage> storage) { return PopulationBuilder::Build(pt_config, pt_disease, pop_stream, rng, storage); },
+                number_of_threads);
+}
+
+boost::filesystem::path SimulatorBuilder::Snapshot(const ptree& pt_config,
+        const ptree& pt_disease, const ContactMatrices& contact_matrices, const PopulationBuilder::RecordSource& records,
+        unsigned int number_of_threads)
+{
+        return Snapshot(pt_config, pt_disease, contact_matrices, [&](Random& rng,
+                shared_ptr<const Storage> storage) { return PopulationBuilder::Build(pt_config, pt_disease, records, rng, storage); },
+                number_of_threads);
+}
+
+boost::filesystem::path SimulatorBuilder::Snapshot(const ptree& pt_config,
+        const ptree& pt_disease, const ContactMatrices& contact_matrices, const PopulationFactory& population,
+        unsigned int number_of_threads)
+{
+        const auto snapshot_dir = pt_config.get<string>("run.snapshot_dir", "");
+        if (snapshot_dir.empty()) {
+                throw runtime_error(string(__func__) + "> No run.snapshot_dir in the config.");
+        }
+        const auto sim  = Build(pt_config, pt_disease, contact_matrices, population, number_of_threads, false, false);
+        const auto key  = SimulatorSnapshot::GetKey(pt_config);
+        const auto path = SimulatorSnapshot::GetPath(absolute(snapshot_dir, InstallDirs::GetCurrentDir()), key);
+        create_directories(path.parent_path());
+        SimulatorSnapshot::Save(*sim, path, key);
+        return path;
+}
+
+shared_ptr<Simulator> SimulatorBuilder::Build(const ptree& pt_config,
+        const ptree& pt_disease, const ContactMatrices& contact_matrices, const PopulationFactory& population,
+        unsigned int number_of_threads, bool track_index_case, bool layout)
+{
+        auto sim = Initialize(pt_config, pt_disease, number_of_threads, track_index_case);
+
+        // Rng's.
+        const auto seed = pt_config.get<double>("run.rng_seed");
+        Random rng(seed);
+
+        // Build population, from the configured file unless another source is given.
+        sim->m_population = population ? population(rng, sim->m_storage)
+                : PopulationBuilder::Build(pt_config, pt_disease, rng, sim->m_storage);
+
+        // Initialize clusters.
+        InitializeClusters(sim);
+
+        // Initialize Rng handlers
+        sim->m_rng_handler_seed = rng(numeric_limits<unsigned int>::max());
+        InitializeRngHandlers(sim);
+
+        // Ownership of persons and clusters.
+        if (layout) {
+                InitializeLayout(sim);
+        }
+
+        // Initialize contact profiles.
+        for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+                Cluster::AddContactProfile(static_cast<ClusterType>(t), ContactProfile(contact_matrices[t]));
+        }
+        InitializeAgeMixing(sim, &contact_matrices);
+
+        // Done.
+        return sim;
+}
+
+shared_ptr<Simulator> SimulatorBuilder::Build(const Simulator& model, const ptree& pt_config,
+        const ptree& pt_disease, unsigned int number_of_threads, bool track_index_case)
+{
+        if ( !model.m_population ) {
+                throw runtime_error(string(__func__) + "> Model simulator has no population.");
+        }
+        auto sim = Initialize(pt_config, pt_disease, number_of_threads, track_index_case);
+
+        // Rng's.
+        const auto seed = pt_config.get<double>("run.rng_seed");
+        Random rng(seed);
+
+        // Copy the model's persons and clusters, then draw the health of the persons.
+        sim->m_population = make_shared<Population>(*model.m_population, Population::allocator_type(sim->m_storage));
+        PopulationBuilder::Reseed(pt_config, pt_disease, *sim->m_population, rng);
+        vector<Cluster>(model.m_households).swap(sim->m_households);
+        vector<Cluster>(model.m_school_clusters).swap(sim->m_school_clusters);
+        vector<Cluster>(model.m_work_clusters).swap(sim->m_work_clusters);
+        vector<Cluster>(model.m_primary_community).swap(sim->m_primary_community);
+        vector<Cluster>(model.m_secondary_community).swap(sim->m_secondary_community);
+        for (auto clusters : { &sim->m_households, &sim->m_school_clusters, &sim->m_work_clusters,
+                        &sim->m_primary_community, &sim->m_secondary_community }) {
+                MemoryPlacement::Rebase(*clusters, model.m_population->data(), sim->m_population->data());
+        }
+        if (model.m_age_mixing && pt_config.get<unsigned int>("run.age_bin_width", 5U)
+                        == model.m_config_pt.get<unsigned int>("run.age_bin_width", 5U)) {
+                sim->m_age_mixing = model.m_age_mixing;
+        }
+        InitializeAgeMixing(sim);
+
+        // Initialize Rng handlers
+        sim->m_rng_handler_seed = rng(numeric_limits<unsigned int>::max());
+        InitializeRngHandlers(sim);
+
+        // Ownership of persons and clusters.
+        InitializeLayout(sim);
+
+        // Done.
+        return sim;
+}
+
+shared_ptr<Simulator> SimulatorBuilder::Initialize(const ptree& pt_config,
+        const ptree& pt_disease, unsigned int number_of_threads, bool track_index_case)
 {
         auto sim = make_shared<Simulator>();
 
@@ -96,110 +325,219 @@ shared_ptr<Simulator> SimulatorBuilder::Build(const ptree& pt_config,
         // Initialize track_index_case policy
         sim->m_track_index_case = track_index_case;
 
-        // Initialize number of threads.
+        // Initialize number of threads and their pinning.
         sim->m_num_threads = number_of_threads;
+        sim->m_thread_cpus = ThreadPinning::Pin(pt_config.get<string>("run.thread_pinning", "none"), number_of_threads);
+
+        // Storage of large arrays: in memory or mapped from files.
+        const auto storage = make_shared<Storage>();
+        storage->huge_pages = pt_config.get<bool>("run.huge_pages", false);
+        const auto storage_mode = pt_config.get<string>("run.storage", "memory");
+        if (storage_mode == "mapped") {
+                const auto storage_dir = absolute(pt_config.get<string>("run.storage_dir", "."), InstallDirs::GetCurrentDir());
+                create_directories(storage_dir);
+                storage->dir        = storage_dir.string();
+                storage->map_random = pt_config.get<bool>("run.storage_map_persons", false);
+        } else if (storage_mode != "memory") {
+                throw runtime_error(string(__func__) + "> Invalid input for storage: " + storage_mode);
+        }
+        sim->m_storage = storage;
 
         // Initialize calendar.
         sim->m_calendar = make_shared<Calendar>(pt_config);
+        sim->m_days_off = DaysOffFactory::Create(pt_config.get<string>("run.days_off", "Standard"), sim->m_calendar);
 
         // Get log level.
         const string l = pt_config.get<string>("run.log_level", "None");
         sim->m_log_level = IsLogMode(l) ? ToLogMode(l) : throw runtime_error(string(__func__) + "> Invalid input for LogMode.");
 
-        // Rng's.
-        const auto seed = pt_config.get<double>("run.rng_seed");
-        Random rng(seed);
-
-        // Build population.
-        sim->m_population = PopulationBuilder::Build(pt_config, pt_disease, rng);
-
-        // Initialize clusters.
-        InitializeClusters(sim);
-
         // Initialize disease profile.
         sim->m_disease_profile.Initialize(pt_config, pt_disease);
 
-        // Initialize Rng handlers
-        unsigned int new_seed = rng(numeric_limits<unsigned int>::max());
-        for (size_t i = 0; i < sim->m_num_threads; i++) {
-                sim->m_rng_handler.emplace_back(RngHandler(new_seed, sim->m_num_threads, i));
+        // Transmission from the force of infection of a cluster as a whole (if so configured).
+        sim->m_mean_field = MeanFieldRule(pt_config.get<size_t>("run.mean_field_min_size", 0U),
+                pt_config.get<double>("run.mean_field_min_prevalence", 0.0));
+
+        // Engine of the cluster pass: every cluster, the active ones only, or the cheaper of the two.
+        const auto engine = pt_config.get<string>("run.cluster_engine", "dense");
+        if (engine == "dense") {
+                sim->m_cluster_engine = Simulator::ClusterEngine::Dense;
+        } else if (engine == "sparse") {
+                sim->m_cluster_engine = Simulator::ClusterEngine::Sparse;
+        } else if (engine == "adaptive") {
+                sim->m_cluster_engine = Simulator::ClusterEngine::Adaptive;
+        } else {
+                throw runtime_error(string(__func__) + "> Invalid input for cluster_engine: " + engine);
         }
 
-        // Initialize contact profiles.
-        Cluster::AddContactProfile(ClusterType::Household,     ContactProfile(ClusterType::Household, pt_contact));
-        Cluster::AddContactProfile(ClusterType::School,        ContactProfile(ClusterType::School, pt_contact));
-        Cluster::AddContactProfile(ClusterType::Work,          ContactProfile(ClusterType::Work, pt_contact));
-        Cluster::AddContactProfile(ClusterType::PrimaryCommunity,  ContactProfile(ClusterType::PrimaryCommunity, pt_contact));
-        Cluster::AddContactProfile(ClusterType::SecondaryCommunity,   ContactProfile(ClusterType::SecondaryCommunity, pt_contact));
+        // Mixing within clusters: uniform, or by age from the contact matrices (set up with the clusters).
+        const auto mixing = pt_config.get<string>("run.age_mixing", "uniform");
+        if (mixing != "uniform" && mixing != "matrix") {
+                throw runtime_error(string(__func__) + "> Invalid input for age_mixing: " + mixing);
+        }
+        if (mixing == "matrix" && sim->m_mean_field.IsEnabled()) {
+                throw runtime_error(string(__func__) + "> age_mixing matrix already draws from a force of infection"
+                        " per age group: it does not combine with mean_field_min_size.");
+        }
 
         // Done.
         return sim;
 }
 
-void SimulatorBuilder::InitializeClusters(shared_ptr<Simulator> sim)
+void SimulatorBuilder::InitializeAgeMixing(shared_ptr<Simulator> sim, const ContactMatrices* contact_matrices)
 {
-	// Determine number of clusters.
-	unsigned int max_id_households           = 0U;
-	unsigned int max_id_school_clusters      = 0U;
-	unsigned int max_id_work_clusters        = 0U;
-	unsigned int max_id_primary_community    = 0U;
-	unsigned int max_id_secondary_community  = 0U;
-	Population& population                   = *sim->m_population;
-
-	for (const auto& p : population) {
-		max_id_households            = std::max(max_id_households,          p.GetClusterId(ClusterType::Household));
-		max_id_school_clusters       = std::max(max_id_school_clusters,     p.GetClusterId(ClusterType::School));
-		max_id_work_clusters         = std::max(max_id_work_clusters,       p.GetClusterId(ClusterType::Work));
-		max_id_primary_community     = std::max(max_id_primary_community,   p.GetClusterId(ClusterType::PrimaryCommunity));
-		max_id_secondary_community   = std::max(max_id_secondary_community, p.GetClusterId(ClusterType::SecondaryCommunity));
+        if (sim->m_config_pt.get<string>("run.age_mixing", "uniform") != "matrix") {
+                sim->m_age_mixing = nullptr;
+        } else if ( !sim->m_age_mixing || contact_matrices != nullptr ) {
+                vector<double> population_ages(MaximumAge() + 1U, 0.0);
+                for (const auto& p : *sim->m_population) {
+                        ++population_ages[EffectiveAge(p.GetAge())];
+                }
+                const auto bin_width = sim->m_config_pt.get<unsigned int>("run.age_bin_width", 5U);
+                sim->m_age_mixing = make_shared<const AgeMixing>(contact_matrices ? *contact_matrices
+                        : ContactMatrixReader::Read(sim->m_config_pt), population_ages, bin_width);
+        }
+}
 
-	}
+void SimulatorBuilder::InitializeRngHandlers(shared_ptr<Simulator> sim)
+{
+        sim->m_rng_handler.clear();
+        for (size_t i = 0; i < sim->m_num_threads; i++) {
+                sim->m_rng_handler.emplace_back(RngHandler(sim->m_rng_handler_seed, sim->m_num_threads, i));
+        }
+}
 
-	// Keep separate id counter to provide a unique id for every cluster.
-	unsigned int cluster_id = 1;
+void SimulatorBuilder::InitializePathogens(shared_ptr<Simulator> sim, const vector<ptree>& pathogens)
+{
+        sim->m_pathogens = PathogenTracks();
+        if (pathogens.size() <= 1U) {
+                return;
+        }
+        if (pathogens.size() > 32U) {
+                throw runtime_error(string(__func__) + "> At most 32 pathogens in disease_config_file.");
+        }
+        if (sim->m_cluster_engine != Simulator::ClusterEngine::Dense || sim->m_age_mixing
+                || sim->m_mean_field.IsEnabled() || !sim->m_partition.IsEmpty()
+                || sim->m_log_level == LogMode::Transmissions) {
+                throw runtime_error(string(__func__) + "> Several pathogens in disease_config_file need the dense"
+                        " cluster engine, uniform mixing without mean field, no partitioning and no transmission log.");
+        }
 
-	for (size_t i = 0; i <= max_id_households; i++) {
-		sim->m_households.emplace_back(Cluster(cluster_id, ClusterType::Household));
-		cluster_id++;
-	}
-	for (size_t i = 0; i <= max_id_school_clusters; i++) {
-		sim->m_school_clusters.emplace_back(Cluster(cluster_id, ClusterType::School));
-		cluster_id++;
-	}
-	for (size_t i = 0; i <= max_id_work_clusters; i++) {
-		sim->m_work_clusters.emplace_back(Cluster(cluster_id, ClusterType::Work));
-		cluster_id++;
-	}
-	for (size_t i = 0; i <= max_id_primary_community; i++) {
-		sim->m_primary_community.emplace_back(Cluster(cluster_id, ClusterType::PrimaryCommunity));
-		cluster_id++;
-	}
-	for (size_t i = 0; i <= max_id_secondary_community; i++) {
-		sim->m_secondary_community.emplace_back(Cluster(cluster_id, ClusterType::SecondaryCommunity));
-		cluster_id++;
-	}
+        const auto seed = pathogens.front().get<unsigned long>("run.rng_seed");
+        const size_t num_persons = sim->m_population->size();
+        for (size_t k = 1; k < pathogens.size(); k++) {
+                const ptree& pt_config = pathogens[k];
+                const ptree pt_disease = ReadDisease(pt_config);
 
-	// Cluster id '0' means "not present in any cluster of that type".
-	for (auto& p: population) {
-	        const auto hh_id = p.GetClusterId(ClusterType::Household);
-		if (hh_id > 0) {
-		        sim->m_households[hh_id].AddPerson(&p);
-		}
-		const auto sc_id = p.GetClusterId(ClusterType::School);
-		if (sc_id > 0) {
-				sim->m_school_clusters[sc_id].AddPerson(&p);
+                // A random stream of its own, for the health of the persons and the transmissions.
+                const uint64_t key[2] = { seed, k };
+                Random rng(Fingerprint::Hash(key, sizeof(key)));
+
+                PathogenTrack track;
+                track.disease_profile.Initialize(pt_config, pt_disease);
+                track.health = PopulationBuilder::DrawHealth(pt_config, pt_disease, num_persons, rng);
+                const auto handler_seed = rng(numeric_limits<unsigned int>::max());
+                for (size_t i = 0; i < sim->m_num_threads; i++) {
+                        track.rng_handler.emplace_back(RngHandler(handler_seed, sim->m_num_threads, i));
+                }
+                sim->m_pathogens.tracks.push_back(move(track));
+        }
+}
+
+void SimulatorBuilder::InitializeLayout(shared_ptr<Simulator> sim)
+{
+        const array<vector<Cluster>*, NumOfClusterTypes()> clusters { { &sim->m_households,
+                &sim->m_school_clusters, &sim->m_work_clusters, &sim->m_primary_community, &sim->m_secondary_community } };
+        const auto mode = sim->m_config_pt.get<string>("run.partitioning", "none");
+        sim->m_partition = Partition();
+        sim->m_mailboxes.clear();
+        if (mode == "graph") {
+                sim->m_partition = Partition(*sim->m_population,
+                        { { clusters[0], clusters[1], clusters[2], clusters[3], clusters[4] } }, sim->m_num_threads);
+        } else if (mode != "none") {
+                throw runtime_error(string(__func__) + "> Invalid input for partitioning: " + mode);
+        }
+
+        // Place persons and clusters with the threads that use them; persons shared with
+        // other processes (run.snapshot_shared) stay where they are mapped.
+        const bool shared = sim->m_config_pt.get<bool>("run.snapshot_shared", false)
+                && !sim->m_config_pt.get<string>("run.snapshot_dir", "").empty();
+        if ( !shared ) {
+                MemoryPlacement::Apply(*sim);
+        }
+
+        // File-backed storage: the members of each cluster type in one block, in the order
+        // the daily cluster pass (or each partition's part of it) goes through them.
+        if ( !sim->m_storage->dir.empty() ) {
+                for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+                        vector<size_t> order;
+                        if (sim->m_partition.IsEmpty()) {
+                                order.resize(clusters[t]->size());
+                                iota(order.begin(), order.end(), 0U);
+                        } else {
+                                for (unsigned int i = 0; i < sim->m_num_threads; i++) {
+                                        const auto& owned = sim->m_partition.GetClusters(i, static_cast<ClusterType>(t));
+                                        order.insert(order.end(), owned.begin(), owned.end());
+                                }
+                        }
+                        Cluster::CompactMembers(*clusters[t], order, sim->m_storage);
+                }
+        }
+
+        if ( !sim->m_partition.IsEmpty() ) {
+                for (unsigned int i = 0; i < sim->m_num_threads; i++) {
+                        sim->m_mailboxes.emplace_back(i, sim->m_num_threads,
+                                sim->m_partition.GetOwners(), sim->m_population->data());
+                }
+        }
+}
+
+void SimulatorBuilder::InitializeClusters(shared_ptr<Simulator> sim)
+{
+	Population& population = *sim->m_population;
+	const array<vector<Cluster>*, NumOfClusterTypes()> clusters { { &sim->m_households,
+	        &sim->m_school_clusters, &sim->m_work_clusters, &sim->m_primary_community, &sim->m_secondary_community } };
+
+	#pragma omp parallel for schedule(dynamic)
+	for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+		const auto type = static_cast<ClusterType>(t);
+
+		// The clusters are the distinct ids used in the population, in increasing order.
+		// Cluster id '0' means "not present in any cluster of that type".
+		vector<unsigned int> ids;
+		ids.reserve(population.size());
+		for (const auto& p : population) {
+			const auto id = p.GetClusterId(type);
+			if (id > 0) {
+				ids.push_back(id);
+			}
 		}
-		const auto wo_id = p.GetClusterId(ClusterType::Work);
-		if (wo_id > 0) {
-				sim->m_work_clusters[wo_id].AddPerson(&p);
+		sort(ids.begin(), ids.end());
+		ids.erase(unique(ids.begin(), ids.end()), ids.end());
+
+		// Map ids to indices: a direct lookup table, unless the ids are very sparse.
+		vector<unsigned int> index_of;
+		if ( !ids.empty() && ids.back() / 4U <= population.size() ) {
+			index_of.resize(ids.back() + 1U);
+			for (size_t i = 0; i < ids.size(); i++) {
+				index_of[ids[i]] = i;
+			}
 		}
-		const auto primCom_id = p.GetClusterId(ClusterType::PrimaryCommunity);
-		if (primCom_id > 0) {
-		        sim->m_primary_community[primCom_id].AddPerson(&p);
+
+		// The clusters keep their external id (for logging).
+		auto& type_clusters = *clusters[t];
+		type_clusters.clear();
+		type_clusters.reserve(ids.size());
+		for (const auto id : ids) {
+			type_clusters.emplace_back(Cluster(id, type));
 		}
-		const auto secCom_id = p.GetClusterId(ClusterType::SecondaryCommunity);
-		if (secCom_id > 0) {
-		        sim->m_secondary_community[secCom_id].AddPerson(&p);
+		for (auto& p : population) {
+			const auto id = p.GetClusterId(type);
+			if (id > 0) {
+				const size_t i = index_of.empty()
+				        ? lower_bound(ids.begin(), ids.end(), id) - ids.begin() : index_of[id];
+				type_clusters[i].AddPerson(&p);
+			}
 		}
 	}
 }
@@ -21,10 +21,16 @@
  */
 
 #include "Simulator.h"
+#include "core/ContactMatrix.h"
+#include "pop/PopulationBuilder.h"
 
+#include <boost/filesystem.hpp>
 #include <boost/property_tree/ptree.hpp>
+#include <functional>
+#include <istream>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace stride {
 
@@ -43,12 +49,19 @@ public:
 	        unsigned int num_threads =1U,
 	        bool track_index_case =false);
 
-        /// Build simulator.
+        /// Build simulator, for each of the pathogens of the config (see GetPathogenConfigs).
         static std::shared_ptr<Simulator> Build(
                 const boost::property_tree::ptree& pt_config,
                 unsigned int num_threads =1U,
                 bool track_index_case =false);
 
+        /// The configs of the pathogens of a run: run.disease_config_file may be a comma separated
+        /// list of disease files, and run.r0, run.seeding_rate and run.immunity_rate then hold one
+        /// value for all of them or a list with one value each. Every pathogen's config is the
+        /// given one with the values of that pathogen. The first pathogen, as a single one, is in
+        /// the health of the persons; the others each have a health track in the Simulator.
+        static std::vector<boost::property_tree::ptree> GetPathogenConfigs(const boost::property_tree::ptree& pt_config);
+
         /// Build simulator.
         static std::shared_ptr<Simulator> Build(
                 const boost::property_tree::ptree& pt_config,
@@ -57,9 +70,125 @@ public:
                 unsigned int number_of_threads = 1U,
                 bool track_index_case =false);
 
+        /// Build simulator.
+        static std::shared_ptr<Simulator> Build(
+                const boost::property_tree::ptree& pt_config,
+                const boost::property_tree::ptree& pt_disease,
+                const ContactMatrices& contact_matrices,
+                unsigned int number_of_threads = 1U,
+                bool track_index_case =false);
+
+        /// Build simulator, with the population read from the given stream (in the format of
+        /// the population files) rather than from the configured file.
+        static std::shared_ptr<Simulator> Build(
+                const boost::property_tree::ptree& pt_config,
+                const boost::property_tree::ptree& pt_disease,
+                const ContactMatrices& contact_matrices,
+                std::istream& pop_stream,
+                unsigned int number_of_threads = 1U,
+                bool track_index_case =false);
+
+        /// Build simulator, with the population of the records of the given source rather than
+        /// from the configured file.
+        static std::shared_ptr<Simulator> Build(
+                const boost::property_tree::ptree& pt_config,
+                const boost::property_tree::ptree& pt_disease,
+                const ContactMatrices& contact_matrices,
+                const PopulationBuilder::RecordSource& records,
+                unsigned int number_of_threads = 1U,
+                bool track_index_case =false);
+
+        /// Build a simulator with the population read from the given stream and save its
+        /// snapshot in run.snapshot_dir under the key of the config, for the runs with that
+        /// config to load. The snapshot is of the build without layout (partitioning and
+        /// placement), as for the snapshots of the other builds. Returns the snapshot's path.
+        static boost::filesystem::path Snapshot(
+                const boost::property_tree::ptree& pt_config,
+                const boost::property_tree::ptree& pt_disease,
+                const ContactMatrices& contact_matrices,
+                std::istream& pop_stream,
+                unsigned int number_of_threads = 1U);
+
+        /// Build a simulator with the population of the records of the given source and save
+        /// its snapshot, as above.
+        static boost::filesystem::path Snapshot(
+                const boost::property_tree::ptree& pt_config,
+                const boost::property_tree::ptree& pt_disease,
+                const ContactMatrices& contact_matrices,
+                const PopulationBuilder::RecordSource& records,
+                unsigned int number_of_threads = 1U);
+
+        /// Build a simulator on a copy of the persons and clusters of a model simulator (built
+        /// for the same population file, with any seed), with the health, seeding, disease
+        /// profile, rng and layout of the given config. Gives the same simulator as a build
+        /// from scratch with that config, without reading and indexing the population again.
+        static std::shared_ptr<Simulator> Build(
+                const Simulator& model,
+                const boost::property_tree::ptree& pt_config,
+                const boost::property_tree::ptree& pt_disease,
+                unsigned int number_of_threads = 1U,
+                bool track_index_case =false);
+
 private:
+        /// Build simulator for a single pathogen, from the configured files or a snapshot.
+        static std::shared_ptr<Simulator> BuildFirstPathogen(
+                const boost::property_tree::ptree& pt_config,
+                unsigned int num_threads,
+                bool track_index_case);
+
+        /// Builds the population of a simulator, with the given random stream and storage.
+        using PopulationFactory = std::function<std::shared_ptr<Population>(util::Random&,
+                std::shared_ptr<const util::Storage>)>;
+
+        /// Build a simulator with the population of the factory and save its snapshot.
+        static boost::filesystem::path Snapshot(
+                const boost::property_tree::ptree& pt_config,
+                const boost::property_tree::ptree& pt_disease,
+                const ContactMatrices& contact_matrices,
+                const PopulationFactory& population,
+                unsigned int number_of_threads);
+
+        /// Build simulator, with the population of the factory if any, else from the configured
+        /// file; with its layout (InitializeLayout) or, to snapshot it, without.
+        static std::shared_ptr<Simulator> Build(
+                const boost::property_tree::ptree& pt_config,
+                const boost::property_tree::ptree& pt_disease,
+                const ContactMatrices& contact_matrices,
+                const PopulationFactory& population,
+                unsigned int number_of_threads,
+                bool track_index_case,
+                bool layout);
+
+        /// Create a simulator with config, calendar, log level and disease profile set up,
+        /// but without population, clusters and rng handlers.
+        static std::shared_ptr<Simulator> Initialize(
+                const boost::property_tree::ptree& pt_config,
+                const boost::property_tree::ptree& pt_disease,
+                unsigned int number_of_threads,
+                bool track_index_case);
+
+        /// Set up age-structured mixing within clusters if so configured (run.age_mixing "matrix",
+        /// in age groups of run.age_bin_width years), from the given or else the configured contact matrices.
+        static void InitializeAgeMixing(std::shared_ptr<Simulator> sim, const ContactMatrices* contact_matrices = nullptr);
+
+        /// Initialize the rng handlers (one per thread) from the simulator's rng handler seed.
+        static void InitializeRngHandlers(std::shared_ptr<Simulator> sim);
+
+        /// Add a health track for each pathogen after the first, with random streams of its own:
+        /// a pathogen does not change the course of those before it in the list.
+        static void InitializePathogens(std::shared_ptr<Simulator> sim,
+                const std::vector<boost::property_tree::ptree>& pathogens);
+
+        /// Read the disease file of the config.
+        static boost::property_tree::ptree ReadDisease(const boost::property_tree::ptree& pt_config);
+
         /// Initialize the clusters.
         static void InitializeClusters(std::shared_ptr<Simulator> sim);
+
+        /// Partition persons and clusters over the threads, if so configured (run.partitioning),
+        /// place them in memory with the threads that process them and, with file-backed
+        /// storage, lay out the cluster members in the order of the daily cluster pass.
+        static void InitializeLayout(std::shared_ptr<Simulator> sim);
 };
 
 } // end_of_namespace
@@ -0,0 +1,451 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Implementation of the SimulatorCheckpoint class.
+ */
+
+#include "SimulatorCheckpoint.h"
+
+#include "Simulator.h"
+#include "calendar/Calendar.h"
+#include "core/Cluster.h"
+#include "core/ClusterType.h"
+#include "core/Health.h"
+#include "core/RngHandler.h"
+#include "pop/Population.h"
+#include "util/Fingerprint.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace stride {
+
+using namespace std;
+using namespace boost::filesystem;
+using namespace stride::util;
+
+static_assert(is_trivially_copyable<Health>::value, "Checkpoints store health as raw bytes.");
+
+namespace {
+
+/// Identifies checkpoint files.
+const char g_magic[8] = { 'S', 'T', 'R', 'I', 'D', 'E', 'C', 'P' };
+
+/// Format version: bump it whenever the layout or the meaning of the contents changes.
+const uint32_t g_version = 3U;
+
+/// Fixed size header at the start of a checkpoint.
+struct Header
+{
+        char         magic[8];
+        uint32_t     version;
+        uint32_t     health_size;                         ///< sizeof(Health) in the writing build.
+        uint64_t     id;                                  ///< Hash of the state.
+        uint64_t     base_id;                             ///< Hash of the state of the base (incremental only).
+        uint32_t     incremental;                         ///< Only changes with respect to the base?
+        uint32_t     num_rng;                             ///< Number of rng handlers, of all pathogens.
+        uint64_t     num_persons;
+        uint64_t     num_pathogens;
+        uint64_t     num_clusters[NumOfClusterTypes()];
+        uint64_t     num_members[NumOfClusterTypes()];    ///< Total number of memberships per cluster type.
+        uint64_t     sim_day;                             ///< Calendar: simulation day.
+        uint32_t     year;                                ///< Calendar: current date.
+        uint32_t     month;
+        uint32_t     day;
+        uint32_t     days_not_infectious;                 ///< Consecutive days without infectious persons.
+};
+
+/// Write the number of elements and the elements.
+template<typename T>
+void Put(ostream& os, const vector<T>& v)
+{
+        const uint64_t n = v.size();
+        os.write(reinterpret_cast<const char*>(&n), sizeof(n));
+        os.write(reinterpret_cast<const char*>(v.data()), n * sizeof(T));
+}
+
+/// Write a string.
+void Put(ostream& os, const string& s)
+{
+        Put(os, vector<char>(s.begin(), s.end()));
+}
+
+/// Read elements written by Put.
+template<typename T>
+vector<T> Get(istream& is)
+{
+        uint64_t n = 0U;
+        is.read(reinterpret_cast<char*>(&n), sizeof(n));
+        if ( !is || n > (1ULL << 40U) / sizeof(T) ) {
+                throw runtime_error(string(__func__) + "> Truncated or corrupt checkpoint.");
+        }
+        vector<T> v(n);
+        is.read(reinterpret_cast<char*>(v.data()), n * sizeof(T));
+        if ( !is ) {
+                throw runtime_error(string(__func__) + "> Truncated checkpoint.");
+        }
+        return v;
+}
+
+/// Read a string written by Put.
+string GetString(istream& is)
+{
+        const auto chars = Get<char>(is);
+        return string(chars.begin(), chars.end());
+}
+
+/// Write the positions and new values of the elements that differ from the previous ones.
+template<typename T>
+void PutChanges(ostream& os, const vector<T>& previous, const vector<T>& current)
+{
+        vector<uint64_t> positions;
+        vector<T>        values;
+        for (size_t i = 0; i < current.size(); i++) {
+                if (memcmp(&previous[i], &current[i], sizeof(T)) != 0) {
+                        positions.push_back(i);
+                        values.push_back(current[i]);
+                }
+        }
+        Put(os, positions);
+        Put(os, values);
+}
+
+/// Apply changes written by PutChanges.
+template<typename T>
+void GetChanges(istream& is, vector<T>& v)
+{
+        const auto positions = Get<uint64_t>(is);
+        const auto values    = Get<T>(is);
+        if (positions.size() != values.size()) {
+                throw runtime_error(string(__func__) + "> Corrupt checkpoint.");
+        }
+        for (size_t i = 0; i < positions.size(); i++) {
+                if (positions[i] >= v.size()) {
+                        throw runtime_error(string(__func__) + "> Corrupt checkpoint.");
+                }
+                v[positions[i]] = values[i];
+        }
+}
+
+}
+
+/// State of a simulator, as held in a checkpoint.
+struct SimulatorCheckpoint::State
+{
+        path                                              file_path;     ///< Checkpoint that holds it.
+        uint64_t                                          sim_day;
+        uint32_t                                          year;
+        uint32_t                                          month;
+        uint32_t                                          day;
+        uint32_t                                          days_not_infectious;
+        vector<string>                                    rng;           ///< States of the rng handlers.
+        vector<unsigned int>                              cases;         ///< Daily case counts.
+        string                                            engine_days;   ///< Engine of the cluster pass, by day.
+        vector<uint64_t>                                  num_mean_field; ///< Mean field cluster updates, per type.
+        vector<unsigned int>                              owners;        ///< Partition of the persons.
+        vector<Health>                                    health;        ///< By position in the population, then of the
+                                                                         ///< further pathogens by person id.
+        array<vector<uint32_t>, NumOfClusterTypes()>      members;       ///< Positions of members, cluster by cluster.
+        array<vector<uint64_t>, NumOfClusterTypes()>      index_immune;  ///< Index of the first immune member.
+
+        /// Hash of the state (all but the file path).
+        uint64_t GetId() const
+        {
+                const uint32_t date[4] = { year, month, day, days_not_infectious };
+                uint64_t h = Fingerprint::Hash(&sim_day, sizeof(sim_day));
+                h = Fingerprint::Hash(date, sizeof(date), h);
+                for (const auto& s : rng) {
+                        h = Fingerprint::Hash(s.data(), s.size(), h);
+                }
+                h = Fingerprint::Hash(cases.data(), cases.size() * sizeof(unsigned int), h);
+                h = Fingerprint::Hash(engine_days.data(), engine_days.size(), h);
+                h = Fingerprint::Hash(num_mean_field.data(), num_mean_field.size() * sizeof(uint64_t), h);
+                h = Fingerprint::Hash(owners.data(), owners.size() * sizeof(unsigned int), h);
+                h = Fingerprint::Hash(health.data(), health.size() * sizeof(Health), h);
+                for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+                        h = Fingerprint::Hash(members[t].data(), members[t].size() * sizeof(uint32_t), h);
+                        h = Fingerprint::Hash(index_immune[t].data(), index_immune[t].size() * sizeof(uint64_t), h);
+                }
+                return h;
+        }
+
+        /// State of the simulator.
+        static State Capture(const Simulator& sim, const vector<unsigned int>& cases)
+        {
+                const Population& population = *sim.m_population;
+                const array<const vector<Cluster>*, NumOfClusterTypes()> clusters { { &sim.m_households,
+                        &sim.m_school_clusters, &sim.m_work_clusters, &sim.m_primary_community, &sim.m_secondary_community } };
+
+                State s;
+                s.sim_day = sim.m_calendar->GetSimulationDay();
+                s.year    = static_cast<uint32_t>(sim.m_calendar->GetYear());
+                s.month   = static_cast<uint32_t>(sim.m_calendar->GetMonth());
+                s.day     = static_cast<uint32_t>(sim.m_calendar->GetDay());
+                for (const auto& r : sim.m_rng_handler) {
+                        s.rng.push_back(r.GetState());
+                }
+                for (const auto& track : sim.m_pathogens.tracks) {
+                        for (const auto& r : track.rng_handler) {
+                                s.rng.push_back(r.GetState());
+                        }
+                }
+                s.days_not_infectious = sim.m_days_not_infectious;
+                s.cases  = cases;
+                s.engine_days = sim.m_engine_days;
+                s.num_mean_field.assign(sim.m_num_mean_field.begin(), sim.m_num_mean_field.end());
+                s.owners = sim.m_partition.GetOwners();
+                s.health.reserve(population.size() * sim.GetNumPathogens());
+                for (const auto& p : population) {
+                        s.health.push_back(p.GetHealth());
+                }
+                for (const auto& track : sim.m_pathogens.tracks) {
+                        s.health.insert(s.health.end(), track.health.begin(), track.health.end());
+                }
+                for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+                        for (const auto& c : *clusters[t]) {
+                                for (const auto& m : c.m_members) {
+                                        s.members[t].push_back(static_cast<uint32_t>(m.first - population.data()));
+                                }
+                                s.index_immune[t].push_back(c.m_index_immune);
+                        }
+                }
+                return s;
+        }
+
+        /// Read the state from the checkpoint (and, if incremental, from its base).
+        static State Read(const path& file_path)
+        {
+                std::ifstream ifs(file_path.string(), ios::binary);
+                if ( !ifs ) {
+                        throw runtime_error(string(__func__) + "> No checkpoint " + file_path.string());
+                }
+                Header h {};
+                ifs.read(reinterpret_cast<char*>(&h), sizeof(h));
+                if ( !ifs || memcmp(h.magic, g_magic, sizeof(g_magic)) != 0 || h.version != g_version
+                        || h.health_size != sizeof(Health) ) {
+                        throw runtime_error(string(__func__) + "> Not a checkpoint of this version: " + file_path.string());
+                }
+
+                const auto base_name = GetString(ifs);
+                State s;
+                if (h.incremental) {
+                        path base_path(base_name);
+                        if (base_path.is_relative()) {
+                                base_path = file_path.parent_path() / base_path;
+                        }
+                        s = Read(base_path);
+                        if (s.GetId() != h.base_id) {
+                                throw runtime_error(string(__func__) + "> Base " + base_path.string()
+                                        + " of checkpoint " + file_path.string() + " has changed.");
+                        }
+                }
+                s.file_path = file_path;
+                s.sim_day   = h.sim_day;
+                s.year      = h.year;
+                s.month     = h.month;
+                s.day       = h.day;
+                s.days_not_infectious = h.days_not_infectious;
+                s.rng.clear();
+                for (uint32_t i = 0; i < h.num_rng; i++) {
+                        s.rng.push_back(GetString(ifs));
+                }
+                s.cases          = Get<unsigned int>(ifs);
+                s.engine_days    = GetString(ifs);
+                s.num_mean_field = Get<uint64_t>(ifs);
+                if (h.incremental) {
+                        if (s.health.size() != h.num_persons * h.num_pathogens) {
+                                throw runtime_error(string(__func__) + "> Corrupt checkpoint " + file_path.string());
+                        }
+                        GetChanges(ifs, s.health);
+                        for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+                                GetChanges(ifs, s.members[t]);
+                                GetChanges(ifs, s.index_immune[t]);
+                        }
+                } else {
+                        s.owners = Get<unsigned int>(ifs);
+                        s.health = Get<Health>(ifs);
+                        for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+                                s.members[t]      = Get<uint32_t>(ifs);
+                                s.index_immune[t] = Get<uint64_t>(ifs);
+                        }
+                }
+
+                bool consistent = (s.health.size() == h.num_persons * h.num_pathogens) && (s.GetId() == h.id)
+                        && (s.num_mean_field.size() == NumOfClusterTypes());
+                for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+                        consistent = consistent && s.members[t].size() == h.num_members[t]
+                                && s.index_immune[t].size() == h.num_clusters[t];
+                }
+                if ( !consistent ) {
+                        throw runtime_error(string(__func__) + "> Corrupt checkpoint " + file_path.string());
+                }
+                return s;
+        }
+};
+
+SimulatorCheckpoint::SimulatorCheckpoint(bool incremental)
+        : m_incremental(incremental)
+{
+}
+
+SimulatorCheckpoint::~SimulatorCheckpoint()
+{
+}
+
+void SimulatorCheckpoint::Save(const Simulator& sim, const vector<unsigned int>& cases, const path& file_path)
+{
+        State s = State::Capture(sim, cases);
+        s.file_path = file_path;
+        const bool incremental = m_incremental && m_previous;
+
+        Header h {};
+        memcpy(h.magic, g_magic, sizeof(g_magic));
+        h.version     = g_version;
+        h.health_size = sizeof(Health);
+        h.id          = s.GetId();
+        h.base_id     = incremental ? m_previous->GetId() : 0U;
+        h.incremental = incremental;
+        h.num_rng     = static_cast<uint32_t>(s.rng.size());
+        h.num_persons   = sim.m_population->size();
+        h.num_pathogens = sim.GetNumPathogens();
+        for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+                h.num_clusters[t] = s.index_immune[t].size();
+                h.num_members[t]  = s.members[t].size();
+        }
+        h.sim_day = s.sim_day;
+        h.year    = s.year;
+        h.month   = s.month;
+        h.day     = s.day;
+        h.days_not_infectious = s.days_not_infectious;
+
+        // The base is named relative to the checkpoint when next to it.
+        string base_name;
+        if (incremental) {
+                const auto& base_path = m_previous->file_path;
+                base_name = (absolute(base_path).parent_path() == absolute(file_path).parent_path())
+                        ? base_path.filename().string() : absolute(base_path).string();
+        }
+
+        // Write next to the destination, then rename into place.
+        const path tmp_path = unique_path(file_path.string() + ".%%%%-%%%%-%%%%");
+        {
+                std::ofstream ofs(tmp_path.string(), ios::binary | ios::trunc);
+                if ( !ofs ) {
+                        throw runtime_error(string(__func__) + "> Error opening " + tmp_path.string());
+                }
+                ofs.write(reinterpret_cast<const char*>(&h), sizeof(h));
+                Put(ofs, base_name);
+                for (const auto& r : s.rng) {
+                        Put(ofs, r);
+                }
+                Put(ofs, s.cases);
+                Put(ofs, s.engine_days);
+                Put(ofs, s.num_mean_field);
+                if (incremental) {
+                        PutChanges(ofs, m_previous->health, s.health);
+                        for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+                                PutChanges(ofs, m_previous->members[t], s.members[t]);
+                                PutChanges(ofs, m_previous->index_immune[t], s.index_immune[t]);
+                        }
+                } else {
+                        Put(ofs, s.owners);
+                        Put(ofs, s.health);
+                        for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+                                Put(ofs, s.members[t]);
+                                Put(ofs, s.index_immune[t]);
+                        }
+                }
+                if ( !ofs ) {
+                        throw runtime_error(string(__func__) + "> Error writing " + tmp_path.string());
+                }
+        }
+        rename(tmp_path, file_path);
+
+        if (m_incremental) {
+                m_previous.reset(new State(move(s)));
+        }
+}
+
+vector<unsigned int> SimulatorCheckpoint::Load(Simulator& sim, const path& file_path)
+{
+        const State s = State::Read(file_path);
+
+        Population& population = *sim.m_population;
+        const array<vector<Cluster>*, NumOfClusterTypes()> clusters { { &sim.m_households,
+                &sim.m_school_clusters, &sim.m_work_clusters, &sim.m_primary_community, &sim.m_secondary_community } };
+
+        // Check that the simulator has the persons, clusters, threads and partition of the checkpoint.
+        const size_t num_pathogens = sim.GetNumPathogens();
+        bool fits = (s.health.size() == population.size() * num_pathogens)
+                && (s.rng.size() == sim.m_rng_handler.size() * num_pathogens)
+                && (s.owners == sim.m_partition.GetOwners());
+        for (size_t t = 0; fits && t < NumOfClusterTypes(); t++) {
+                size_t num_members = 0U;
+                for (const auto& c : *clusters[t]) {
+                        num_members += c.GetSize();
+                }
+                fits = (s.index_immune[t].size() == clusters[t]->size()) && (s.members[t].size() == num_members);
+        }
+        if ( !fits ) {
+                throw runtime_error(string(__func__) + "> Checkpoint " + file_path.string()
+                        + " is not of a simulator with this population, pathogens, number of threads and partitioning.");
+        }
+
+        for (size_t i = 0; i < population.size(); i++) {
+                population[i].GetHealth() = s.health[i];
+        }
+        for (size_t k = 0; k < sim.m_pathogens.size(); k++) {
+                const auto first = s.health.begin() + (k + 1U) * population.size();
+                copy(first, first + population.size(), sim.m_pathogens.tracks[k].health.begin());
+        }
+        for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+                size_t j = 0U;
+                for (size_t c = 0; c < clusters[t]->size(); c++) {
+                        Cluster& cluster = (*clusters[t])[c];
+                        for (auto& m : cluster.m_members) {
+                                if (s.members[t][j] >= population.size()) {
+                                        throw runtime_error(string(__func__) + "> Corrupt checkpoint " + file_path.string());
+                                }
+                                m.first = &population[s.members[t][j++]];
+                        }
+                        cluster.m_index_immune = s.index_immune[t][c];
+                }
+        }
+        for (size_t i = 0; i < s.rng.size(); i++) {
+                const size_t num_rng = sim.m_rng_handler.size();
+                auto& handlers = (i < num_rng) ? sim.m_rng_handler : sim.m_pathogens.tracks[i / num_rng - 1U].rng_handler;
+                handlers[i % num_rng].SetState(s.rng[i]);
+        }
+        sim.m_calendar->SetDate(s.sim_day, boost::gregorian::date(s.year, s.month, s.day));
+        sim.m_active_clusters.Invalidate();
+
+        // The output accumulators, and the days without infectious persons that skip the cluster pass.
+        sim.m_engine_days         = s.engine_days;
+        sim.m_days_not_infectious = s.days_not_infectious;
+        copy(s.num_mean_field.begin(), s.num_mean_field.end(), sim.m_num_mean_field.begin());
+
+        return s.cases;
+}
+
+} // end_of_namespace
@@ -0,0 +1,74 @@
+#ifndef SIMULATOR_CHECKPOINT_H_INCLUDED
+#define SIMULATOR_CHECKPOINT_H_INCLUDED
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Header for the SimulatorCheckpoint class.
+ */
+
+#include <boost/filesystem.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace stride {
+
+class Simulator;
+
+/**
+ * Binary checkpoint of the dynamic state of a running Simulator: the health of every
+ * person (with every pathogen), the order of the members in every cluster (which the
+ * daily sort changes), the calendar, the state of the rng handlers, the daily case
+ * counts so far and the simulator's own accumulators (the engine of each day's cluster
+ * pass, the mean field cluster updates and the days without infectious persons).
+ * A Simulator built from the same configuration and restored from a checkpoint
+ * continues bit for bit as the one that wrote it. Entries that only enter the
+ * disease profile or the days off (r0, days_off) may differ, which forks scenarios
+ * from a common state.
+ *
+ * Incremental checkpoints hold only the health states and member positions that
+ * changed since the previous checkpoint written by the same object, and name that
+ * checkpoint as their base; restoring reads the chain back to the full checkpoint.
+ * As SimulatorSnapshot files, checkpoints are native binary, versioned and appear
+ * atomically.
+ */
+class SimulatorCheckpoint
+{
+public:
+	/// Checkpoints of one run: all full or, when incremental, all but the first one incremental.
+	explicit SimulatorCheckpoint(bool incremental = false);
+
+	///
+	~SimulatorCheckpoint();
+
+	/// Write the state of the simulator and the daily case counts up to now.
+	void Save(const Simulator& sim, const std::vector<unsigned int>& cases, const boost::filesystem::path& file_path);
+
+	/// Restore the state of a simulator built from the same configuration (with the same
+	/// number of threads and partitioning); returns the daily case counts up to the checkpoint.
+	static std::vector<unsigned int> Load(Simulator& sim, const boost::filesystem::path& file_path);
+
+private:
+	struct State;
+
+	bool                        m_incremental;   ///< Write incremental checkpoints.
+	std::unique_ptr<State>      m_previous;      ///< State in the previous checkpoint written.
+};
+
+} // end_of_namespace
+
+#endif // end-of-include-guard
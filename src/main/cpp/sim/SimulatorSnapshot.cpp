@@ -0,0 +1,308 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Implementation of the SimulatorSnapshot class.
+ */
+
+#include "SimulatorSnapshot.h"
+
+#include "Simulator.h"
+#include "calendar/Calendar.h"
+#include "core/Cluster.h"
+#include "core/ClusterType.h"
+#include "core/ContactMatrixReader.h"
+#include "core/ContactProfile.h"
+#include "pop/Person.h"
+#include "pop/Population.h"
+#include "util/Fingerprint.h"
+#include "util/InstallDirs.h"
+#include "util/NumaAllocator.h"
+
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace stride {
+
+using namespace std;
+using namespace boost::filesystem;
+using boost::property_tree::ptree;
+using namespace stride::util;
+
+static_assert(is_trivially_copyable<Person>::value, "Snapshots store persons as raw bytes.");
+
+namespace {
+
+/// Identifies snapshot files.
+const char g_magic[8] = { 'S', 'T', 'R', 'I', 'D', 'E', 'S', 'N' };
+
+/// Format version: bump it whenever the layout or the meaning of the contents changes.
+const uint32_t g_version = 4U;
+
+/// Sections start at multiples of this.
+const size_t g_alignment = 8U;
+
+/// The persons section starts at a multiple of this, so it can be mapped by itself
+/// (a multiple of the page size on all platforms we know of).
+const size_t g_page_alignment = 65536U;
+
+/// Fixed size header at the start of a snapshot.
+struct Header
+{
+        char         magic[8];
+        uint32_t     version;
+        uint32_t     person_size;                         ///< sizeof(Person) in the writing build.
+        uint64_t     key;                                 ///< Key of the config inputs.
+        uint64_t     num_persons;
+        uint64_t     num_clusters[NumOfClusterTypes()];
+        uint64_t     num_members[NumOfClusterTypes()];    ///< Total number of memberships per cluster type.
+        uint64_t     sim_day;                             ///< Calendar: simulation day.
+        uint32_t     year;                                ///< Calendar: current date.
+        uint32_t     month;
+        uint32_t     day;
+        uint32_t     rng_seed;                            ///< Seed for the rng handlers.
+};
+
+/// Sequential writer of aligned sections.
+class SectionWriter
+{
+public:
+        explicit SectionWriter(ostream& os) : m_os(os), m_pos(0U) {}
+
+        template<typename T>
+        void Put(const T* data, size_t count, size_t alignment = g_alignment)
+        {
+                const size_t pad = (alignment - m_pos % alignment) % alignment;
+                m_os.write(string(pad, '\0').data(), pad);
+                m_os.write(reinterpret_cast<const char*>(data), count * sizeof(T));
+                m_pos += pad + count * sizeof(T);
+        }
+
+private:
+        ostream&   m_os;
+        size_t     m_pos;
+};
+
+/// Sequential reader of aligned sections in a memory-mapped snapshot.
+class SectionReader
+{
+public:
+        SectionReader(const char* first, size_t size) : m_first(first), m_size(size), m_pos(0U) {}
+
+        /// Start of the next section of count items (nullptr if the snapshot is truncated).
+        template<typename T>
+        const T* Take(size_t count, size_t alignment = g_alignment)
+        {
+                const size_t start = m_pos + (alignment - m_pos % alignment) % alignment;
+                if (start > m_size || count > (m_size - start) / sizeof(T)) {
+                        return nullptr;
+                }
+                m_pos = start + count * sizeof(T);
+                return reinterpret_cast<const T*>(m_first + start);
+        }
+
+private:
+        const char*  m_first;
+        size_t       m_size;
+        size_t       m_pos;
+};
+
+}
+
+uint64_t SimulatorSnapshot::GetKey(const ptree& pt_config)
+{
+        ostringstream oss;
+        oss << "version=" << g_version
+                << ";population_file="
+                << Fingerprint::FileStamp(InstallDirs::GetDataDir() /= pt_config.get<string>("run.population_file"))
+                << ";disease_config_file="
+                << Fingerprint::FileStamp(InstallDirs::GetDataDir() /= pt_config.get<string>("run.disease_config_file"))
+                << ";contact_matrices=" << ContactMatrixReader::GetStamp(pt_config)
+                << ";rng_seed=" << pt_config.get<string>("run.rng_seed")
+                << ";seeding_rate=" << pt_config.get<string>("run.seeding_rate")
+                << ";immunity_rate=" << pt_config.get<string>("run.immunity_rate")
+                << ";start_date=" << pt_config.get<string>("run.start_date", "2016-01-01")
+                << ";log_level=" << pt_config.get<string>("run.log_level", "None")
+                << ";person_order=" << pt_config.get<string>("run.person_order", "file")
+                << ";num_participants_survey=" << pt_config.get<string>("run.num_participants_survey", "0");
+        return Fingerprint::Hash(oss.str());
+}
+
+path SimulatorSnapshot::GetPath(const path& dir, uint64_t key)
+{
+        ostringstream oss;
+        oss << "stride_snapshot_" << hex << setw(16) << setfill('0') << key << ".bin";
+        return dir / oss.str();
+}
+
+bool SimulatorSnapshot::Load(Simulator& sim, const path& file_path, uint64_t key, bool shared)
+{
+        if ( !is_regular_file(file_path) || file_size(file_path) < sizeof(Header) ) {
+                return false;
+        }
+        boost::iostreams::mapped_file_source mapped(file_path.string());
+        if ( !mapped.is_open() ) {
+                return false;
+        }
+        SectionReader reader(mapped.data(), mapped.size());
+
+        // Header.
+        const Header* h = reader.Take<Header>(1U);
+        if (memcmp(h->magic, g_magic, sizeof(g_magic)) != 0 || h->version != g_version
+                || h->person_size != sizeof(Person) || h->key != key) {
+                return false;
+        }
+
+        // Locate all sections before touching the simulator.
+        const auto profiles = reader.Take<double>(NumOfClusterTypes() * (MaximumAge() + 1));
+        const auto persons  = reader.Take<Person>(h->num_persons, g_page_alignment);
+        array<const uint64_t*, NumOfClusterTypes()>  cluster_ids;
+        array<const uint64_t*, NumOfClusterTypes()>  member_offsets;
+        array<const uint32_t*, NumOfClusterTypes()>  members;
+        bool complete = (profiles != nullptr && persons != nullptr);
+        for (size_t t = 0; complete && t < NumOfClusterTypes(); t++) {
+                cluster_ids[t]    = reader.Take<uint64_t>(h->num_clusters[t]);
+                member_offsets[t] = reader.Take<uint64_t>(h->num_clusters[t] + 1U);
+                members[t]        = reader.Take<uint32_t>(h->num_members[t]);
+                complete = cluster_ids[t] != nullptr && member_offsets[t] != nullptr && members[t] != nullptr;
+        }
+        if ( !complete ) {
+                return false;
+        }
+
+        // Population: mapped copy-on-write from the file or copied out of it.
+        auto population = make_shared<Population>(Population::allocator_type(sim.m_storage));
+        const size_t persons_bytes = h->num_persons * sizeof(Person);
+        void* shared_persons = shared ? NumaPolicy::MapShared(file_path.string(),
+                reinterpret_cast<const char*>(persons) - mapped.data(), persons_bytes) : nullptr;
+        if (shared_persons != nullptr && NumaPolicy::AdoptNext(shared_persons, persons_bytes)) {
+                population->reserve(h->num_persons);
+                population->resize(h->num_persons);
+                if (static_cast<void*>(population->data()) != shared_persons) {
+                        throw runtime_error(string(__func__) + "> Population did not take over the mapped persons.");
+                }
+        } else {
+                population->assign(persons, persons + h->num_persons);
+        }
+
+        // Clusters, with their members in the original order.
+        const array<vector<Cluster>*, NumOfClusterTypes()> clusters { { &sim.m_households,
+                &sim.m_school_clusters, &sim.m_work_clusters, &sim.m_primary_community, &sim.m_secondary_community } };
+        for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+                const auto type = static_cast<ClusterType>(t);
+                auto& v = *clusters[t];
+                v.clear();
+                v.reserve(h->num_clusters[t]);
+                for (size_t i = 0; i < h->num_clusters[t]; i++) {
+                        v.emplace_back(Cluster(cluster_ids[t][i], type));
+                        for (auto j = member_offsets[t][i]; j < member_offsets[t][i + 1]; j++) {
+                                if (members[t][j] >= h->num_persons) {
+                                        throw runtime_error(string(__func__) + "> Corrupt snapshot " + file_path.string());
+                                }
+                                v.back().AddPerson(&(*population)[members[t][j]]);
+                        }
+                }
+        }
+        sim.m_population = population;
+
+        // Contact profiles.
+        for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+                ContactProfile profile;
+                copy(profiles + t * profile.size(), profiles + (t + 1) * profile.size(), profile.begin());
+                Cluster::AddContactProfile(static_cast<ClusterType>(t), profile);
+        }
+
+        // Calendar and rng seed.
+        sim.m_calendar->SetDate(h->sim_day, boost::gregorian::date(h->year, h->month, h->day));
+        sim.m_rng_handler_seed = h->rng_seed;
+
+        return true;
+}
+
+void SimulatorSnapshot::Save(const Simulator& sim, const path& file_path, uint64_t key)
+{
+        const Population& population = *sim.m_population;
+        const array<const vector<Cluster>*, NumOfClusterTypes()> clusters { { &sim.m_households,
+                &sim.m_school_clusters, &sim.m_work_clusters, &sim.m_primary_community, &sim.m_secondary_community } };
+
+        Header h {};
+        memcpy(h.magic, g_magic, sizeof(g_magic));
+        h.version      = g_version;
+        h.person_size  = sizeof(Person);
+        h.key          = key;
+        h.num_persons  = population.size();
+        for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+                h.num_clusters[t] = clusters[t]->size();
+                h.num_members[t]  = 0U;
+                for (const auto& c : *clusters[t]) {
+                        h.num_members[t] += c.GetSize();
+                }
+        }
+        h.sim_day   = sim.m_calendar->GetSimulationDay();
+        h.year      = static_cast<uint32_t>(sim.m_calendar->GetYear());
+        h.month     = static_cast<uint32_t>(sim.m_calendar->GetMonth());
+        h.day       = static_cast<uint32_t>(sim.m_calendar->GetDay());
+        h.rng_seed  = sim.m_rng_handler_seed;
+
+        // Write next to the destination, then rename into place.
+        const path tmp_path = unique_path(file_path.string() + ".%%%%-%%%%-%%%%");
+        {
+                std::ofstream ofs(tmp_path.string(), ios::binary | ios::trunc);
+                if ( !ofs ) {
+                        throw runtime_error(string(__func__) + "> Error opening " + tmp_path.string());
+                }
+                SectionWriter writer(ofs);
+                writer.Put(&h, 1U);
+
+                for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+                        const auto& profile = Cluster::GetContactProfile(static_cast<ClusterType>(t));
+                        writer.Put(profile.data(), profile.size());
+                }
+                writer.Put(population.data(), population.size(), g_page_alignment);
+
+                for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+                        vector<uint64_t> ids;
+                        vector<uint64_t> offsets(1U, 0U);
+                        vector<uint32_t> members;
+                        members.reserve(h.num_members[t]);
+                        for (const auto& c : *clusters[t]) {
+                                ids.push_back(c.m_cluster_id);
+                                for (const auto& m : c.m_members) {
+                                        members.push_back(static_cast<uint32_t>(m.first - population.data()));
+                                }
+                                offsets.push_back(members.size());
+                        }
+                        writer.Put(ids.data(), ids.size());
+                        writer.Put(offsets.data(), offsets.size());
+                        writer.Put(members.data(), members.size());
+                }
+                if ( !ofs ) {
+                        throw runtime_error(string(__func__) + "> Error writing " + tmp_path.string());
+                }
+        }
+        rename(tmp_path, file_path);
+}
+
+} // end_of_namespace
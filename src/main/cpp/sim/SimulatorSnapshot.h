@@ -0,0 +1,66 @@
+#ifndef SIMULATOR_SNAPSHOT_H_INCLUDED
+#define SIMULATOR_SNAPSHOT_H_INCLUDED
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Header for the SimulatorSnapshot class.
+ */
+
+#include <boost/filesystem.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <cstdint>
+
+namespace stride {
+
+class Simulator;
+
+/**
+ * Binary snapshot of a freshly built Simulator: the population, the cluster
+ * memberships, the contact profiles, the calendar and the seed of the rng handlers.
+ * A snapshot only holds for the config inputs it was built from. These are
+ * summarized in a key that is stored in the snapshot and that names its file.
+ * The format is native binary and versioned: snapshots written by another
+ * version (or another build) are not loaded, but simply rebuilt.
+ */
+class SimulatorSnapshot
+{
+public:
+	/// Key for the config inputs that determine the built state (input files, seed, rates, ...).
+	/// The R0 is not part of it: it only enters the disease profile, which is not in the snapshot.
+	static std::uint64_t GetKey(const boost::property_tree::ptree& pt_config);
+
+	/// Path of the snapshot for the given key in the directory.
+	static boost::filesystem::path GetPath(const boost::filesystem::path& dir, std::uint64_t key);
+
+	/// Restore the population, clusters, contact profiles, calendar and rng handler seed
+	/// of the simulator from the (memory-mapped) snapshot. Returns false, leaving the
+	/// simulator untouched, if the file is absent, of another version or for another key.
+	/// When shared, the persons are mapped copy-on-write from the file rather than copied:
+	/// processes that load the same snapshot then share the memory of all persons whose
+	/// health does not change (the cluster memberships remain per process).
+	static bool Load(Simulator& sim, const boost::filesystem::path& file_path, std::uint64_t key,
+	        bool shared = false);
+
+	/// Write the snapshot. The file appears atomically (write & rename), so runs that
+	/// start concurrently never map a partially written snapshot.
+	static void Save(const Simulator& sim, const boost::filesystem::path& file_path, std::uint64_t key);
+};
+
+} // end_of_namespace
+
+#endif // end-of-include-guard
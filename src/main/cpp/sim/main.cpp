@@ -18,9 +18,13 @@
  * Main program: command line handling.
  */
 
+#include "run_ensemble.h"
 #include "run_stride.h"
 
 #include <tclap/CmdLine.h>
+#ifdef USE_MPI
+#include <mpi.h>
+#endif
 #include <exception>
 #include <iostream>
 
@@ -32,6 +36,10 @@ using namespace TCLAP;
 int main(int argc, char** argv)
 {
 	int exit_status = EXIT_SUCCESS;
+#ifdef USE_MPI
+	// Started with mpirun, the processes run one (distributed) simulation together.
+	MPI_Init(&argc, &argv);
+#endif
 	try {
 		// -----------------------------------------------------------------------------------------
 		// Parse command line.
@@ -40,12 +48,18 @@ int main(int argc, char** argv)
 		SwitchArg         index_case_Arg("r", "r0", "R0 only", cmd, false);
 		ValueArg<string>  config_file_Arg("c", "config", "Config File", false,
 		                                "./config/run_default.xml", "CONFIGURATION FILE", cmd);
+		ValueArg<string>  ensemble_file_Arg("e", "ensemble", "Ensemble File (wrapper json)", false,
+		                                "", "ENSEMBLE FILE", cmd);
 		cmd.parse(argc, argv);
 
 		// -----------------------------------------------------------------------------------------
 		// Run the Stride simulator.
 		// -----------------------------------------------------------------------------------------
-		run_stride(index_case_Arg.getValue(), config_file_Arg.getValue());
+		if (ensemble_file_Arg.isSet()) {
+			run_ensemble(index_case_Arg.getValue(), ensemble_file_Arg.getValue());
+		} else {
+			run_stride(index_case_Arg.getValue(), config_file_Arg.getValue());
+		}
 
 	}
 	catch (exception& e) {
@@ -56,5 +70,14 @@ int main(int argc, char** argv)
 		exit_status = EXIT_FAILURE;
 		cerr << "\nEXCEPION THROWN: " << "Unknown exception." << endl;
 	}
+#ifdef USE_MPI
+	// The other processes would wait for this one forever.
+	int num_processes = 1;
+	MPI_Comm_size(MPI_COMM_WORLD, &num_processes);
+	if (exit_status != EXIT_SUCCESS && num_processes > 1) {
+		MPI_Abort(MPI_COMM_WORLD, exit_status);
+	}
+	MPI_Finalize();
+#endif
 	return exit_status;
 }
@@ -0,0 +1,594 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Run an ensemble of simulations in one process.
+ */
+
+#include "run_ensemble.h"
+
+#include "output/CasesFile.h"
+#include "output/PersonFile.h"
+#include "output/SummaryFile.h"
+#include "pop/Population.h"
+#include "sim/LockstepEnsemble.h"
+#include "sim/Simulator.h"
+#include "sim/SimulatorBuilder.h"
+#include "sim/SimulatorCheckpoint.h"
+#include "util/InstallDirs.h"
+#include "util/Stopwatch.h"
+#include "util/ThreadPinning.h"
+#include "util/TimeStamp.h"
+
+#include <boost/algorithm/string.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/xml_parser.hpp>
+#include <boost/filesystem.hpp>
+#include <omp.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace stride {
+
+using namespace output;
+using namespace util;
+using namespace boost::filesystem;
+using namespace boost::property_tree;
+using namespace std;
+using namespace std::chrono;
+using boost::filesystem::path;
+using std::ifstream;
+using std::ofstream;
+
+namespace {
+
+/// One run of the ensemble.
+struct Experiment
+{
+        unsigned int   index;       ///< Position in the ensemble (as numbered by wrapper_stride.py).
+        unsigned int   threads;     ///< Requested number of threads (0: as the scheduler sees fit).
+        unsigned int   scenario;    ///< Scenario of the run (0: the baseline).
+        ptree          config;      ///< Configuration of the run.
+        string         prefix;      ///< Output prefix of the run.
+};
+
+/// Values of an entry of the wrapper configuration: the elements of a list, or a single value.
+template<typename T>
+vector<T> GetValues(const ptree& pt, const string& key)
+{
+        vector<T> values;
+        const auto& child = pt.get_child(key);
+        if (child.empty()) {
+                values.push_back(child.get_value<T>());
+        } else {
+                for (const auto& v : child) {
+                        values.push_back(v.second.get_value<T>());
+                }
+        }
+        return values;
+}
+
+/// Set the OpenMP schedule from its environment variable notation (e.g. "DYNAMIC,1").
+void SetSchedule(const string& schedule)
+{
+        vector<string> parts;
+        boost::split(parts, schedule, boost::is_any_of(","));
+        const string kind  = boost::to_lower_copy(boost::trim_copy(parts[0]));
+        const int    chunk = (parts.size() > 1U) ? stoi(parts[1]) : 0;
+        if (kind == "static") {
+                omp_set_schedule(omp_sched_static, chunk);
+        } else if (kind == "dynamic") {
+                omp_set_schedule(omp_sched_dynamic, chunk);
+        } else if (kind == "guided") {
+                omp_set_schedule(omp_sched_guided, chunk);
+        } else if (kind == "auto") {
+                omp_set_schedule(omp_sched_auto, chunk);
+        } else {
+                throw runtime_error(string(__func__) + "> Invalid input for omp_schedule: " + schedule);
+        }
+}
+
+/// Entries of the run configuration that may differ between the lanes of a lockstep ensemble.
+const vector<string> g_lane_keys { "rng_seed", "r0", "immunity_rate", "seeding_rate", "days_off", "disease_config_file" };
+
+/// Entries of the run configuration that a scenario may override.
+const vector<string> g_scenario_keys { "r0", "immunity_rate", "seeding_rate", "days_off" };
+
+/// Do the configurations differ in the given entries of run (and the output prefix) only?
+bool SameBut(const ptree& pt1, const ptree& pt2, const vector<string>& keys)
+{
+        ptree lhs = pt1;
+        ptree rhs = pt2;
+        for (auto pt : { &lhs, &rhs }) {
+                for (const auto& key : keys) {
+                        pt->get_child("run").erase(key);
+                }
+                pt->get_child("run").erase("output_prefix");
+        }
+        return lhs == rhs;
+}
+
+/// Mean and (sample) variance.
+pair<double, double> Moments(const vector<double>& x)
+{
+        double sum = 0.0;
+        for (const auto v : x) {
+                sum += v;
+        }
+        const double mean = x.empty() ? 0.0 : sum / x.size();
+        double ss = 0.0;
+        for (const auto v : x) {
+                ss += (v - mean) * (v - mean);
+        }
+        return make_pair(mean, (x.size() > 1U) ? ss / (x.size() - 1U) : 0.0);
+}
+
+/**
+ * Split the thread budget over replicas and clusters: returns the number of threads for
+ * each of the replicas that run at once. Replicas share nothing while they run, so the
+ * budget goes to them first unless a number of threads was requested; what does not
+ * divide evenly goes to the first replicas.
+ */
+vector<unsigned int> Schedule(unsigned int budget, unsigned int requested, size_t num_replicas)
+{
+        budget = max(budget, 1U);
+        if (requested == 0U) {
+                const unsigned int concurrent = static_cast<unsigned int>(min<size_t>(max<size_t>(num_replicas, 1U), budget));
+                vector<unsigned int> threads(concurrent, budget / concurrent);
+                for (unsigned int i = 0; i < budget % concurrent; i++) {
+                        threads[i]++;
+                }
+                return threads;
+        }
+        const unsigned int threads = min(requested, budget);
+        return vector<unsigned int>(min<size_t>(max<size_t>(num_replicas, 1U), budget / threads), threads);
+}
+
+/// Build a replica of the model for the experiment, run it and write its outputs;
+/// returns the final number of cases.
+unsigned int RunReplica(const Simulator& model, const ptree& pt_disease, const Experiment& exp,
+        unsigned int num_threads, bool track_index_case)
+{
+        const ptree& pt_config = exp.config;
+        const bool logging = (pt_config.get<string>("run.log_level") != "None");
+        if (logging) {
+                auto file_logger = spdlog::rotating_logger_mt("contact_logger", exp.prefix + "_logfile",
+                        numeric_limits<size_t>::max(), numeric_limits<size_t>::max());
+                file_logger->set_pattern("%v");
+        }
+
+        Stopwatch<> total_clock("total_clock", true);
+        const auto sim = SimulatorBuilder::Build(model, pt_config, pt_disease, num_threads, track_index_case);
+
+        // Replicas may all continue from one checkpoint, e.g. of a warm-up run.
+        vector<unsigned int> cases;
+        const auto restart_from = pt_config.get<string>("run.restart_from", "");
+        if ( !restart_from.empty() ) {
+                cases = SimulatorCheckpoint::Load(*sim, absolute(restart_from, InstallDirs::GetCurrentDir()));
+        }
+
+        Stopwatch<> run_clock("run_clock");
+        const unsigned int num_days = pt_config.get<unsigned int>("run.num_days");
+        for (unsigned int i = cases.size(); i < num_days; i++) {
+                run_clock.Start();
+                sim->TimeStep();
+                run_clock.Stop();
+                const bool extinct = sim->IsExtinct() && !cases.empty();
+                cases.push_back(extinct ? cases.back() : sim->GetPopulation()->GetInfectedCount());
+        }
+        total_clock.Stop();
+
+        CasesFile cases_file(exp.prefix);
+        cases_file.Print(cases);
+        SummaryFile summary_file(exp.prefix);
+        summary_file.Print(pt_config,
+                sim->GetPopulation()->size(), sim->GetPopulation()->GetInfectedCount(),
+                duration_cast<milliseconds>(run_clock.Get()).count(),
+                duration_cast<milliseconds>(total_clock.Get()).count(),
+                ThreadPinning::ToString(sim->GetThreadCpus()), sim->GetEngineDays());
+        if (pt_config.get<double>("run.generate_person_file") == 1) {
+                PersonFile person_file(exp.prefix);
+                person_file.Print(sim->GetPopulation());
+        }
+        if (logging) {
+                spdlog::drop("contact_logger");
+        }
+
+        #pragma omp critical(ensemble_output)
+        cout << "Experiment " << setw(5) << exp.index << " done, threads: " << setw(3) << num_threads
+                << ", infected count: " << setw(10) << cases.back()
+                << ", run_time: " << run_clock.ToString() << endl;
+        return cases.back();
+}
+
+/// Run experiments that differ in their seed, scenario and disease only as the lanes of one
+/// lockstep ensemble (with common random numbers or not); returns the final number of cases of each.
+vector<unsigned int> RunLockstep(const Simulator& model, const map<string, ptree>& diseases,
+        const vector<const Experiment*>& lanes, unsigned int num_threads, bool track_index_case, bool common_random_numbers)
+{
+        const ptree& pt_config = lanes.front()->config;
+        vector<ptree> lane_configs;
+        vector<ptree> lane_diseases;
+        for (const auto exp : lanes) {
+                lane_configs.push_back(exp->config);
+                lane_diseases.push_back(diseases.at(exp->config.get<string>("run.disease_config_file")));
+        }
+
+        Stopwatch<> total_clock("total_clock", true);
+        LockstepEnsemble ensemble(model, lane_configs, lane_diseases, num_threads, track_index_case, common_random_numbers);
+
+        Stopwatch<> run_clock("run_clock");
+        const unsigned int num_days = pt_config.get<unsigned int>("run.num_days");
+        vector<vector<unsigned int>> cases(lanes.size(), vector<unsigned int>(num_days));
+        for (unsigned int i = 0; i < num_days; i++) {
+                run_clock.Start();
+                ensemble.TimeStep();
+                run_clock.Stop();
+                for (size_t k = 0; k < lanes.size(); k++) {
+                        cases[k][i] = ensemble.GetInfectedCounts()[k];
+                }
+                if (ensemble.IsExtinct()) {
+                        for (auto& c : cases) {
+                                fill(c.begin() + i, c.end(), c[i]);
+                        }
+                        break;
+                }
+        }
+        total_clock.Stop();
+
+        for (size_t k = 0; k < lanes.size(); k++) {
+                CasesFile cases_file(lanes[k]->prefix);
+                cases_file.Print(cases[k]);
+                SummaryFile summary_file(lanes[k]->prefix);
+                summary_file.Print(lanes[k]->config,
+                        model.GetPopulation()->size(), cases[k].back(),
+                        duration_cast<milliseconds>(run_clock.Get()).count(),
+                        duration_cast<milliseconds>(total_clock.Get()).count(),
+                        common_random_numbers ? "crn" : "lockstep");
+        }
+
+        #pragma omp critical(ensemble_output)
+        cout << "Experiments " << setw(5) << lanes.front()->index << " .. " << setw(5) << lanes.back()->index
+                << " done in lockstep, threads: " << setw(3) << num_threads
+                << ", run_time: " << run_clock.ToString() << endl;
+
+        vector<unsigned int> final_cases;
+        for (const auto& c : cases) {
+                final_cases.push_back(c.back());
+        }
+        return final_cases;
+}
+
+}
+
+void run_ensemble(bool track_index_case, const string& ensemble_file_name)
+{
+        // -----------------------------------------------------------------------------------------
+        // Print output to command line.
+        // -----------------------------------------------------------------------------------------
+        cout << "\n*************************************************************" << endl;
+        cout << "Starting up at:      " << TimeStamp().ToString() << endl;
+        cout << "Executing:           " << InstallDirs::GetExecPath().string() << endl;
+        cout << "Current directory:   " << InstallDirs::GetCurrentDir().string() << endl;
+        cout << "Install directory:   " << InstallDirs::GetRootDir().string() << endl;
+        cout << "Data    directory:   " << InstallDirs::GetDataDir().string() << endl;
+
+        // -----------------------------------------------------------------------------------------
+        // Check execution environment.
+        // -----------------------------------------------------------------------------------------
+        if ( InstallDirs::GetCurrentDir().compare(InstallDirs::GetRootDir()) != 0 ) {
+                throw runtime_error(string(__func__) + "> Current directory is not install root! Aborting.");
+        }
+        if ( InstallDirs::GetDataDir().empty() ) {
+                throw runtime_error(string(__func__) + "> Data directory not present! Aborting.");
+        }
+
+        // -----------------------------------------------------------------------------------------
+        // Ensemble configuration.
+        // -----------------------------------------------------------------------------------------
+        ptree pt_ensemble;
+        const auto file_path = canonical(system_complete(ensemble_file_name));
+        if ( !is_regular_file(file_path) ) {
+                throw runtime_error(string(__func__)
+                        + ">Ensemble file " + file_path.string() + " not present. Aborting.");
+        }
+        read_json(file_path.string(), pt_ensemble);
+        cout << "Ensemble file:       " << file_path.string() << endl;
+
+        const unsigned int budget = pt_ensemble.get<unsigned int>("ensemble_threads", omp_get_max_threads());
+        SetSchedule(pt_ensemble.get<string>("omp_schedule", "STATIC,1"));
+        cout << "Thread budget:       " << budget << endl;
+
+        // -----------------------------------------------------------------------------------------
+        // Output directories, named as wrapper_stride.py does.
+        // -----------------------------------------------------------------------------------------
+        const auto output_tag = pt_ensemble.get<string>("output_tag", "");
+        const auto file_tag   = TimeStamp().ToTag() + (output_tag.empty() ? "" : "_" + output_tag);
+        const path output_dir = path("output") / file_tag;
+        const path exp_dir    = output_dir / "experiments";
+        create_directories(exp_dir);
+        copy_file(file_path, exp_dir / "exp_config.json", copy_option::overwrite_if_exists);
+        cout << "Project output tag:  " << file_tag << endl << endl;
+
+        // -----------------------------------------------------------------------------------------
+        // Experiments: all combinations, in the order of wrapper_stride.py.
+        // -----------------------------------------------------------------------------------------
+        ptree pt_common;
+        for (const string key : { "num_days", "generate_person_file", "num_participants_survey",
+                        "start_date", "holidays_file", "age_contact_matrix_file", "log_level" }) {
+                pt_common.put("run." + key, pt_ensemble.get<string>(key));
+        }
+        for (const string key : { "person_order", "partitioning", "storage", "storage_dir",
+                        "storage_map_persons", "huge_pages", "days_off", "restart_from" }) {
+                const auto value = pt_ensemble.get_optional<string>(key);
+                if (value) {
+                        pt_common.put("run." + key, *value);
+                }
+        }
+
+        // Scenarios (the innermost dimension): overrides of the run configuration, the first
+        // one being the baseline that the others are compared with.
+        vector<pair<string, vector<pair<string, string>>>> scenarios;
+        const auto pt_scenarios = pt_ensemble.get_child_optional("scenarios");
+        if (pt_scenarios) {
+                for (const auto& s : *pt_scenarios) {
+                        vector<pair<string, string>> overrides;
+                        for (const auto& key : g_scenario_keys) {
+                                const auto value = s.second.get_optional<string>(key);
+                                if (value) {
+                                        overrides.emplace_back("run." + key, *value);
+                                }
+                        }
+                        scenarios.emplace_back(s.second.get<string>("name", "scenario" + to_string(scenarios.size())), overrides);
+                }
+        }
+        if (scenarios.empty()) {
+                scenarios.emplace_back("baseline", vector<pair<string, string>>());
+        }
+
+        vector<Experiment> experiments;
+        for (const auto threads : GetValues<unsigned int>(pt_ensemble, "threads")) {
+        for (const auto& seed : GetValues<string>(pt_ensemble, "rng_seed")) {
+        for (const auto& seeding_rate : GetValues<string>(pt_ensemble, "seeding_rate")) {
+        for (const auto& r0 : GetValues<string>(pt_ensemble, "r0")) {
+        for (const auto& pop_file : GetValues<string>(pt_ensemble, "population_file")) {
+        for (const auto& immunity_rate : GetValues<string>(pt_ensemble, "immunity_rate")) {
+        for (const auto& disease_file : GetValues<string>(pt_ensemble, "disease_config_file")) {
+        for (unsigned int scenario = 0; scenario < scenarios.size(); scenario++) {
+                Experiment exp;
+                exp.index    = experiments.size();
+                exp.threads  = threads;
+                exp.scenario = scenario;
+                exp.config   = pt_common;
+                exp.config.put("run.rng_seed", seed);
+                exp.config.put("run.seeding_rate", seeding_rate);
+                exp.config.put("run.r0", r0);
+                exp.config.put("run.population_file", pop_file);
+                exp.config.put("run.immunity_rate", immunity_rate);
+                exp.config.put("run.disease_config_file", disease_file);
+                for (const auto& o : scenarios[scenario].second) {
+                        exp.config.put(o.first, o.second);
+                }
+                exp.prefix   = (exp_dir / ("exp" + to_string(exp.index))).string();
+                exp.config.put("run.output_prefix", exp.prefix);
+                experiments.push_back(exp);
+        }}}}}}}}
+
+        // Diseases: in lockstep, the experiments that differ in their disease only share one
+        // traversal of the clusters.
+        map<string, ptree> diseases;
+        for (const auto& disease_file : GetValues<string>(pt_ensemble, "disease_config_file")) {
+                const auto file_path_d = InstallDirs::GetDataDir() / disease_file;
+                if ( !is_regular_file(file_path_d) ) {
+                        throw runtime_error(string(__func__) + "> No file " + file_path_d.string());
+                }
+                read_xml(file_path_d.string(), diseases[disease_file]);
+        }
+
+        // Engine: a Simulator per replica, or replicas in lockstep (without logs), with
+        // common random numbers for all scenarios of a seed or not.
+        const auto engine   = pt_ensemble.get<string>("engine", "replicas");
+        const bool crn      = (engine == "crn");
+        const bool lockstep = (engine == "lockstep" || crn);
+        if ( !lockstep && engine != "replicas" ) {
+                throw runtime_error(string(__func__) + "> Invalid input for engine: " + engine);
+        }
+        if ( lockstep && pt_common.get<string>("run.log_level") != "None" ) {
+                throw runtime_error(string(__func__) + "> The lockstep engine does not write logs.");
+        }
+        if ( lockstep && pt_common.get_optional<string>("run.restart_from") ) {
+                throw runtime_error(string(__func__) + "> The lockstep engine does not restart from checkpoints.");
+        }
+
+        // -----------------------------------------------------------------------------------------
+        // Per population file: build it once, then run its replicas. Replicas run concurrently,
+        // each on its own share of the threads; with contact or transmission logs they share
+        // the logger and run one at a time.
+        // -----------------------------------------------------------------------------------------
+        Stopwatch<> total_clock("total_clock", true);
+        vector<unsigned int> final_cases(experiments.size());
+        spdlog::set_async_mode(1048576);
+        omp_set_max_active_levels(2);
+        vector<string> pop_files;
+        for (const auto& exp : experiments) {
+                const auto pop_file = exp.config.get<string>("run.population_file");
+                if (find(pop_files.begin(), pop_files.end(), pop_file) == pop_files.end()) {
+                        pop_files.push_back(pop_file);
+                }
+        }
+        for (const auto& pop_file : pop_files) {
+                cout << "Building the population for " << pop_file << "." << endl;
+                vector<const Experiment*> batch;
+                for (const auto& exp : experiments) {
+                        if (exp.config.get<string>("run.population_file") == pop_file) {
+                                batch.push_back(&exp);
+                        }
+                }
+
+                // The model is never run; the replicas do their own partitioning and placement.
+                ptree pt_model = batch.front()->config;
+                pt_model.put("run.log_level", "None");
+                pt_model.put("run.partitioning", "none");
+                const auto model = SimulatorBuilder::Build(pt_model, 1U, false);
+
+                vector<unsigned int> thread_counts;
+                for (const auto exp : batch) {
+                        if (find(thread_counts.begin(), thread_counts.end(), exp->threads) == thread_counts.end()) {
+                                thread_counts.push_back(exp->threads);
+                        }
+                }
+                for (const auto threads : thread_counts) {
+                        // Units of work: single replicas or, in lockstep, up to 64 replicas
+                        // that differ in their seed, scenario and disease only.
+                        vector<vector<const Experiment*>> units;
+                        for (const auto exp : batch) {
+                                if (exp->threads != threads) {
+                                        continue;
+                                }
+                                auto unit = units.begin();
+                                if (lockstep) {
+                                        unit = find_if(units.begin(), units.end(), [exp](const vector<const Experiment*>& u) {
+                                                return u.size() < LockstepEnsemble::MaxReplicas()
+                                                        && SameBut(u.front()->config, exp->config, g_lane_keys); });
+                                } else {
+                                        unit = units.end();
+                                }
+                                if (unit == units.end()) {
+                                        units.emplace_back(1U, exp);
+                                } else {
+                                        unit->push_back(exp);
+                                }
+                        }
+                        // Thread counts per slot: a slot runs one replica after the other.
+                        const bool serial   = pt_common.get<string>("run.log_level") != "None";
+                        const auto schedule = Schedule(budget, threads, serial ? 1U : units.size());
+                        cout << "Running " << units.size() << (lockstep ? " lockstep ensembles, " : " replicas, ")
+                                << schedule.size() << " at a time with " << schedule.back();
+                        if (schedule.front() != schedule.back()) {
+                                cout << " to " << schedule.front();
+                        }
+                        cout << " threads each." << endl;
+
+                        string error;
+                        #pragma omp parallel for num_threads(schedule.size()) schedule(dynamic, 1)
+                        for (size_t i = 0; i < units.size(); i++) {
+                                try {
+                                        const unsigned int num_threads = schedule[omp_get_thread_num()];
+                                        omp_set_num_threads(num_threads);
+                                        if (lockstep) {
+                                                const auto lane_cases = RunLockstep(*model, diseases, units[i],
+                                                        num_threads, track_index_case, crn);
+                                                for (size_t k = 0; k < units[i].size(); k++) {
+                                                        final_cases[units[i][k]->index] = lane_cases[k];
+                                                }
+                                        } else {
+                                                const Experiment& exp = *units[i].front();
+                                                final_cases[exp.index] = RunReplica(*model,
+                                                        diseases.at(exp.config.get<string>("run.disease_config_file")),
+                                                        exp, num_threads, track_index_case);
+                                        }
+                                } catch (exception& e) {
+                                        #pragma omp critical(ensemble_error)
+                                        error = e.what();
+                                }
+                        }
+                        if ( !error.empty() ) {
+                                throw runtime_error(string(__func__) + "> Replica failed: " + error);
+                        }
+                }
+        }
+        total_clock.Stop();
+
+        // -----------------------------------------------------------------------------------------
+        // Aggregated outputs, as wrapper_stride.py writes them.
+        // -----------------------------------------------------------------------------------------
+        ofstream summary_file((output_dir / (file_tag + "_summary.csv")).string());
+        ofstream cases_file((output_dir / (file_tag + "_cases.csv")).string());
+        for (const auto& exp : experiments) {
+                ifstream exp_summary(exp.prefix + "_summary.csv");
+                string line;
+                for (unsigned int l = 0; getline(exp_summary, line); l++) {
+                        if (exp.index == 0U || l > 0U) {
+                                summary_file << line << '\n';
+                        }
+                }
+                ifstream exp_cases(exp.prefix + "_cases.csv");
+                cases_file << exp_cases.rdbuf();
+                exp_summary.close();
+                exp_cases.close();
+                boost::filesystem::remove(exp.prefix + "_summary.csv");
+                boost::filesystem::remove(exp.prefix + "_cases.csv");
+        }
+
+        // -----------------------------------------------------------------------------------------
+        // Scenarios: final cases paired with those of the baseline run with the same seed
+        // (and other settings), with the standard errors of the mean difference as paired
+        // and as independent samples.
+        // -----------------------------------------------------------------------------------------
+        if (scenarios.size() > 1U) {
+                ofstream paired_file((output_dir / (file_tag + "_paired.csv")).string());
+                paired_file << "scenario,name,num_pairs,mean_baseline,mean_scenario,"
+                        << "mean_difference,sd_difference,se_paired,se_unpaired\n";
+                cout << endl << "Final cases, paired with the baseline (" << scenarios.front().first << "):" << endl;
+                for (unsigned int s = 1; s < scenarios.size(); s++) {
+                        vector<double> baseline;
+                        vector<double> scenario;
+                        vector<double> difference;
+                        for (const auto& exp : experiments) {
+                                if (exp.scenario == s) {
+                                        baseline.push_back(final_cases[exp.index - s]);
+                                        scenario.push_back(final_cases[exp.index]);
+                                        difference.push_back(scenario.back() - baseline.back());
+                                }
+                        }
+                        const size_t n   = difference.size();
+                        const auto mb    = Moments(baseline);
+                        const auto ms    = Moments(scenario);
+                        const auto md    = Moments(difference);
+                        const double se_paired   = sqrt(md.second / n);
+                        const double se_unpaired = sqrt((mb.second + ms.second) / n);
+                        paired_file << s << "," << scenarios[s].first << "," << n << "," << mb.first << ","
+                                << ms.first << "," << md.first << "," << sqrt(md.second) << ","
+                                << se_paired << "," << se_unpaired << "\n";
+                        cout << "  " << setw(20) << left << scenarios[s].first << right
+                                << " difference: " << setw(12) << md.first
+                                << " +/- " << setw(10) << se_paired << " (paired), "
+                                << setw(10) << se_unpaired << " (unpaired), " << n << " pairs" << endl;
+                }
+        }
+
+        // -----------------------------------------------------------------------------------------
+        // Print final message to command line.
+        // -----------------------------------------------------------------------------------------
+        cout << endl << endl;
+        cout << "  total time: " << total_clock.ToString() << endl << endl;
+        cout << "Exiting at:         " << TimeStamp().ToString() << endl << endl;
+}
+
+} // end_of_namespace
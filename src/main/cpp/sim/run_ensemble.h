@@ -0,0 +1,38 @@
+#ifndef RUN_ENSEMBLE_H_INCLUDED
+#define RUN_ENSEMBLE_H_INCLUDED
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Header for running an ensemble of simulations.
+ */
+
+#include <string>
+
+namespace stride {
+
+/**
+ * Run all experiments described by a wrapper configuration (json, as used by
+ * wrapper_stride.py) in this process. The population and its clusters are built
+ * once per population file and copied for every experiment (replica); replicas run
+ * concurrently as far as the thread budget (OMP_NUM_THREADS) allows, each with the
+ * number of threads given for it in the configuration.
+ */
+void run_ensemble(bool track_index_case, const std::string& ensemble_file_name);
+
+} // end_of_namespace
+
+#endif // end-of-include-guard
@@ -20,14 +20,23 @@
 
 # include "run_stride.h"
 
+#include "core/ClusterType.h"
 #include "output/CasesFile.h"
+#include "output/OffspringFile.h"
 #include "output/PersonFile.h"
+#include "output/RegionsFile.h"
 #include "output/SummaryFile.h"
+#include "output/TimingsFile.h"
+#include "sim/DistributedSimulator.h"
+#include "sim/IndexCaseTrials.h"
+#include "sim/Metapopulation.h"
 #include "sim/Simulator.h"
 #include "sim/SimulatorBuilder.h"
+#include "sim/SimulatorCheckpoint.h"
 #include "util/ConfigInfo.h"
 #include "util/InstallDirs.h"
 #include "util/Stopwatch.h"
+#include "util/ThreadPinning.h"
 #include "util/TimeStamp.h"
 
 #include <boost/property_tree/ptree.hpp>
@@ -36,6 +45,7 @@
 #include <omp.h>
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
 #include <cmath>
 #include <iomanip>
 #include <ios>
@@ -43,6 +53,7 @@
 #include <limits>
 #include <string>
 #include <stdexcept>
+#include <vector>
 
 namespace stride {
 
@@ -56,6 +67,11 @@ using namespace std::chrono;
 /// Run the stride simulator.
 void run_stride(bool track_index_case, const string& config_file_name)
 {
+        // With mpirun, only the first process reports.
+        if (DistributedSimulator::GetWorldRank() > 0U) {
+                cout.setstate(ios_base::badbit);
+        }
+
         // -----------------------------------------------------------------------------------------
         // Print output to command line.
         // -----------------------------------------------------------------------------------------
@@ -118,6 +134,19 @@ void run_stride(bool track_index_case, const string& config_file_name)
                 pt_config.put("run.num_participants_survey", 1);
         }
 
+        // -----------------------------------------------------------------------------------------
+        // Pathogens: one, or several in the one population (run.disease_config_file list).
+        // -----------------------------------------------------------------------------------------
+        const auto pathogens = SimulatorBuilder::GetPathogenConfigs(pt_config);
+        if (pathogens.size() > 1U) {
+                cout << "Pathogens:           " << pt_config.get<string>("run.disease_config_file") << endl;
+                if ( !pt_config.get<string>("run.regions_file", "").empty() || DistributedSimulator::GetWorldSize() > 1U
+                        || (track_index_case && pt_config.get<unsigned int>("run.r0_trials", 0U) > 0U) ) {
+                        throw runtime_error(string(__func__) + "> Several pathogens only run in a single simulator,"
+                                " without regions, processes or index case trials.");
+                }
+        }
+
         // -----------------------------------------------------------------------------------------
         // Track index case setting.
         // -----------------------------------------------------------------------------------------
@@ -133,43 +162,214 @@ void run_stride(bool track_index_case, const string& config_file_name)
                 std::numeric_limits<size_t>::max(),  std::numeric_limits<size_t>::max());
         file_logger->set_pattern("%v"); // Remove meta data from log => time-stamp of logging
 
+        Stopwatch<> total_clock("total_clock", true);
+
+        // -----------------------------------------------------------------------------------------
+        // Regions coupled by commuting (if so configured) rather than one population.
+        // -----------------------------------------------------------------------------------------
+        if ( !pt_config.get<string>("run.regions_file", "").empty() ) {
+                cout << "Building the regions. "<< endl;
+                Metapopulation metapopulation(pt_config, num_threads);
+                size_t num_persons = 0U;
+                size_t num_commuters = 0U;
+                for (size_t r = 0; r < metapopulation.GetNumRegions(); r++) {
+                        num_persons   += metapopulation.GetRegion(r).num_persons;
+                        num_commuters += metapopulation.GetRegion(r).num_commuters;
+                }
+                cout << "Done building " << metapopulation.GetNumRegions() << " regions: " << num_persons
+                        << " persons, " << num_commuters << " commuters." << endl << endl;
+
+                Stopwatch<> run_clock("run_clock");
+                const unsigned int num_days = pt_config.get<unsigned int>("run.num_days");
+                vector<unsigned int> cases;
+                vector<vector<unsigned int>> region_cases(metapopulation.GetNumRegions());
+                for (unsigned int i = 0; i < num_days; i++) {
+                        cout << "Simulating day: " << setw(5) << i;
+                        run_clock.Start();
+                        metapopulation.TimeStep();
+                        run_clock.Stop();
+                        cases.push_back(0U);
+                        for (size_t r = 0; r < metapopulation.GetNumRegions(); r++) {
+                                region_cases[r].push_back(metapopulation.GetInfectedCount(r));
+                                cases.back() += region_cases[r].back();
+                        }
+                        cout << "     Done, infected count: " << setw(10) << cases[i] << endl;
+                }
+
+                CasesFile    cases_file(output_prefix);
+                cases_file.Print(cases);
+                SummaryFile  summary_file(output_prefix);
+                summary_file.Print(pt_config, num_persons, metapopulation.GetInfectedCount(),
+                        duration_cast<milliseconds>(run_clock.Get()).count(),
+                        duration_cast<milliseconds>(total_clock.Get()).count());
+                RegionsFile  regions_file(output_prefix);
+                regions_file.Print(metapopulation, region_cases);
+
+                cout << endl << endl;
+                cout << "  run_time: " << run_clock.ToString()
+                                        << "  -- total time: " << total_clock.ToString() << endl << endl;
+                cout << "Exiting at:         " << TimeStamp().ToString() << endl << endl;
+                return;
+        }
+
         // -----------------------------------------------------------------------------------------
         // Create simulator.
         // -----------------------------------------------------------------------------------------
-        Stopwatch<> total_clock("total_clock", true);
         cout << "Building the simulator. "<< endl;
         auto sim = SimulatorBuilder::Build(pt_config, num_threads, track_index_case);
-        cout << "Done building the simulator. "<< endl <<endl;
+        cout << "Done building the simulator. "<< endl;
+        cout << "Thread layout (thread:cpu/node): " << ThreadPinning::ToString(sim->GetThreadCpus()) << endl;
+        const auto& partition = sim->GetPartition();
+        if ( !partition.IsEmpty() ) {
+                cout << "Partitioned over " << partition.GetNumPartitions() << " threads, "
+                        << partition.GetNumCut() << " of " << partition.GetNumMemberships()
+                        << " cluster memberships cut." << endl;
+        }
+        if (sim->GetAgeMixing() != nullptr) {
+                cout << "Age-structured mixing in " << sim->GetAgeMixing()->GetNumBins() << " age groups." << endl;
+        } else if (sim->GetMeanFieldRule().IsEnabled()) {
+                cout << "Mean field transmission in " << sim->GetMeanFieldRule().ToString() << endl;
+        }
 
         // -----------------------------------------------------------------------------------------
-        // Run the simulation.
+        // Distributed over the processes started by mpirun (if more than one).
+        // -----------------------------------------------------------------------------------------
+        if (DistributedSimulator::GetWorldSize() > 1U) {
+                DistributedSimulator distributed(sim);
+                const auto& ranks = distributed.GetPartition();
+                cout << "Distributed over " << ranks.GetNumPartitions() << " processes, "
+                        << ranks.GetNumCut() << " of " << ranks.GetNumMemberships()
+                        << " cluster memberships cut." << endl << endl;
+
+                Stopwatch<> run_clock("run_clock");
+                const unsigned int num_days = pt_config.get<unsigned int>("run.num_days");
+                vector<unsigned int> cases;
+                for (unsigned int i = 0; i < num_days; i++) {
+                        cout << "Simulating day: " << setw(5) << i;
+                        run_clock.Start();
+                        distributed.TimeStep();
+                        run_clock.Stop();
+                        cases.push_back(distributed.GetInfectedCount());
+                        cout << "     Done, infected count: " << setw(10) << cases[i] << endl;
+                }
+
+                if (DistributedSimulator::GetWorldRank() == 0U) {
+                        CasesFile    cases_file(output_prefix);
+                        cases_file.Print(cases);
+                        SummaryFile  summary_file(output_prefix);
+                        summary_file.Print(pt_config, sim->GetPopulation()->size(), distributed.GetInfectedCount(),
+                                duration_cast<milliseconds>(run_clock.Get()).count(),
+                                duration_cast<milliseconds>(total_clock.Get()).count(),
+                                ThreadPinning::ToString(sim->GetThreadCpus()));
+                }
+
+                cout << endl << endl;
+                cout << "  run_time: " << run_clock.ToString()
+                                        << "  -- total time: " << total_clock.ToString() << endl << endl;
+                cout << "Exiting at:         " << TimeStamp().ToString() << endl << endl;
+                return;
+        }
+
+        // -----------------------------------------------------------------------------------------
+        // R0 only, from independent index case trials (if so configured) rather than time steps.
+        // -----------------------------------------------------------------------------------------
+        const unsigned int num_trials = pt_config.get<unsigned int>("run.r0_trials", 0U);
+        if (track_index_case && num_trials > 0U) {
+                ptree pt_disease;
+                const auto file_path_d = InstallDirs::GetDataDir() / pt_config.get<string>("run.disease_config_file");
+                if ( !is_regular_file(file_path_d) ) {
+                        throw runtime_error(string(__func__) + "> No file " + file_path_d.string());
+                }
+                read_xml(file_path_d.string(), pt_disease);
+
+                Stopwatch<> run_clock("run_clock", true);
+                const IndexCaseTrials trials(*sim, pt_config, pt_disease, num_threads);
+                const auto distribution = IndexCaseTrials::GetDistribution(trials.Run(num_trials));
+                run_clock.Stop();
+
+                OffspringFile offspring_file(output_prefix);
+                offspring_file.Print(distribution);
+
+                double mean = 0.0;
+                double mean_square = 0.0;
+                for (size_t k = 0; k < distribution.size(); k++) {
+                        mean        += static_cast<double>(k * distribution[k]) / num_trials;
+                        mean_square += static_cast<double>(k * k * distribution[k]) / num_trials;
+                }
+                cout << endl << "Index case trials: " << num_trials << ", mean offspring (R0): " << mean
+                        << " +/- " << sqrt((mean_square - mean * mean) / num_trials) << endl << endl;
+                cout << "  run_time: " << run_clock.ToString()
+                                        << "  -- total time: " << total_clock.ToString() << endl << endl;
+                cout << "Exiting at:         " << TimeStamp().ToString() << endl << endl;
+                return;
+        }
+
+        // -----------------------------------------------------------------------------------------
+        // Restart from a checkpoint (if so configured).
+        // -----------------------------------------------------------------------------------------
+        // The daily case counts, of each pathogen in turn.
+        const size_t num_pathogens = sim->GetNumPathogens();
+        vector<unsigned int> cases;
+        const auto restart_from = pt_config.get<string>("run.restart_from", "");
+        if ( !restart_from.empty() ) {
+                const auto checkpoint_path = absolute(restart_from, InstallDirs::GetCurrentDir());
+                cases = SimulatorCheckpoint::Load(*sim, checkpoint_path);
+                cout << "Restarted from checkpoint " << checkpoint_path.string() << " after day " << cases.size() / num_pathogens << endl;
+        }
+        cout << endl;
+
+        // -----------------------------------------------------------------------------------------
+        // Run the simulation, with a checkpoint every checkpoint_interval days (if so configured).
         // -----------------------------------------------------------------------------------------
         Stopwatch<> run_clock("run_clock");
         const unsigned int num_days = pt_config.get<unsigned int>("run.num_days");
-        vector<unsigned int> cases(num_days);
-        for (unsigned int i = 0; i < num_days; i++) {
+        const unsigned int checkpoint_interval = pt_config.get<unsigned int>("run.checkpoint_interval", 0U);
+        SimulatorCheckpoint checkpoint(pt_config.get<bool>("run.checkpoint_incremental", false));
+        vector<double> times;
+        for (unsigned int i = cases.size() / num_pathogens; i < num_days; i++) {
                 cout << "Simulating day: " << setw(5) << i;
+                const auto before = run_clock.Get();
                 run_clock.Start();
                 sim->TimeStep();
                 run_clock.Stop();
+                times.push_back(duration<double, milli>(run_clock.Get() - before).count());
                 cout << "     Done, infected count: ";
-                cases[i] = sim->GetPopulation()->GetInfectedCount();
-                cout << setw(10) << cases[i] << endl;
+                // Once the epidemic is over, the counts no longer change.
+                const bool extinct = sim->IsExtinct() && !cases.empty();
+                for (size_t k = 0; k < num_pathogens; k++) {
+                        cases.push_back(extinct ? cases[cases.size() - num_pathogens] : sim->GetInfectedCount(k));
+                        cout << setw(10) << cases.back();
+                }
+                cout << endl;
+                if (checkpoint_interval > 0U && (i + 1U) % checkpoint_interval == 0U) {
+                        checkpoint.Save(*sim, cases, output_prefix + "_checkpoint_" + to_string(i + 1U) + ".bin");
+                }
         }
 
         // -----------------------------------------------------------------------------------------
         // Generate output files
         // -----------------------------------------------------------------------------------------
-        // Cases
+        // Cases and summary, a line for each pathogen.
         CasesFile    cases_file(output_prefix);
-        cases_file.Print(cases);
-
-        // Summary
         SummaryFile  summary_file(output_prefix);
-        summary_file.Print(pt_config,
-                sim->GetPopulation()->size(), sim->GetPopulation()->GetInfectedCount(),
-                duration_cast<milliseconds>(run_clock.Get()).count(),
-                duration_cast<milliseconds>(total_clock.Get()).count());
+        for (size_t k = 0; k < num_pathogens; k++) {
+                vector<unsigned int> pathogen_cases;
+                for (size_t j = k; j < cases.size(); j += num_pathogens) {
+                        pathogen_cases.push_back(cases[j]);
+                }
+                cases_file.Print(pathogen_cases);
+                summary_file.Print(pathogens[k],
+                        sim->GetPopulation()->size(), sim->GetInfectedCount(k),
+                        duration_cast<milliseconds>(run_clock.Get()).count(),
+                        duration_cast<milliseconds>(total_clock.Get()).count(),
+                        ThreadPinning::ToString(sim->GetThreadCpus()), sim->GetEngineDays());
+        }
+
+        // Run time of each day (if so configured)
+        if (pt_config.get<double>("run.generate_timings_file", 0) == 1) {
+                TimingsFile  timings_file(output_prefix);
+                timings_file.Print(times);
+        }
 
         // Persons
         if (pt_config.get<double>("run.generate_person_file") == 1) {
@@ -181,6 +381,18 @@ void run_stride(bool track_index_case, const string& config_file_name)
         // Print final message to command line.
         // -----------------------------------------------------------------------------------------
         cout << endl << endl;
+        if (sim->GetMeanFieldRule().IsEnabled()) {
+                cout << "  mean field cluster updates:";
+                for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+                        cout << "  " << ToString(static_cast<ClusterType>(t)) << " " << sim->GetNumMeanField()[t];
+                }
+                cout << endl;
+        }
+        if (sim->GetClusterEngine() != Simulator::ClusterEngine::Dense) {
+                const auto& days = sim->GetEngineDays();
+                cout << "  cluster pass days:  dense " << count(days.begin(), days.end(), 'd')
+                        << "  sparse " << count(days.begin(), days.end(), 's') << endl;
+        }
         cout << "  run_time: " << run_clock.ToString()
                                 << "  -- total time: " << total_clock.ToString() << endl << endl;
         cout << "Exiting at:         " << TimeStamp().ToString() << endl << endl;
@@ -0,0 +1,92 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Implementation of the AliasTable class (Vose's construction).
+ */
+
+#include "AliasTable.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace stride {
+namespace util {
+
+using namespace std;
+
+AliasTable::AliasTable(const vector<double>& probabilities)
+        : m_prob(probabilities.size(), 1.0), m_alias(probabilities.size(), 0U)
+{
+        double total = 0.0;
+        for (const auto p : probabilities) {
+                total += max(p, 0.0);
+        }
+        if (probabilities.empty() || !(total > 0.0)) {
+                throw runtime_error(string(__func__) + "> Distribution without mass.");
+        }
+
+        // Scale to mean one and split in columns below and above the mean.
+        const size_t n = probabilities.size();
+        vector<double> scaled(n);
+        vector<unsigned int> small;
+        vector<unsigned int> large;
+        for (size_t i = 0; i < n; i++) {
+                scaled[i] = max(probabilities[i], 0.0) * n / total;
+                (scaled[i] < 1.0 ? small : large).push_back(static_cast<unsigned int>(i));
+        }
+
+        // Top up every small column with mass from a large one.
+        while (!small.empty() && !large.empty()) {
+                const auto s = small.back();
+                const auto l = large.back();
+                small.pop_back();
+                m_prob[s]  = scaled[s];
+                m_alias[s] = l;
+                scaled[l]  = (scaled[l] + scaled[s]) - 1.0;
+                if (scaled[l] < 1.0) {
+                        large.pop_back();
+                        small.push_back(l);
+                }
+        }
+        // Leftovers are full columns (up to rounding).
+        for (const auto i : large) {
+                m_prob[i]  = 1.0;
+                m_alias[i] = i;
+        }
+        for (const auto i : small) {
+                m_prob[i]  = 1.0;
+                m_alias[i] = i;
+        }
+}
+
+AliasTable AliasTable::FromCumulative(const vector<double>& cdf)
+{
+        vector<double> probabilities;
+        double previous = 0.0;
+        for (const auto c : cdf) {
+                probabilities.push_back(c - previous);
+                previous = max(previous, c);
+        }
+        if (previous < 1.0) {
+                probabilities.push_back(1.0 - previous);
+        }
+        return AliasTable(probabilities);
+}
+
+} // namespace
+} // namespace
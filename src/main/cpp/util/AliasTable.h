@@ -0,0 +1,65 @@
+#ifndef UTIL_ALIAS_TABLE_H_INCLUDED
+#define UTIL_ALIAS_TABLE_H_INCLUDED
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Header for the AliasTable class.
+ */
+
+#include <cstddef>
+#include <vector>
+
+namespace stride {
+namespace util {
+
+/**
+ * Walker's alias method: samples a discrete distribution over 0, ..., size() - 1
+ * in constant time from a single uniform number.
+ */
+class AliasTable
+{
+public:
+	/// Table for the given probabilities (that need not be normalized; negative ones count as zero).
+	explicit AliasTable(const std::vector<double>& probabilities);
+
+	/// Table for a distribution given by its cumulative probabilities: index i has probability
+	/// cdf[i] - cdf[i - 1]. Whatever mass the cdf leaves below one goes to index cdf.size().
+	static AliasTable FromCumulative(const std::vector<double>& cdf);
+
+	/// Sample an index, given a uniform number in [0, 1[.
+	unsigned int Sample(double uniform) const
+	{
+		const double x = uniform * m_prob.size();
+		std::size_t  i = static_cast<std::size_t>(x);
+		if (i >= m_prob.size()) {
+			i = m_prob.size() - 1;
+		}
+		return (x - i < m_prob[i]) ? static_cast<unsigned int>(i) : m_alias[i];
+	}
+
+	/// Number of outcomes.
+	std::size_t size() const { return m_prob.size(); }
+
+private:
+	std::vector<double>        m_prob;    ///< Probability of keeping the column's own index.
+	std::vector<unsigned int>  m_alias;   ///< Index for the remainder of the column.
+};
+
+} // namespace
+} // namespace
+
+#endif // end-of-include-guard
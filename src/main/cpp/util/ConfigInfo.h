@@ -38,6 +38,16 @@ public:
 	        return true;
 #else
 	        return false;
+#endif
+	}
+
+	///
+	static constexpr bool HaveMPI()
+	{
+#ifdef USE_MPI
+	        return true;
+#else
+	        return false;
 #endif
 	}
 };
@@ -0,0 +1,72 @@
+#ifndef UTIL_FINGERPRINT_H_INCLUDED
+#define UTIL_FINGERPRINT_H_INCLUDED
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Fingerprints of strings and files, used as keys for cached inputs.
+ */
+
+#include <boost/filesystem.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+namespace stride {
+namespace util {
+
+/**
+ * Fingerprints of strings and files.
+ */
+class Fingerprint
+{
+public:
+	/// FNV-1a hash of the string: stable across builds and platforms, unlike std::hash.
+	static std::uint64_t Hash(const std::string& s)
+	{
+		return Hash(s.data(), s.size());
+	}
+
+	/// FNV-1a hash of the bytes, continuing from the hash h of earlier bytes if given.
+	static std::uint64_t Hash(const void* data, std::size_t size, std::uint64_t h = 14695981039346656037ULL)
+	{
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+		for (std::size_t i = 0; i < size; i++) {
+			h ^= bytes[i];
+			h *= 1099511628211ULL;
+		}
+		return h;
+	}
+
+	/// Identification of a file by name, size and modification time (name only if absent).
+	static std::string FileStamp(const boost::filesystem::path& file_path)
+	{
+		std::ostringstream oss;
+		oss << file_path.filename().string();
+		if (boost::filesystem::is_regular_file(file_path)) {
+			oss << ":" << boost::filesystem::file_size(file_path)
+			        << ":" << boost::filesystem::last_write_time(file_path);
+		}
+		return oss.str();
+	}
+};
+
+} // namespace
+} // namespace
+
+#endif // end-of-include-guard
@@ -0,0 +1,126 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Implementation of the InputBuffer class.
+ */
+
+#include "InputBuffer.h"
+
+#include <boost/iostreams/copy.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+
+namespace stride {
+namespace util {
+
+using namespace std;
+using namespace boost::filesystem;
+namespace io = boost::iostreams;
+
+namespace {
+
+/// Does the data start with the gzip magic number?
+bool IsGzip(const char* first, const char* last)
+{
+        return (last - first) >= 2
+                && static_cast<unsigned char>(first[0]) == 0x1f
+                && static_cast<unsigned char>(first[1]) == 0x8b;
+}
+
+/// Inflate gzip compressed data.
+string Inflate(const char* first, const char* last)
+{
+        string inflated;
+        io::filtering_istream in;
+        in.push(io::gzip_decompressor());
+        in.push(io::array_source(first, last));
+        io::copy(in, io::back_inserter(inflated));
+        return inflated;
+}
+
+}
+
+InputBuffer::InputBuffer(const path& file_path)
+        : m_begin(nullptr), m_end(nullptr)
+{
+        if ( !is_regular_file(file_path) ) {
+                throw runtime_error(string(__func__) + "> File " + file_path.string() + " not present.");
+        }
+        if (file_size(file_path) == 0U) {
+                // Empty files cannot be mapped.
+                return;
+        }
+        m_mapped.open(file_path.string());
+        if ( !m_mapped.is_open() ) {
+                throw runtime_error(string(__func__) + "> Error mapping file " + file_path.string());
+        }
+        m_begin = m_mapped.data();
+        m_end   = m_begin + m_mapped.size();
+
+        if (IsGzip(m_begin, m_end)) {
+                string inflated = Inflate(m_begin, m_end);
+                m_mapped.close();
+                Adopt(move(inflated));
+        }
+}
+
+InputBuffer::InputBuffer(istream& is)
+        : m_begin(nullptr), m_end(nullptr)
+{
+        string contents {istreambuf_iterator<char>(is), istreambuf_iterator<char>()};
+        if (IsGzip(contents.data(), contents.data() + contents.size())) {
+                contents = Inflate(contents.data(), contents.data() + contents.size());
+        }
+        Adopt(move(contents));
+}
+
+void InputBuffer::Adopt(string&& contents)
+{
+        m_inflated = move(contents);
+        m_begin    = m_inflated.data();
+        m_end      = m_begin + m_inflated.size();
+}
+
+vector<pair<const char*, const char*>> InputBuffer::SplitLines(
+        const char* first, const char* last, size_t num_chunks)
+{
+        vector<pair<const char*, const char*>> chunks;
+        const size_t chunk_size = max<size_t>(1U, static_cast<size_t>(last - first) / max<size_t>(1U, num_chunks));
+
+        const char* chunk_begin = first;
+        while (chunk_begin < last) {
+                const char* chunk_end = chunk_begin + min(chunk_size, static_cast<size_t>(last - chunk_begin));
+                if (chunk_end < last) {
+                        // Extend up to and including the next newline.
+                        const void* nl = memchr(chunk_end, '\n', static_cast<size_t>(last - chunk_end));
+                        chunk_end = (nl != nullptr) ? static_cast<const char*>(nl) + 1 : last;
+                }
+                chunks.emplace_back(chunk_begin, chunk_end);
+                chunk_begin = chunk_end;
+        }
+        return chunks;
+}
+
+} // namespace
+} // namespace
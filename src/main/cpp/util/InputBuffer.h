@@ -0,0 +1,85 @@
+#ifndef UTIL_INPUT_BUFFER_H_INCLUDED
+#define UTIL_INPUT_BUFFER_H_INCLUDED
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Header for the InputBuffer class.
+ */
+
+#include <boost/filesystem.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace stride {
+namespace util {
+
+/**
+ * Read-only view on the contents of an input file or stream. Plain files are
+ * memory-mapped; gzip compressed input is inflated into memory.
+ */
+class InputBuffer
+{
+public:
+	/// Map the file, or inflate it when it is gzip compressed.
+	explicit InputBuffer(const boost::filesystem::path& file_path);
+
+	/// Read the stream up to its end, inflating it when it is gzip compressed.
+	explicit InputBuffer(std::istream& is);
+
+	/// No copies: the view points into storage owned by this object.
+	InputBuffer(const InputBuffer&) = delete;
+
+	/// No copies: the view points into storage owned by this object.
+	InputBuffer& operator=(const InputBuffer&) = delete;
+
+	/// Start of the contents.
+	const char* begin() const { return m_begin; }
+
+	/// One past the end of the contents.
+	const char* end() const { return m_end; }
+
+	/// Number of bytes of contents.
+	std::size_t size() const { return static_cast<std::size_t>(m_end - m_begin); }
+
+	/// Is the contents served from a memory map (rather than from an inflated copy)?
+	bool IsMapped() const { return m_mapped.is_open(); }
+
+	/// Split [first, last[ in at most num_chunks pieces, each of which ends right after a newline
+	/// (or at last). Pieces are in order and together cover [first, last[ exactly.
+	static std::vector<std::pair<const char*, const char*>> SplitLines(
+	        const char* first, const char* last, std::size_t num_chunks);
+
+private:
+	/// Take over (and inflate if need be) the contents in the string.
+	void Adopt(std::string&& contents);
+
+private:
+	boost::iostreams::mapped_file_source  m_mapped;     ///< Memory map for plain files.
+	std::string                           m_inflated;   ///< Contents for gzip compressed or streamed input.
+	const char*                           m_begin;      ///< Start of contents.
+	const char*                           m_end;        ///< One past the end of contents.
+};
+
+} // namespace
+} // namespace
+
+#endif // end-of-include-guard
@@ -0,0 +1,155 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Implementation of the NumaPolicy class.
+ */
+
+#include "NumaAllocator.h"
+
+#include <stdexcept>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define STRIDE_USE_MMAP
+#endif
+
+namespace stride {
+namespace util {
+
+using namespace std;
+
+namespace {
+
+/// Blocks from this size up are mapped directly.
+const size_t g_large_block = size_t(1) << 21;
+
+/// Block to be returned by the next allocation of the thread (see AdoptNext).
+thread_local void* g_adopt_block = nullptr;
+
+/// Size of the block to be adopted.
+thread_local size_t g_adopt_bytes = 0U;
+
+#ifdef STRIDE_USE_MMAP
+/// Map a block from a fresh file in the directory; the file is gone once the block is unmapped.
+void* MapFile(const string& dir, size_t bytes)
+{
+        string name = dir + "/stride_storage_XXXXXX";
+        vector<char> templ(name.begin(), name.end());
+        templ.push_back('\0');
+        const int fd = mkstemp(templ.data());
+        if (fd < 0) {
+                throw runtime_error(string(__func__) + "> Cannot create storage file in " + dir);
+        }
+        unlink(templ.data());
+        if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+                close(fd);
+                throw runtime_error(string(__func__) + "> Cannot size storage file in " + dir);
+        }
+        void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (p == MAP_FAILED) {
+                throw bad_alloc();
+        }
+        return p;
+}
+#endif
+
+}
+
+void* NumaPolicy::Allocate(size_t bytes, Access access, const Storage* storage)
+{
+        if (g_adopt_block != nullptr && bytes == g_adopt_bytes) {
+                void* p = g_adopt_block;
+                g_adopt_block = nullptr;
+                return p;
+        }
+#ifdef STRIDE_USE_MMAP
+        if (bytes >= g_large_block) {
+                static const Storage in_memory {};
+                const Storage& s = storage ? *storage : in_memory;
+                void* p = nullptr;
+                if ( !s.dir.empty() && (access == Access::Sequential || s.map_random) ) {
+                        p = MapFile(s.dir, bytes);
+                        // Read ahead and drop pages behind for blocks that are streamed through.
+                        if (access == Access::Sequential) {
+                                madvise(p, bytes, MADV_SEQUENTIAL);
+                        }
+                } else {
+                        p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                        if (p == MAP_FAILED) {
+                                throw bad_alloc();
+                        }
+#ifdef MADV_HUGEPAGE
+                        if (s.huge_pages) {
+                                // Only advice: without transparent huge pages we simply get normal pages.
+                                madvise(p, bytes, MADV_HUGEPAGE);
+                        }
+#endif
+                }
+                return p;
+        }
+#endif
+        return ::operator new(bytes);
+}
+
+void NumaPolicy::Deallocate(void* p, size_t bytes)
+{
+#ifdef STRIDE_USE_MMAP
+        if (bytes >= g_large_block) {
+                munmap(p, bytes);
+                return;
+        }
+#endif
+        ::operator delete(p);
+}
+
+void* NumaPolicy::MapShared(const string& file, size_t offset, size_t bytes)
+{
+#ifdef STRIDE_USE_MMAP
+        const int fd = open(file.c_str(), O_RDONLY);
+        if (fd < 0) {
+                return nullptr;
+        }
+        void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, static_cast<off_t>(offset));
+        close(fd);
+        return (p == MAP_FAILED) ? nullptr : p;
+#else
+        return nullptr;
+#endif
+}
+
+bool NumaPolicy::AdoptNext(void* p, size_t bytes)
+{
+#ifdef STRIDE_USE_MMAP
+        // Deallocate only unmaps large blocks.
+        if (bytes < g_large_block) {
+                munmap(p, bytes);
+                return false;
+        }
+        g_adopt_block = p;
+        g_adopt_bytes = bytes;
+        return true;
+#else
+        return false;
+#endif
+}
+
+} // namespace
+} // namespace
@@ -0,0 +1,130 @@
+#ifndef UTIL_NUMA_ALLOCATOR_H_INCLUDED
+#define UTIL_NUMA_ALLOCATOR_H_INCLUDED
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Header for the NumaAllocator class.
+ */
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <string>
+#include <utility>
+
+namespace stride {
+namespace util {
+
+/// How a block is gone through by the simulation.
+enum class Access
+{
+	Random,         ///< Accessed all over (persons).
+	Sequential      ///< Streamed through from front to back (cluster members).
+};
+
+/// Where the large blocks of a simulator are kept (the defaults: in memory, normal pages).
+struct Storage
+{
+	bool           huge_pages = false;   ///< Back large blocks in memory by transparent huge pages.
+	std::string    dir;                  ///< Map large blocks from files in this directory (empty for memory).
+	bool           map_random = false;   ///< Map randomly accessed blocks from files too (else only sequential ones).
+};
+
+/**
+ * Storage for the large arrays of the simulator. Large blocks are mapped
+ * directly from the operating system, so no page is placed on a NUMA node
+ * before some thread first touches it; optionally they are backed by
+ * transparent huge pages. With a storage directory, large blocks are mapped
+ * from (unlinked) files in that directory instead, so the operating system can
+ * write them out and read them back in when they do not fit in memory.
+ */
+class NumaPolicy
+{
+public:
+	/// Allocate the given number of bytes (page aligned and untouched for large blocks),
+	/// kept as the storage says (in memory with normal pages if there is none).
+	static void* Allocate(std::size_t bytes, Access access = Access::Random, const Storage* storage = nullptr);
+
+	/// Release a block obtained from Allocate with the same number of bytes.
+	static void Deallocate(void* p, std::size_t bytes);
+
+	/// Map bytes [offset, offset + bytes[ of the file copy-on-write: the pages are shared with
+	/// every other process that maps the file, up to the first write to them. The offset must be
+	/// a multiple of the page size. Returns nullptr if the region cannot be mapped.
+	static void* MapShared(const std::string& file, std::size_t offset, std::size_t bytes);
+
+	/// Have the next allocation of exactly bytes by the calling thread return the block
+	/// obtained from MapShared, so that a container takes over the mapped contents.
+	/// Returns false (and unmaps the block) if the block is too small to be adopted.
+	static bool AdoptNext(void* p, std::size_t bytes);
+};
+
+/**
+ * Allocator for containers of the simulator's large arrays, with the storage of the
+ * simulator they belong to. Elements that are constructed without arguments are
+ * default-initialized, i.e. left untouched for trivial types, so that the thread that
+ * later fills them in places their pages. Blocks can be released by any allocator,
+ * whatever its storage: all allocators compare equal.
+ */
+template<typename T, Access access = Access::Random>
+class NumaAllocator
+{
+public:
+	using value_type = T;
+
+	template<typename U>
+	struct rebind { using other = NumaAllocator<U, access>; };
+
+	NumaAllocator() = default;
+
+	/// Allocator for blocks kept as the storage says.
+	explicit NumaAllocator(std::shared_ptr<const Storage> storage) : m_storage(std::move(storage)) {}
+
+	template<typename U>
+	NumaAllocator(const NumaAllocator<U, access>& other) : m_storage(other.GetStorage()) {}
+
+	/// The storage of the blocks (nullptr for the defaults).
+	const std::shared_ptr<const Storage>& GetStorage() const { return m_storage; }
+
+	///
+	T* allocate(std::size_t n) { return static_cast<T*>(NumaPolicy::Allocate(n * sizeof(T), access, m_storage.get())); }
+
+	///
+	void deallocate(T* p, std::size_t n) { NumaPolicy::Deallocate(p, n * sizeof(T)); }
+
+	/// Default-initialize rather than value-initialize.
+	template<typename U>
+	void construct(U* p) { ::new (static_cast<void*>(p)) U; }
+
+	///
+	template<typename U, typename... Args>
+	void construct(U* p, Args&&... args) { ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...); }
+
+private:
+	std::shared_ptr<const Storage>   m_storage;   ///< Storage of the blocks.
+};
+
+template<typename T, typename U, Access access>
+bool operator==(const NumaAllocator<T, access>&, const NumaAllocator<U, access>&) { return true; }
+
+template<typename T, typename U, Access access>
+bool operator!=(const NumaAllocator<T, access>&, const NumaAllocator<U, access>&) { return false; }
+
+} // namespace
+} // namespace
+
+#endif // end-of-include-guard
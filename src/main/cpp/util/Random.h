@@ -24,6 +24,10 @@
 #include <trng/uniform01_dist.hpp>
 #include <trng/uniform_int_dist.hpp>
 
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
 namespace stride {
 namespace util {
 
@@ -54,6 +58,12 @@ public:
 		return dis(m_engine);
 	}
 
+	/// Advance the engine as if n numbers had been drawn.
+	void Discard(unsigned long long n)
+	{
+		m_engine.discard(n);
+	}
+
 	/**
 	 * Split random engines
 	 * E. g. stream 0 1 2 3 4 5...
@@ -65,6 +75,23 @@ public:
 		m_engine.split(total,id);
 	}
 
+	/// State of the engine (its parameters and position in the stream), as text.
+	std::string GetState() const
+	{
+		std::ostringstream oss;
+		oss << m_engine;
+		return oss.str();
+	}
+
+	/// Continue from a state obtained with GetState.
+	void SetState(const std::string& state)
+	{
+		std::istringstream iss(state);
+		if ( !(iss >> m_engine) ) {
+			throw std::runtime_error(std::string(__func__) + "> Invalid engine state: " + state);
+		}
+	}
+
 private:
 	trng::mrg2               	m_engine;         ///< The random number engine.
 	trng::uniform01_dist<double>	m_uniform_dist;   ///< The random distribution.
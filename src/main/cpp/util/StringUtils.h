@@ -78,6 +78,20 @@ public:
 		return tokens;
 	}
 
+	/// Parses the unsigned decimal number at the start of [first, last[ (no locale,
+	/// no allocation). Returns the position past the last digit, i.e. first if there are none.
+	static const char* ParseUnsigned(const char* first, const char* last, unsigned int& value)
+	{
+		unsigned int v = 0U;
+		const char* it = first;
+		while (it != last && static_cast<unsigned int>(*it - '0') <= 9U) {
+			v = 10U * v + static_cast<unsigned int>(*it - '0');
+			++it;
+		}
+		value = v;
+		return it;
+	}
+
 	/// Builds a string representation of a value of type T.
 	template<typename T> inline static std::string ToString(T const& value)
 	{
@@ -0,0 +1,143 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Implementation of the ThreadPinning class.
+ */
+
+#include "ThreadPinning.h"
+
+#include <boost/filesystem.hpp>
+#include <omp.h>
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace stride {
+namespace util {
+
+using namespace std;
+
+namespace {
+
+/// Cpus this process may run on, in increasing order.
+vector<int> AllowedCpus()
+{
+        vector<int> cpus;
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+                for (int c = 0; c < CPU_SETSIZE; c++) {
+                        if (CPU_ISSET(c, &set)) {
+                                cpus.push_back(c);
+                        }
+                }
+        }
+#endif
+        return cpus;
+}
+
+}
+
+vector<int> ThreadPinning::Pin(const string& mode, unsigned int num_threads)
+{
+        vector<int> pinned(num_threads, -1);
+        if (mode == "none") {
+                return pinned;
+        }
+        if (mode != "compact" && mode != "spread") {
+                throw runtime_error(string(__func__) + "> Invalid input for thread_pinning: " + mode);
+        }
+        const auto cpus = AllowedCpus();
+        if (cpus.empty()) {
+                return pinned;
+        }
+
+        // Cpus per node, then in the order threads get them.
+        map<int, vector<int>> node_cpus;
+        for (const auto c : cpus) {
+                node_cpus[GetNode(c)].push_back(c);
+        }
+        vector<int> order;
+        if (mode == "compact") {
+                for (const auto& node : node_cpus) {
+                        order.insert(order.end(), node.second.begin(), node.second.end());
+                }
+        } else {
+                for (size_t i = 0; order.size() < cpus.size(); i++) {
+                        for (const auto& node : node_cpus) {
+                                if (i < node.second.size()) {
+                                        order.push_back(node.second[i]);
+                                }
+                        }
+                }
+        }
+        for (unsigned int i = 0; i < num_threads; i++) {
+                pinned[i] = order[i % order.size()];
+        }
+
+#ifdef __linux__
+        #pragma omp parallel num_threads(num_threads)
+        {
+                const unsigned int thread = omp_get_thread_num();
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                CPU_SET(pinned[thread], &set);
+                if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+                        pinned[thread] = -1;
+                }
+        }
+#else
+        fill(pinned.begin(), pinned.end(), -1);
+#endif
+        return pinned;
+}
+
+int ThreadPinning::GetNode(int cpu)
+{
+        // Linux lists the cpu under its node in sysfs.
+        const boost::filesystem::path cpu_dir("/sys/devices/system/cpu/cpu" + to_string(cpu));
+        boost::system::error_code ec;
+        for (boost::filesystem::directory_iterator it(cpu_dir, ec), end; !ec && it != end; it.increment(ec)) {
+                const auto name = it->path().filename().string();
+                if (name.compare(0, 4, "node") == 0 && name.size() > 4) {
+                        return stoi(name.substr(4));
+                }
+        }
+        return 0;
+}
+
+string ThreadPinning::ToString(const vector<int>& cpus)
+{
+        ostringstream ss;
+        for (size_t i = 0; i < cpus.size(); i++) {
+                if (cpus[i] >= 0) {
+                        ss << (ss.tellp() > 0 ? " " : "") << i << ":" << cpus[i] << "/" << GetNode(cpus[i]);
+                }
+        }
+        return ss.tellp() > 0 ? ss.str() : "none";
+}
+
+} // namespace
+} // namespace
@@ -0,0 +1,53 @@
+#ifndef UTIL_THREAD_PINNING_H_INCLUDED
+#define UTIL_THREAD_PINNING_H_INCLUDED
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Header for the ThreadPinning class.
+ */
+
+#include <string>
+#include <vector>
+
+namespace stride {
+namespace util {
+
+/**
+ * Pinning of the OpenMP threads to cpus. The runtime keeps the threads of a team
+ * of the same size from one parallel region to the next, so pinning them once
+ * holds for the simulation. Where the OpenMP runtime is told to bind threads
+ * itself (OMP_PROC_BIND), use mode "none".
+ */
+class ThreadPinning
+{
+public:
+	/// Pin the threads of a team of the given size: "none" (leave them), "compact"
+	/// (fill up one NUMA node before the next) or "spread" (round robin over the nodes).
+	/// Returns the cpu of every thread, -1 for a thread that is not pinned.
+	static std::vector<int> Pin(const std::string& mode, unsigned int num_threads);
+
+	/// NUMA node of the cpu (0 if unknown).
+	static int GetNode(int cpu);
+
+	/// Layout as "thread:cpu/node" items separated by blanks, or "none".
+	static std::string ToString(const std::vector<int>& cpus);
+};
+
+} // namespace
+} // namespace
+
+#endif // end-of-include-guard
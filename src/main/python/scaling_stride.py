@@ -0,0 +1,201 @@
+#!/usr/bin/env python
+#############################################################################
+#  This file is part of the Stride software. 
+#  It is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by 
+#  the Free Software Foundation, either version 3 of the License, or any 
+#  later version.
+#  The software is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#  You should have received a copy of the GNU General Public License,
+#  along with the software. If not, see <http://www.gnu.org/licenses/>.
+#  see http://www.gnu.org/licenses/.
+#
+#  Copyright 2016, Willem L, Kuylen E & Broeckhove J
+#############################################################################
+
+import sys
+import os
+import argparse
+import subprocess
+import json
+import itertools
+import datetime
+import platform
+import csv
+import time
+
+import xml.etree.cElementTree as ET
+
+# ---------------------------------------------------------------------------
+# Scaling benchmark of the simulator on synthetic populations: strong scaling
+# (fixed population sizes, 1..N threads) and weak scaling (a fixed number of
+# persons per thread), for each disease, immunity rate and OpenMP schedule of
+# the config. Populations are generated with stride-popgen into the data
+# directory (and reused). Run from the install directory, like the wrapper:
+#     bin/scaling_stride.py --config config/scaling_default.json
+# Results (per-day and total times, parallel efficiency, peak memory) are
+# written to output/<time stamp>_<tag>/ as json and csv.
+# ---------------------------------------------------------------------------
+
+# --------------------------------
+# Function that generates (or reuses) the population file of a size.
+# --------------------------------
+def getPopulation(popgen_command, num_persons, seed):
+
+    population_file = 'pop_scaling_' + str(num_persons) + '_' + str(seed) + '.csv'
+    file_path = os.path.join('data', population_file)
+    if not os.path.isfile(file_path):
+        cmd_popgen = [popgen_command, '--size', str(num_persons), '--seed', str(seed), '--output', file_path]
+        subprocess.check_call(cmd_popgen, stdout=open(os.devnull, 'w'))
+    return population_file
+
+
+# --------------------------------
+# Function that runs the simulator and returns its timings and peak memory.
+# --------------------------------
+def runSimulator(binary_command, config, population_file, disease, immunity_rate, threads, schedule, output_prefix):
+
+    # Write configuration file
+    root = ET.Element("run")
+    ET.SubElement(root, "num_days").text = str(config['num_days'])
+    ET.SubElement(root, "rng_seed").text = str(config['rng_seed'])
+    ET.SubElement(root, "seeding_rate").text = str(config['seeding_rate'])
+    ET.SubElement(root, "r0").text = str(disease['r0'])
+    ET.SubElement(root, "population_file").text = population_file
+    ET.SubElement(root, "immunity_rate").text = str(immunity_rate)
+    ET.SubElement(root, "output_prefix").text = str(output_prefix)
+    ET.SubElement(root, "disease_config_file").text = str(disease['disease_config_file'])
+    ET.SubElement(root, "generate_person_file").text = "0"
+    ET.SubElement(root, "generate_timings_file").text = "1"
+    ET.SubElement(root, "num_participants_survey").text = "0"
+    ET.SubElement(root, "start_date").text = str(config['start_date'])
+    ET.SubElement(root, "holidays_file").text = str(config['holidays_file'])
+    ET.SubElement(root, "age_contact_matrix_file").text = str(config['age_contact_matrix_file'])
+    ET.SubElement(root, "log_level").text = "None"
+    ET.ElementTree(root).write(output_prefix + ".xml")
+
+    # Execute the call, with its own OpenMP environment, and wait for it
+    # to get the resource usage (peak memory) of that run only.
+    env = os.environ.copy()
+    env['OMP_NUM_THREADS'] = str(threads)
+    env['OMP_SCHEDULE'] = str(schedule)
+    start = time.time()
+    process = subprocess.Popen([binary_command, '--config', output_prefix + '.xml'],
+                               stdout=open(output_prefix + '_stdout.txt', 'w'), env=env)
+    (_, status, usage) = os.wait4(process.pid, 0)
+    wall_time = time.time() - start
+    if status != 0:
+        raise RuntimeError('Run ' + output_prefix + ' failed, see ' + output_prefix + '_stdout.txt')
+
+    # Collect the results
+    day_times = [float(x) for x in open(output_prefix + '_timings.csv', 'r').read().strip().split(',')]
+    summary = open(output_prefix + '_summary.csv', 'r').readlines()[1].strip().split(',')
+    for extension in ['.xml', '_timings.csv', '_summary.csv', '_cases.csv', '_logfile.txt', '_stdout.txt']:
+        if os.path.isfile(output_prefix + extension):
+            os.remove(output_prefix + extension)
+
+    return {
+        'population_size': int(summary[2]),
+        'num_cases': int(summary[11]),
+        'run_time_ms': sum(day_times),
+        'total_time_ms': float(summary[10]),
+        'wall_time_ms': 1000.0 * wall_time,
+        'day_times_ms': day_times,
+        'mean_day_time_ms': sum(day_times) / len(day_times),
+        'max_day_time_ms': max(day_times),
+        'peak_rss_kb': usage.ru_maxrss,
+    }
+
+
+# --------------------------------
+# Function that adds the parallel efficiency to the results: with respect
+# to the run on the fewest threads with the same settings otherwise.
+# --------------------------------
+def addEfficiency(results):
+
+    def key(r):
+        return (r['mode'], r['base_size'], r['disease_config_file'], r['immunity_rate'], r['omp_schedule'], r['repeat'])
+
+    reference = {}
+    for r in results:
+        if key(r) not in reference or r['threads'] < reference[key(r)]['threads']:
+            reference[key(r)] = r
+    for r in results:
+        ref = reference[key(r)]
+        ratio = ref['run_time_ms'] / max(r['run_time_ms'], 1e-3)
+        if r['mode'] == 'weak':
+            # the work grows with the number of threads
+            r['speedup'] = ratio * r['threads'] / float(ref['threads'])
+            r['efficiency'] = ratio
+        else:
+            r['speedup'] = ratio
+            r['efficiency'] = ratio * ref['threads'] / float(r['threads'])
+
+
+def main(argv):
+
+    # Arguments parser
+    parser = argparse.ArgumentParser(description='Script to benchmark the scaling of the simulator over threads.')
+    parser.add_argument('--config', help = 'A config file describing the benchmark.', default = './config/scaling_default.json', type=str)
+
+    args = vars(parser.parse_args())
+
+    # Load the json file
+    config = json.load(open(args['config'], 'r'))
+
+    # Create output dir
+    time_stamp  = datetime.datetime.now().strftime("%m%d%H%M%S")
+    file_tag    = time_stamp + '_' + config['output_tag']
+    output_dir  = os.path.join('output', file_tag)
+    if not os.path.isdir(output_dir):
+        os.makedirs(output_dir)
+
+    # The runs: strong scaling for each size, weak scaling with a size per thread
+    runs = []
+    for size in config['strong_sizes']:
+        for threads in config['threads']:
+            runs.append(('strong', size, size, threads))
+    if config.get('weak_size_per_thread', 0) > 0:
+        for threads in config['threads']:
+            runs.append(('weak', config['weak_size_per_thread'], config['weak_size_per_thread'] * threads, threads))
+
+    results = []
+    experiments = itertools.product(runs, config['diseases'], config['immunity_rate'], config['omp_schedule'], range(config.get('repeats', 1)))
+    for (index, experiment) in enumerate(experiments):
+        ((mode, base_size, num_persons, threads), disease, immunity_rate, schedule, repeat) = experiment
+        population_file = getPopulation(config['popgen_command'], num_persons, config['population_seed'])
+        output_prefix = os.path.join(output_dir, 'exp' + str(index))
+        print('Run ' + str(index) + ': ' + mode + ' ' + str(num_persons) + ' persons, ' + str(threads) + ' threads, '
+              + disease['disease_config_file'] + ', immunity ' + str(immunity_rate) + ', ' + schedule)
+        result = {
+            'mode': mode, 'base_size': base_size, 'num_persons': num_persons, 'threads': threads,
+            'omp_schedule': schedule, 'disease_config_file': disease['disease_config_file'], 'r0': disease['r0'],
+            'immunity_rate': immunity_rate, 'repeat': repeat,
+        }
+        result.update(runSimulator(config['binary_command'], config, population_file, disease, immunity_rate, threads, schedule, output_prefix))
+        results.append(result)
+        sys.stdout.flush()
+
+    addEfficiency(results)
+
+    # Write the results: all in json, all but the per-day times in csv
+    host = {'machine': platform.machine(), 'node': platform.node(), 'system': platform.system(),
+            'release': platform.release(), 'cpu_count': os.sysconf('SC_NPROCESSORS_ONLN')}
+    with open(os.path.join(output_dir, file_tag + '_scaling.json'), 'w') as json_file:
+        json.dump({'config': config, 'host': host, 'results': results}, json_file, indent=1)
+    columns = ['mode', 'base_size', 'num_persons', 'threads', 'omp_schedule', 'disease_config_file', 'r0', 'immunity_rate',
+               'repeat', 'population_size', 'num_cases', 'run_time_ms', 'total_time_ms', 'wall_time_ms',
+               'mean_day_time_ms', 'max_day_time_ms', 'speedup', 'efficiency', 'peak_rss_kb']
+    with open(os.path.join(output_dir, file_tag + '_scaling.csv'), 'w') as csv_file:
+        writer = csv.writer(csv_file)
+        writer.writerow(columns)
+        for r in results:
+            writer.writerow([r[c] for c in columns])
+    print('Results in ' + output_dir)
+
+
+if __name__ == "__main__":
+    main(sys.argv)
@@ -33,7 +33,7 @@ import xml.etree.cElementTree as ET
 # --------------------------------
 # Function that runs the simulator.
 # --------------------------------
-def runSimulator(binary_command, num_days, rng_seed, seeding_rate, r0, population_file, immunity_rate, output_prefix, disease_config_file, generate_person_file, num_participants_survey, start_date, holidays_file, age_contact_matrix_file, log_level):
+def runSimulator(binary_command, num_days, rng_seed, seeding_rate, r0, population_file, immunity_rate, output_prefix, disease_config_file, generate_person_file, num_participants_survey, start_date, holidays_file, age_contact_matrix_file, log_level, snapshot_dir='', snapshot_shared=False, restart_from=''):
     
     # Write configuration file
     root = ET.Element("run")
@@ -53,6 +53,12 @@ def runSimulator(binary_command, num_days, rng_seed, seeding_rate, r0, populatio
     ET.SubElement(root, "holidays_file").text = str(str(holidays_file))
     ET.SubElement(root, "age_contact_matrix_file").text = str(str(age_contact_matrix_file))
     ET.SubElement(root, "log_level").text = str(str(log_level))
+    if len(snapshot_dir) > 0:
+        ET.SubElement(root, "snapshot_dir").text = str(snapshot_dir)
+        if snapshot_shared:
+            ET.SubElement(root, "snapshot_shared").text = "true"
+    if len(restart_from) > 0:
+        ET.SubElement(root, "restart_from").text = str(restart_from)
     
     tree = ET.ElementTree(root)
     tree.write(str(output_prefix)+ ".xml")
@@ -151,7 +157,7 @@ def main(argv):
         os.putenv('OMP_SCHEDULE' , str(config['omp_schedule']))
         
         # Run the simulator     ('experiment[0]' has been used for the OMP_NUM_THREADS)
-        runSimulator(config['binary_command'], config['num_days'], experiment[1], experiment[2], experiment[3], experiment[4], experiment[5], output_prefix, config['disease_config_file'],config['generate_person_file'],config['num_participants_survey'], config['start_date'], config['holidays_file'], config['age_contact_matrix_file'], config['log_level'])
+        runSimulator(config['binary_command'], config['num_days'], experiment[1], experiment[2], experiment[3], experiment[4], experiment[5], output_prefix, config['disease_config_file'],config['generate_person_file'],config['num_participants_survey'], config['start_date'], config['holidays_file'], config['age_contact_matrix_file'], config['log_level'], config.get('snapshot_dir', ''), config.get('snapshot_shared', False), config.get('restart_from', ''))
                
         # Append the aggregated outputs
         if is_first:
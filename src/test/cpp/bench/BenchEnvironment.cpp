@@ -0,0 +1,71 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Implementation of the BenchEnvironment class.
+ */
+
+#include "BenchEnvironment.h"
+
+#include "calendar/Calendar.h"
+#include "core/Cluster.h"
+#include "core/ClusterType.h"
+#include "core/ContactMatrixReader.h"
+#include "core/ContactProfile.h"
+#include "util/InstallDirs.h"
+
+#include <boost/property_tree/xml_parser.hpp>
+#include <spdlog/spdlog.h>
+#include <spdlog/sinks/null_sink.h>
+
+namespace stride {
+
+using namespace std;
+using namespace stride::util;
+
+const BenchEnvironment& BenchEnvironment::Get()
+{
+        static const BenchEnvironment environment;
+        return environment;
+}
+
+BenchEnvironment::BenchEnvironment()
+{
+        pt_config.put("run.rng_seed", 2015U);
+        pt_config.put("run.r0", 11.0);
+        pt_config.put("run.seeding_rate", 0.002);
+        pt_config.put("run.immunity_rate", 0.8);
+        pt_config.put("run.population_file", "pop_oklahoma.csv");
+        pt_config.put("run.disease_config_file", "disease_measles.xml");
+        pt_config.put("run.num_participants_survey", 10U);
+        pt_config.put("run.start_date", "2017-01-01");
+        pt_config.put("run.holidays_file", "holidays_none.json");
+        pt_config.put("run.age_contact_matrix_file", "contact_matrix_average.xml");
+        pt_config.put("run.log_level", "None");
+        read_xml((InstallDirs::GetDataDir() / "disease_measles.xml").string(), pt_disease);
+        disease_profile.Initialize(pt_config, pt_disease);
+        calendar = make_shared<Calendar>(pt_config);
+
+        const auto contact_matrices = ContactMatrixReader::Read(pt_config);
+        for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+                Cluster::AddContactProfile(static_cast<ClusterType>(t), ContactProfile(contact_matrices[t]));
+        }
+        if ( !spdlog::get("contact_logger") ) {
+                spdlog::create<spdlog::sinks::null_sink_st>("contact_logger");
+        }
+}
+
+} // end_of_namespace
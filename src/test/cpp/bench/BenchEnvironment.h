@@ -0,0 +1,54 @@
+#ifndef BENCH_ENVIRONMENT_H_INCLUDED
+#define BENCH_ENVIRONMENT_H_INCLUDED
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Header for the BenchEnvironment class.
+ */
+
+#include "core/DiseaseProfile.h"
+
+#include <boost/property_tree/ptree.hpp>
+#include <memory>
+
+namespace stride {
+
+class Calendar;
+
+/**
+ * What the kernels need besides their persons and clusters, set up once for all benchmarks:
+ * a configuration (measles, R0 11, no holidays), its disease profile and calendar, the
+ * contact profiles of its contact matrices and a contact logger that discards its output.
+ */
+class BenchEnvironment
+{
+public:
+	/// The environment, set up on first use.
+	static const BenchEnvironment& Get();
+
+	boost::property_tree::ptree        pt_config;         ///< Configuration.
+	boost::property_tree::ptree        pt_disease;        ///< Disease configuration.
+	DiseaseProfile                     disease_profile;   ///< Disease profile of the configuration.
+	std::shared_ptr<const Calendar>    calendar;          ///< Calendar at the start date.
+
+private:
+	BenchEnvironment();
+};
+
+} // end_of_namespace
+
+#endif // end-of-include-guard
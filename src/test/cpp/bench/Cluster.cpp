@@ -0,0 +1,76 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Benchmarks of the sort of the members of a cluster and of the update of their presence.
+ */
+
+#include "BenchEnvironment.h"
+#include "SyntheticClusters.h"
+
+#include <benchmark/benchmark.h>
+
+using namespace std;
+using namespace stride;
+
+namespace {
+
+/// Sort of the members of all clusters of the given size (first argument), a share of the
+/// members infectious (second argument, per thousand) and half of the others immune. Either
+/// the members are in the order of the previous sort, as on most days of a simulation (third
+/// argument 0), or in their initial order: the clusters are rebuilt outside of the timing.
+void BM_ClusterSortMembers(benchmark::State& state)
+{
+        BenchEnvironment::Get();
+        const double prevalence = state.range(1) / 1000.0;
+        SyntheticClusters synthetic(ClusterType::SecondaryCommunity, state.range(0), prevalence, (1.0 - prevalence) / 2.0);
+        const bool unsorted = state.range(2) != 0;
+        for (auto _ : state) {
+                for (auto& cluster : synthetic.GetClusters()) {
+                        benchmark::DoNotOptimize(cluster.SortMembers());
+                }
+                if (unsorted) {
+                        state.PauseTiming();
+                        synthetic.ResetClusters();
+                        state.ResumeTiming();
+                }
+        }
+        state.SetItemsProcessed(state.iterations() * synthetic.GetClusters().size());
+}
+BENCHMARK(BM_ClusterSortMembers)
+        ->ArgsProduct({ { 4, 80, 1000 }, { 1, 100 }, { 0, 1 } })
+        ->ArgNames({ "size", "permille", "unsorted" });
+
+/// Presence of the members of all school clusters of the given size (first argument), on
+/// a school and work day (second argument 0) or on a day off (1).
+void BM_ClusterUpdateMemberPresence(benchmark::State& state)
+{
+        BenchEnvironment::Get();
+        SyntheticClusters synthetic(ClusterType::School, state.range(0), 0.0);
+        const bool is_off = state.range(1) != 0;
+        for (auto _ : state) {
+                for (auto& cluster : synthetic.GetClusters()) {
+                        cluster.UpdateMemberPresence(is_off, is_off);
+                }
+                benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * synthetic.GetClusters().size());
+}
+BENCHMARK(BM_ClusterUpdateMemberPresence)
+        ->ArgsProduct({ { 4, 80, 1000 }, { 0, 1 } })
+        ->ArgNames({ "size", "off" });
+
+}
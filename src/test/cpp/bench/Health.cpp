@@ -0,0 +1,71 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Benchmarks of the daily update of the health of persons.
+ */
+
+#include "core/Health.h"
+#include "util/Random.h"
+
+#include <benchmark/benchmark.h>
+#include <limits>
+#include <vector>
+
+using namespace std;
+using namespace stride;
+using namespace stride::util;
+
+namespace {
+
+/// Update of the health of the given number of persons (first argument), a share of them
+/// infected (second argument, per thousand): half still exposed, half infectious and
+/// symptomatic. The course of the disease is long enough for none of them to change
+/// status during the benchmark, so every pass updates the same mix.
+void BM_HealthUpdate(benchmark::State& state)
+{
+        const auto num_persons = static_cast<size_t>(state.range(0));
+        const double prevalence = state.range(1) / 1000.0;
+        const unsigned int never = numeric_limits<unsigned int>::max() / 2U;
+        Random rng(2015U);
+        vector<Health> health;
+        for (size_t i = 0; i < num_persons; i++) {
+                const double u = rng.NextDouble();
+                if (u < prevalence / 2.0) {
+                        health.emplace_back(never, never, 1U, 1U);
+                        health.back().StartInfection();
+                } else if (u < prevalence) {
+                        health.emplace_back(1U, 2U, never, never);
+                        health.back().StartInfection();
+                        health.back().Update();
+                        health.back().Update();
+                } else {
+                        health.emplace_back(1U, 1U, 5U, 5U);
+                }
+        }
+        for (auto _ : state) {
+                for (auto& h : health) {
+                        h.Update();
+                }
+                benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * num_persons);
+}
+BENCHMARK(BM_HealthUpdate)
+        ->ArgsProduct({ { 1 << 16 }, { 1, 100, 1000 } })
+        ->ArgNames({ "persons", "permille" });
+
+}
@@ -0,0 +1,76 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Benchmarks of contacts and transmission in a cluster, for every log mode and
+ * with and without tracking the index case only.
+ */
+
+#include "BenchEnvironment.h"
+#include "SyntheticClusters.h"
+
+#include "core/Infector.h"
+#include "core/LogMode.h"
+#include "core/RngHandler.h"
+
+#include <benchmark/benchmark.h>
+
+using namespace std;
+using namespace stride;
+
+namespace {
+
+/// Contacts and transmission in all clusters of the given size (first argument) and share
+/// infectious (second argument, per thousand). The health of the persons is reset after
+/// every pass, outside of the timing.
+template<LogMode log_level, bool track_index_case>
+void BM_InfectorExecute(benchmark::State& state)
+{
+        const auto& environment = BenchEnvironment::Get();
+        SyntheticClusters synthetic(ClusterType::SecondaryCommunity, state.range(0), state.range(1) / 1000.0);
+        RngHandler rng_handler(2015U, 1U, 0U);
+        for (auto _ : state) {
+                for (auto& cluster : synthetic.GetClusters()) {
+                        Infector<log_level, track_index_case>::Execute(cluster, environment.disease_profile,
+                                rng_handler, environment.calendar, false, false);
+                }
+                state.PauseTiming();
+                synthetic.ResetHealth();
+                state.ResumeTiming();
+        }
+        state.SetItemsProcessed(state.iterations() * synthetic.GetClusters().size());
+        state.counters["persons"] = static_cast<double>(synthetic.GetNumPersons());
+}
+
+/// Households, school classes and communities, with few to many infectious members.
+void ClusterArguments(benchmark::internal::Benchmark* b)
+{
+        for (const auto size : { 4, 80, 1000 }) {
+                for (const auto prevalence : { 1, 10, 100 }) {
+                        b->Args({ size, prevalence });
+                }
+        }
+        b->ArgNames({ "size", "permille" });
+}
+
+}
+
+BENCHMARK_TEMPLATE(BM_InfectorExecute, LogMode::None, false)->Apply(ClusterArguments);
+BENCHMARK_TEMPLATE(BM_InfectorExecute, LogMode::None, true)->Apply(ClusterArguments);
+BENCHMARK_TEMPLATE(BM_InfectorExecute, LogMode::Transmissions, false)->Apply(ClusterArguments);
+BENCHMARK_TEMPLATE(BM_InfectorExecute, LogMode::Transmissions, true)->Apply(ClusterArguments);
+BENCHMARK_TEMPLATE(BM_InfectorExecute, LogMode::Contacts, false)->Apply(ClusterArguments);
+BENCHMARK_TEMPLATE(BM_InfectorExecute, LogMode::Contacts, true)->Apply(ClusterArguments);
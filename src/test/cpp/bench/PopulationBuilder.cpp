@@ -0,0 +1,82 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Benchmarks of reading a population: from a synthetic population in memory, of a given
+ * size, and from the configured population file.
+ */
+
+#include "BenchEnvironment.h"
+
+#include "pop/Population.h"
+#include "pop/PopulationBuilder.h"
+#include "pop/PopulationGenerator.h"
+#include "util/InstallDirs.h"
+#include "util/Random.h"
+
+#include <benchmark/benchmark.h>
+#include <boost/filesystem.hpp>
+#include <sstream>
+#include <string>
+
+using namespace std;
+using namespace stride;
+using namespace stride::util;
+
+namespace {
+
+/// Build a population from a stream with a synthetic population of the given number of
+/// persons (argument). The stream is set up outside of the timing.
+void BM_PopulationBuilderStream(benchmark::State& state)
+{
+        const auto& environment = BenchEnvironment::Get();
+        ostringstream os;
+        PopulationGenerator().Write(os, static_cast<size_t>(state.range(0)), 2015U);
+        const string text = os.str();
+        for (auto _ : state) {
+                state.PauseTiming();
+                istringstream pop_stream(text);
+                Random rng(2015U);
+                state.ResumeTiming();
+                benchmark::DoNotOptimize(PopulationBuilder::Build(environment.pt_config, environment.pt_disease,
+                        pop_stream, rng));
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+        state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_PopulationBuilderStream)
+        ->Arg(10000)->Arg(100000)
+        ->ArgName("persons")
+        ->Unit(benchmark::kMillisecond);
+
+/// Build a population from the configured population file.
+void BM_PopulationBuilderFile(benchmark::State& state)
+{
+        const auto& environment = BenchEnvironment::Get();
+        const auto file_path = InstallDirs::GetDataDir() / environment.pt_config.get<string>("run.population_file");
+        size_t num_persons = 0U;
+        for (auto _ : state) {
+                Random rng(2015U);
+                const auto population = PopulationBuilder::Build(environment.pt_config, environment.pt_disease, rng);
+                num_persons = population->size();
+        }
+        state.SetItemsProcessed(state.iterations() * num_persons);
+        state.SetBytesProcessed(state.iterations() * boost::filesystem::file_size(file_path));
+}
+BENCHMARK(BM_PopulationBuilderFile)
+        ->Unit(benchmark::kMillisecond);
+
+}
@@ -0,0 +1,46 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Benchmarks of the transmission draw.
+ */
+
+#include "core/RngHandler.h"
+
+#include <benchmark/benchmark.h>
+#include <cmath>
+
+using namespace std;
+using namespace stride;
+
+namespace {
+
+/// The transmission draw, for a contact rate that gives the given chance of transmission
+/// (argument, per thousand) at a transmission rate of one.
+void BM_RngHandlerHasTransmission(benchmark::State& state)
+{
+        RngHandler rng_handler(2015U, 1U, 0U);
+        const double contact_rate = -log(1.0 - state.range(0) / 1000.0);
+        for (auto _ : state) {
+                benchmark::DoNotOptimize(rng_handler.HasTransmission(contact_rate, 1.0));
+        }
+        state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RngHandlerHasTransmission)
+        ->Arg(1)->Arg(100)
+        ->ArgName("permille");
+
+}
@@ -0,0 +1,74 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Implementation of the SyntheticClusters class.
+ */
+
+#include "SyntheticClusters.h"
+
+#include "util/Random.h"
+
+#include <algorithm>
+
+namespace stride {
+
+using namespace std;
+using namespace stride::util;
+
+SyntheticClusters::SyntheticClusters(ClusterType type, size_t cluster_size, double prevalence, double immunity,
+        size_t num_persons)
+        : m_type(type), m_size(max<size_t>(cluster_size, 1U))
+{
+        const size_t num_clusters = max<size_t>(num_persons / m_size, 1U);
+        Random rng(2015U);
+        m_persons.reserve(num_clusters * m_size);
+        for (size_t i = 0; i < num_clusters * m_size; i++) {
+                const auto id = static_cast<unsigned int>(i / m_size + 1U);
+                m_persons.emplace_back(static_cast<unsigned int>(i), static_cast<double>(i % 80U),
+                        id, id, id, id, id, 1U, 1U, 5U, 5U);
+                Health& health = m_persons.back().GetHealth();
+                const double u = rng.NextDouble();
+                if (u < prevalence) {
+                        health.StartInfection();
+                        health.Update();
+                } else if (u < prevalence + immunity) {
+                        health.SetImmune();
+                }
+                m_initial.push_back(health);
+        }
+        ResetClusters();
+}
+
+void SyntheticClusters::ResetHealth()
+{
+        for (size_t i = 0; i < m_persons.size(); i++) {
+                m_persons[i].GetHealth() = m_initial[i];
+        }
+}
+
+void SyntheticClusters::ResetClusters()
+{
+        m_clusters.clear();
+        for (size_t i = 0; i < m_persons.size(); i++) {
+                if (i % m_size == 0U) {
+                        m_clusters.emplace_back(i / m_size + 1U, m_type);
+                }
+                m_clusters.back().AddPerson(&m_persons[i]);
+        }
+}
+
+} // end_of_namespace
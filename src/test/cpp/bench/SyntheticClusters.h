@@ -0,0 +1,68 @@
+#ifndef SYNTHETIC_CLUSTERS_H_INCLUDED
+#define SYNTHETIC_CLUSTERS_H_INCLUDED
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Header for the SyntheticClusters class.
+ */
+
+#include "core/Cluster.h"
+#include "core/ClusterType.h"
+#include "core/Health.h"
+#include "pop/Person.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace stride {
+
+/**
+ * Persons of ages 0 to 79 in clusters of one type and of a given size, with a given share
+ * of them infectious and a given share immune (at random, from a fixed seed). There are
+ * enough clusters for some 64k persons in all, so that timing a pass over all of them is
+ * not dominated by the overhead of the timer, even for clusters of a few persons.
+ */
+class SyntheticClusters
+{
+public:
+	/// Build the persons and clusters.
+	SyntheticClusters(ClusterType type, std::size_t cluster_size, double prevalence, double immunity = 0.0,
+	        std::size_t num_persons = 1U << 16);
+
+	/// The clusters.
+	std::vector<Cluster>& GetClusters() { return m_clusters; }
+
+	/// Number of persons in all clusters.
+	std::size_t GetNumPersons() const { return m_persons.size(); }
+
+	/// Give every person its initial health again (undoing transmissions).
+	void ResetHealth();
+
+	/// Rebuild the clusters with the members in their initial order (undoing sorts).
+	void ResetClusters();
+
+private:
+	ClusterType            m_type;        ///< Type of the clusters.
+	std::size_t            m_size;        ///< Number of persons per cluster.
+	std::vector<Person>    m_persons;     ///< The persons, cluster by cluster.
+	std::vector<Health>    m_initial;     ///< Initial health of the persons.
+	std::vector<Cluster>   m_clusters;    ///< The clusters.
+};
+
+} // end_of_namespace
+
+#endif // end-of-include-guard
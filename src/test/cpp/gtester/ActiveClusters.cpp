@@ -0,0 +1,72 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+
+/**
+ * @file
+ * Tests for the cluster pass over the active clusters only.
+ */
+
+#include "TestSupport.h"
+
+#include "pop/Population.h"
+#include "sim/Simulator.h"
+#include "sim/SimulatorBuilder.h"
+
+#include <gtest/gtest.h>
+#include <boost/property_tree/ptree.hpp>
+#include <omp.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace stride;
+using namespace ::testing;
+
+namespace Tests {
+
+TEST( ActiveClusters, default )
+{
+	boost::property_tree::ptree pt_config = GetTestConfig();
+	pt_config.put("run.immunity_rate", 0.0);
+	omp_set_num_threads(1);
+	omp_set_schedule(omp_sched_static, 1);
+
+	// With one thread, every engine has the same outcome, whatever it visits.
+	vector<vector<unsigned int>> cases;
+	for (const string engine : { "dense", "sparse", "adaptive" }) {
+		pt_config.put("run.cluster_engine", engine);
+		const auto sim = SimulatorBuilder::Build(pt_config, 1U);
+		cases.emplace_back();
+		for (unsigned int day = 0; day < 25U; day++) {
+			sim->TimeStep();
+			cases.back().push_back(sim->GetPopulation()->GetInfectedCount());
+		}
+		const auto& days = sim->GetEngineDays();
+		ASSERT_EQ(25U, days.size());
+		EXPECT_EQ(engine != "sparse", count(days.begin(), days.end(), 'd') > 0);
+		EXPECT_EQ(engine != "dense", count(days.begin(), days.end(), 's') > 0);
+	}
+	EXPECT_GT(cases[0].back(), 2000U);
+	EXPECT_EQ(cases[0], cases[1]);
+	EXPECT_EQ(cases[0], cases[2]);
+
+	pt_config.put("run.cluster_engine", "other");
+	EXPECT_THROW(SimulatorBuilder::Build(pt_config, 1U), runtime_error);
+}
+
+} //end-of-namespace-Tests
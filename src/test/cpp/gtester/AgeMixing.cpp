@@ -0,0 +1,131 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Tests for age-structured mixing within clusters.
+ */
+
+#include "TestSupport.h"
+
+#include "calendar/Calendar.h"
+#include "core/AgeMixing.h"
+#include "core/Cluster.h"
+#include "core/ContactMatrix.h"
+#include "core/DiseaseProfile.h"
+#include "core/Infector.h"
+#include "core/RngHandler.h"
+#include "pop/Age.h"
+#include "pop/Person.h"
+#include "sim/Simulator.h"
+#include "sim/SimulatorBuilder.h"
+#include "util/InstallDirs.h"
+
+#include <gtest/gtest.h>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/xml_parser.hpp>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+using namespace std;
+using namespace stride;
+using namespace stride::util;
+using namespace ::testing;
+
+namespace Tests {
+
+TEST( AgeMixing, default )
+{
+	boost::property_tree::ptree pt_config = GetTestConfig();
+	pt_config.put("run.age_mixing", "matrix");
+	boost::property_tree::ptree pt_disease;
+	read_xml((InstallDirs::GetDataDir() / "disease_measles.xml").string(), pt_disease);
+
+	// Builds the contact profiles of the clusters, and the mixing from the configured matrices.
+	const auto sim = SimulatorBuilder::Build(pt_config, 1U);
+	ASSERT_NE(nullptr, sim->GetAgeMixing());
+	EXPECT_EQ(17U, sim->GetAgeMixing()->GetNumBins());
+	DiseaseProfile disease_profile;
+	disease_profile.Initialize(pt_config, pt_disease);
+	const auto calendar = make_shared<Calendar>(pt_config);
+
+	// Contacts in proportion to the population of each age (one person each): uniform mixing.
+	// Contacts with persons of the same age only: no transmission to other age groups.
+	const vector<double> population_ages(MaximumAge() + 1U, 1.0);
+	ContactMatrices proportionate;
+	ContactMatrices assortative;
+	for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+		for (unsigned int a = 0; a <= MaximumAge(); a++) {
+			proportionate[t][a].fill(1.0 + a);
+			assortative[t][a][a] = 1.0;
+		}
+	}
+
+	// A secondary community of 1000 persons of ages 0 to 79, the first 40 infectious.
+	const unsigned int size = 1000U;
+	const unsigned int num_infectious = 40U;
+	const auto community = [&](vector<Person>& persons) {
+		persons.clear();
+		for (unsigned int i = 0; i < size; i++) {
+			persons.emplace_back(i, i % 80U, 0U, 0U, 0U, 0U, 1U, 1U, 1U, 5U, 5U);
+			if (i < num_infectious) {
+				persons.back().GetHealth().StartInfection();
+				persons.back().Update();
+			}
+		}
+		Cluster cluster(1U, ClusterType::SecondaryCommunity);
+		for (auto& p : persons) {
+			cluster.AddPerson(&p);
+		}
+		return cluster;
+	};
+
+	vector<Person> persons;
+	double force = 0.0;
+	Cluster cluster = community(persons);
+	for (unsigned int i = 0; i < num_infectious; i++) {
+		force += cluster.GetContactRate(&persons[i]);
+	}
+	const double expected = (size - num_infectious) * (1.0 - exp(-disease_profile.GetTransmissionRate() * force));
+
+	const unsigned int num_days = 400U;
+	const AgeMixing uniform(proportionate, population_ages, 5U);
+	const AgeMixing by_age(assortative, population_ages, 10U);
+	for (const auto mixing : { &uniform, &by_age }) {
+		RngHandler rng_handler(2015U, 1U, 0U);
+		double total = 0.0;
+		double total_older = 0.0;
+		for (unsigned int d = 0; d < num_days; d++) {
+			Cluster c = community(persons);
+			Infector<LogMode::None, false>::Execute(c, disease_profile, rng_handler, calendar,
+			        false, false, nullptr, MeanFieldRule(), mixing);
+			for (unsigned int i = num_infectious; i < size; i++) {
+				total += persons[i].GetHealth().IsInfected();
+				total_older += persons[i].GetHealth().IsInfected() && persons[i].GetAge() >= num_infectious;
+			}
+		}
+		if (mixing == &uniform) {
+			// Within 4 standard errors.
+			EXPECT_NEAR(expected, total / num_days, 4.0 * sqrt(expected / num_days));
+		} else {
+			EXPECT_GT(total, 0.0);
+			EXPECT_EQ(0.0, total_older);
+		}
+	}
+}
+
+} //end-of-namespace-Tests
@@ -0,0 +1,51 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Tests for the alias table sampling.
+ */
+
+#include "util/AliasTable.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace std;
+using namespace stride::util;
+using namespace ::testing;
+
+namespace Tests {
+
+TEST( AliasTableSampling, Cumulative )
+{
+	// Probabilities 0.1, 0, 0.3, 0.5 and the 0.1 the cdf leaves below one.
+	const auto table = AliasTable::FromCumulative({ 0.1, 0.1, 0.4, 0.9 });
+	ASSERT_EQ(table.size(), 5U);
+
+	// Sweep the unit interval: every outcome gets its share of it.
+	const unsigned int num_steps = 100000U;
+	vector<unsigned int> counts(table.size(), 0U);
+	for (unsigned int i = 0; i < num_steps; i++) {
+		counts[table.Sample((i + 0.5) / num_steps)]++;
+	}
+	const vector<double> expected { 0.1, 0.0, 0.3, 0.5, 0.1 };
+	for (size_t i = 0; i < counts.size(); i++) {
+		EXPECT_NEAR(static_cast<double>(counts[i]) / num_steps, expected[i], 1.0e-4);
+	}
+}
+
+} //end-of-namespace-Tests
@@ -0,0 +1,111 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Tests for reading contact matrices.
+ */
+
+#include "core/ContactMatrix.h"
+#include "core/ContactMatrixReader.h"
+#include "util/InstallDirs.h"
+
+#include <gtest/gtest.h>
+#include <boost/filesystem.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/xml_parser.hpp>
+
+#include <cstdint>
+#include <iterator>
+#include <string>
+
+using namespace std;
+using namespace stride;
+using namespace stride::util;
+using namespace ::testing;
+
+namespace Tests {
+
+TEST( ContactMatrixReading, CsvMatchesXml )
+{
+	// The reference files (and scale factors) the week/week XML was generated from.
+	boost::property_tree::ptree pt_config;
+	pt_config.put("run.contact_matrices.household.file", "ref_fl2010_regular_weekday_household_gam_mij_rec.csv");
+	pt_config.put("run.contact_matrices.household.scale", 10.0);
+	pt_config.put("run.contact_matrices.school.file", "ref_fl2010_regular_weekday_school_gam_mij_rec.csv");
+	pt_config.put("run.contact_matrices.work.file", "ref_fl2010_regular_weekday_workplace_gam_mij_rec.csv");
+	pt_config.put("run.contact_matrices.work.scale", 2.5);
+	pt_config.put("run.contact_matrices.primary_community.file", "ref_fl2010_regular_weekday_community_gam_mij_rec.csv");
+	pt_config.put("run.contact_matrices.secondary_community.file", "ref_fl2010_regular_weekday_community_gam_mij_rec.csv");
+	const auto csv = ContactMatrixReader::Read(pt_config);
+
+	boost::property_tree::ptree pt_contacts;
+	read_xml((InstallDirs::GetDataDir() / "contact_matrix_week_week.xml").string(), pt_contacts);
+	const auto xml = ContactMatrixReader::ReadXml(pt_contacts);
+
+	for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+		for (size_t i = 0; i <= MaximumAge(); i++) {
+			for (size_t j = 0; j <= MaximumAge(); j++) {
+				ASSERT_NEAR(csv[t][i][j], xml[t][i][j], 1.0e-9 * xml[t][i][j]);
+			}
+		}
+	}
+}
+
+TEST( ContactMatrixReading, Binary )
+{
+	boost::property_tree::ptree pt_contacts;
+	read_xml((InstallDirs::GetDataDir() / "contact_matrix_week_week.xml").string(), pt_contacts);
+	const auto matrices = ContactMatrixReader::ReadXml(pt_contacts);
+
+	const auto file_path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("%%%%-%%%%.bin");
+	ContactMatrixReader::WriteBinary(matrices, file_path, 123U);
+	uint64_t key = 0U;
+	const auto compiled = ContactMatrixReader::ReadBinary(file_path, &key);
+	boost::filesystem::remove(file_path);
+
+	EXPECT_EQ(key, 123U);
+	EXPECT_TRUE(compiled == matrices);
+}
+
+TEST( ContactMatrixReading, Cache )
+{
+	// The XML is compiled into the snapshot directory, not next to it in the data directory.
+	const auto dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("%%%%-%%%%");
+	boost::property_tree::ptree pt_config;
+	pt_config.put("run.age_contact_matrix_file", "contact_matrix_week_week.xml");
+	pt_config.put("run.snapshot_dir", dir.string());
+	const auto parsed = ContactMatrixReader::Read(pt_config);
+	const auto cached = ContactMatrixReader::Read(pt_config);
+	const auto num_files = distance(boost::filesystem::directory_iterator(dir), boost::filesystem::directory_iterator());
+	boost::filesystem::remove_all(dir);
+
+	EXPECT_EQ(num_files, 1);
+	EXPECT_FALSE(boost::filesystem::exists(InstallDirs::GetDataDir() / "contact_matrix_week_week.bin"));
+	EXPECT_TRUE(cached == parsed);
+}
+
+TEST( ContactMatrixReading, BadCsv )
+{
+	const auto file_path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("%%%%-%%%%.csv");
+	{
+		boost::filesystem::ofstream ofs(file_path);
+		ofs << "\"age0\";\"age1\"\n0,5;x\n";
+	}
+	EXPECT_THROW(ContactMatrix::ReadCsv(file_path), runtime_error);
+	boost::filesystem::remove(file_path);
+}
+
+} //end-of-namespace-Tests
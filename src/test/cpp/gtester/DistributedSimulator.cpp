@@ -0,0 +1,68 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+
+/**
+ * @file
+ * Tests for the simulator distributed over processes.
+ */
+
+#include "TestSupport.h"
+
+#include "pop/Population.h"
+#include "sim/DistributedSimulator.h"
+#include "sim/Simulator.h"
+#include "sim/SimulatorBuilder.h"
+
+#include <gtest/gtest.h>
+#include <boost/property_tree/ptree.hpp>
+#include <omp.h>
+
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+using namespace stride;
+using namespace ::testing;
+
+namespace Tests {
+
+TEST( DistributedSimulator, default )
+{
+	boost::property_tree::ptree pt_config = GetTestConfig();
+	pt_config.put("run.immunity_rate", 0.0);
+	omp_set_num_threads(1);
+	omp_set_schedule(omp_sched_static, 1);
+
+	// In a single process (the gtester does not start MPI), the one rank owns everything
+	// and runs as the simulator on its own.
+	ASSERT_EQ(1U, DistributedSimulator::GetWorldSize());
+	const auto sim = SimulatorBuilder::Build(pt_config, 1U);
+	DistributedSimulator distributed(SimulatorBuilder::Build(pt_config, 1U));
+	EXPECT_EQ(0U, distributed.GetPartition().GetNumCut());
+	EXPECT_EQ(sim->GetPopulation()->size(), distributed.GetNumLocalPersons());
+	EXPECT_EQ(sim->GetPopulation()->GetInfectedCount(), distributed.GetInfectedCount());
+	for (unsigned int day = 0; day < 25U; day++) {
+		sim->TimeStep();
+		distributed.TimeStep();
+		ASSERT_EQ(sim->GetPopulation()->GetInfectedCount(), distributed.GetInfectedCount()) << "day " << day;
+	}
+	EXPECT_GT(distributed.GetInfectedCount(), 2000U);
+
+	pt_config.put("run.log_level", "Transmissions");
+	EXPECT_THROW(DistributedSimulator(SimulatorBuilder::Build(pt_config, 1U)), runtime_error);
+}
+
+} //end-of-namespace-Tests
@@ -0,0 +1,117 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Tests for transmission computed per cluster as a whole.
+ */
+
+#include "TestSupport.h"
+
+#include "calendar/Calendar.h"
+#include "core/Cluster.h"
+#include "core/DiseaseProfile.h"
+#include "core/Infector.h"
+#include "core/MeanFieldRule.h"
+#include "core/RngHandler.h"
+#include "pop/Person.h"
+#include "sim/SimulatorBuilder.h"
+#include "util/InstallDirs.h"
+
+#include <gtest/gtest.h>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/xml_parser.hpp>
+
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+using namespace stride;
+using namespace stride::util;
+using namespace ::testing;
+
+namespace Tests {
+
+TEST( MeanFieldRule, default )
+{
+	boost::property_tree::ptree pt_config = GetTestConfig();
+	boost::property_tree::ptree pt_disease;
+	read_xml((InstallDirs::GetDataDir() / "disease_measles.xml").string(), pt_disease);
+
+	// Builds the contact profiles of the clusters.
+	SimulatorBuilder::Build(pt_config, 1U);
+	DiseaseProfile disease_profile;
+	disease_profile.Initialize(pt_config, pt_disease);
+	const auto calendar = make_shared<Calendar>(pt_config);
+
+	// A secondary community of 40 infectious and 960 susceptible persons of all ages.
+	const unsigned int size = 1000U;
+	const unsigned int num_infectious = 40U;
+	const MeanFieldRule rule(size, 0.01);
+	EXPECT_FALSE(MeanFieldRule().IsEnabled());
+	EXPECT_TRUE(rule.Applies(size, num_infectious));
+	EXPECT_FALSE(rule.Applies(size - 1U, num_infectious));
+	EXPECT_FALSE(rule.Applies(size, 9U));
+
+	const auto community = [&](vector<Person>& persons) {
+		persons.clear();
+		for (unsigned int i = 0; i < size; i++) {
+			persons.emplace_back(i, i % 80U, 0U, 0U, 0U, 0U, 1U, 1U, 1U, 5U, 5U);
+			if (i < num_infectious) {
+				persons.back().GetHealth().StartInfection();
+				persons.back().Update();
+			}
+		}
+		Cluster cluster(1U, ClusterType::SecondaryCommunity);
+		for (auto& p : persons) {
+			cluster.AddPerson(&p);
+		}
+		return cluster;
+	};
+
+	// Infected susceptibles, on average over repeated days, with either way of computing transmission.
+	vector<Person> persons;
+	double force = 0.0;
+	Cluster cluster = community(persons);
+	for (unsigned int i = 0; i < num_infectious; i++) {
+		force += cluster.GetContactRate(&persons[i]);
+	}
+	const double expected = (size - num_infectious) * (1.0 - exp(-disease_profile.GetTransmissionRate() * force));
+
+	const unsigned int num_days = 400U;
+	for (const auto& r : { MeanFieldRule(), rule }) {
+		RngHandler rng_handler(2015U, 1U, 0U);
+		double total = 0.0;
+		for (unsigned int d = 0; d < num_days; d++) {
+			Cluster c = community(persons);
+			EXPECT_EQ(r.IsEnabled(), (Infector<LogMode::None, false>::Execute(c, disease_profile,
+			        rng_handler, calendar, false, false, nullptr, r)));
+			for (unsigned int i = num_infectious; i < size; i++) {
+				total += persons[i].GetHealth().IsInfected();
+			}
+		}
+		// Within 4 standard errors.
+		EXPECT_NEAR(expected, total / num_days, 4.0 * sqrt(expected / num_days)) << r.ToString();
+	}
+
+	// Age mixing draws from a force of infection per age group already: not with the rule on top.
+	pt_config.put("run.age_mixing", "matrix");
+	pt_config.put("run.mean_field_min_size", size);
+	EXPECT_THROW(SimulatorBuilder::Build(pt_config, 1U), runtime_error);
+}
+
+} //end-of-namespace-Tests
@@ -0,0 +1,87 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+
+/**
+ * @file
+ * Tests for regions coupled by commuting.
+ */
+
+#include "TestSupport.h"
+
+#include "pop/Population.h"
+#include "sim/Metapopulation.h"
+#include "sim/Simulator.h"
+
+#include <gtest/gtest.h>
+#include <boost/property_tree/ptree.hpp>
+
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+using namespace stride;
+using namespace ::testing;
+
+namespace Tests {
+
+TEST( Metapopulation, default )
+{
+	boost::property_tree::ptree pt_config = GetTestConfig();
+	pt_config.put("run.seeding_rate", 0.0005);
+	pt_config.put("run.immunity_rate", 0.5);
+	pt_config.put("run.regions_file", "belgium_population_major.csv");
+	pt_config.put("run.metapopulation_size", 50000U);
+
+	// Regions without seeds stay free of the disease, unless commuters bring it in.
+	const unsigned int num_days = 40U;
+	vector<vector<unsigned int>> cases;
+	for (const auto commuting : { "", "belgium_commuting_major.csv", "belgium_commuting_major.csv" }) {
+		pt_config.put("run.commuting_file", commuting);
+		Metapopulation metapopulation(pt_config, cases.size() == 2U ? 3U : 1U);
+		ASSERT_EQ(35U, metapopulation.GetNumRegions());
+		EXPECT_EQ("ANTWERPEN", metapopulation.GetRegion(0).name);
+		size_t num_persons = 0U;
+		size_t num_commuters = 0U;
+		vector<unsigned int> seeded;
+		for (size_t r = 0; r < metapopulation.GetNumRegions(); r++) {
+			const auto& region = metapopulation.GetRegion(r);
+			num_persons   += region.num_persons;
+			num_commuters += region.num_commuters;
+			EXPECT_LE(region.num_persons, metapopulation.GetSimulator(r)->GetPopulation()->size());
+			seeded.push_back(metapopulation.GetInfectedCount(r));
+		}
+		EXPECT_EQ(num_persons, 50000U);
+		EXPECT_EQ(*commuting == '\0', num_commuters == 0U);
+		for (unsigned int d = 0; d < num_days; d++) {
+			metapopulation.TimeStep();
+		}
+		cases.emplace_back();
+		bool imported = false;
+		for (size_t r = 0; r < metapopulation.GetNumRegions(); r++) {
+			cases.back().push_back(metapopulation.GetInfectedCount(r));
+			imported = imported || (seeded[r] == 0U && cases.back().back() > 0U);
+		}
+		EXPECT_EQ(num_commuters > 0U, imported);
+	}
+
+	// Regions coupled once a day have the same outcome with any number of threads.
+	EXPECT_EQ(cases[1], cases[2]);
+
+	pt_config.put("run.regions_file", "no_regions.csv");
+	EXPECT_THROW(Metapopulation(pt_config, 1U), runtime_error);
+}
+
+} //end-of-namespace-Tests
@@ -0,0 +1,115 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Tests for the partitioning of persons and clusters over threads.
+ */
+
+#include "TestSupport.h"
+
+#include "core/Cluster.h"
+#include "core/ClusterType.h"
+#include "pop/Population.h"
+#include "sim/Partition.h"
+#include "sim/Simulator.h"
+#include "sim/SimulatorBuilder.h"
+
+#include <gtest/gtest.h>
+#include <boost/property_tree/ptree.hpp>
+#include <omp.h>
+
+#include <array>
+#include <vector>
+
+using namespace std;
+using namespace stride;
+using namespace ::testing;
+
+namespace Tests {
+
+TEST( Partitioning, SeparateTowns )
+{
+	// Two towns with their own school, work place and communities; their
+	// households alternate in the population.
+	const unsigned int num_households = 80U;
+	Population population;
+	for (unsigned int h = 0; h < num_households; h++) {
+		const unsigned int town = h % 2U;
+		for (unsigned int i = 0; i < 3U; i++) {
+			population.emplace_back(population.size(), 10.0 + 20.0 * i, h + 1U, town + 1U,
+			        town + 1U, town + 1U, town + 1U, 0U, 0U, 0U, 0U);
+		}
+	}
+	array<vector<Cluster>, NumOfClusterTypes()> clusters;
+	for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+		const auto type = static_cast<ClusterType>(t);
+		const unsigned int num_clusters = (type == ClusterType::Household) ? num_households : 2U;
+		for (unsigned int c = 0; c < num_clusters; c++) {
+			clusters[t].emplace_back(c + 1U, type);
+		}
+		for (auto& p : population) {
+			clusters[t][p.GetClusterId(type) - 1U].AddPerson(&p);
+		}
+	}
+
+	const Partition partition(population, { { &clusters[0], &clusters[1], &clusters[2], &clusters[3], &clusters[4] } }, 2U);
+	ASSERT_EQ(partition.GetNumPartitions(), 2U);
+	EXPECT_EQ(partition.GetNumMemberships(), 5U * population.size());
+	EXPECT_EQ(partition.GetNumCut(), 0U);
+	EXPECT_EQ(partition.GetPersons(0).size(), population.size() / 2U);
+	EXPECT_EQ(partition.GetPersons(1).size(), population.size() / 2U);
+
+	// Every cluster is owned by exactly one partition, along with all of its members.
+	for (size_t t = 0; t < NumOfClusterTypes(); t++) {
+		const auto type = static_cast<ClusterType>(t);
+		size_t num_owned = 0U;
+		for (unsigned int part = 0; part < 2U; part++) {
+			for (const auto c : partition.GetClusters(part, type)) {
+				num_owned++;
+				for (size_t i = 0; i < clusters[t][c].GetSize(); i++) {
+					EXPECT_EQ(partition.GetOwners()[clusters[t][c].GetMember(i) - population.data()], part);
+				}
+			}
+		}
+		EXPECT_EQ(num_owned, clusters[t].size());
+	}
+}
+
+TEST( Partitioning, IndependentOfThreads )
+{
+	boost::property_tree::ptree pt_config = GetTestConfig();
+	pt_config.put("run.partitioning", "graph");
+	pt_config.put("run.immunity_rate", 0.0);
+	omp_set_schedule(omp_sched_static, 1);
+
+	// Four partitions on four threads, and on the one thread of a nested parallel region:
+	// the partitions run the cluster types in step, so the outcome is the same.
+	const auto sim4 = SimulatorBuilder::Build(pt_config, 4U);
+	const auto cases4 = RunDays(*sim4, 20U);
+	const auto sim1 = SimulatorBuilder::Build(pt_config, 4U);
+	vector<unsigned int> cases1;
+	omp_set_max_active_levels(1);
+	#pragma omp parallel num_threads(2)
+	{
+		#pragma omp single
+		cases1 = RunDays(*sim1, 20U);
+	}
+	ASSERT_EQ(sim4->GetPartition().GetNumPartitions(), 4U);
+	EXPECT_GT(cases4.back(), 2000U);
+	EXPECT_EQ(cases4, cases1);
+}
+
+} //end-of-namespace-Tests
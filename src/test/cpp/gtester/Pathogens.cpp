@@ -0,0 +1,102 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+
+/**
+ * @file
+ * Tests for several pathogens in one simulator.
+ */
+
+#include "TestSupport.h"
+
+#include "pop/Population.h"
+#include "sim/Simulator.h"
+#include "sim/SimulatorBuilder.h"
+#include "sim/SimulatorCheckpoint.h"
+
+#include <gtest/gtest.h>
+#include <boost/filesystem.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <omp.h>
+
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+using namespace stride;
+using namespace ::testing;
+
+namespace Tests {
+
+/// Run the simulator for a number of days and collect the daily case counts of each pathogen.
+static vector<vector<unsigned int>> RunPathogens(Simulator& sim, unsigned int num_days)
+{
+	vector<vector<unsigned int>> cases(sim.GetNumPathogens());
+	for (unsigned int day = 0; day < num_days; day++) {
+		sim.TimeStep();
+		for (size_t k = 0; k < cases.size(); k++) {
+			cases[k].push_back(sim.GetInfectedCount(k));
+		}
+	}
+	return cases;
+}
+
+TEST( Pathogens, default )
+{
+	boost::property_tree::ptree pt_config = GetTestConfig();
+	omp_set_num_threads(1);
+	omp_set_schedule(omp_sched_static, 1);
+	const unsigned int num_days = 20U;
+	const auto measles = RunDays(*SimulatorBuilder::Build(pt_config, 1U), num_days);
+
+	// Measles and influenza in one population; then a third pathogen joins them.
+	pt_config.put("run.disease_config_file", "disease_measles.xml, disease_influenza.xml");
+	pt_config.put("run.r0", "11, 2");
+	pt_config.put("run.immunity_rate", "0.8, 0");
+	const auto both = RunPathogens(*SimulatorBuilder::Build(pt_config, 1U), num_days);
+	pt_config.put("run.disease_config_file", "disease_measles.xml,disease_influenza.xml,disease_measles.xml");
+	pt_config.put("run.r0", "11,2,15");
+	pt_config.put("run.immunity_rate", "0.8,0,0.5");
+	const auto sim = SimulatorBuilder::Build(pt_config, 1U);
+	ASSERT_EQ(3U, sim->GetNumPathogens());
+	const auto three = RunPathogens(*sim, num_days);
+
+	// Each pathogen has its own course, which the pathogens after it leave as it is.
+	EXPECT_EQ(measles, both[0]);
+	EXPECT_EQ(measles, three[0]);
+	EXPECT_EQ(both[1], three[1]);
+	EXPECT_GT(both[1].back(), both[1].front());
+	EXPECT_NE(three[0], three[2]);
+
+	// Restarts from a checkpoint continue every pathogen.
+	const auto dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+	boost::filesystem::create_directories(dir);
+	const auto sim1 = SimulatorBuilder::Build(pt_config, 1U);
+	RunPathogens(*sim1, 8U);
+	SimulatorCheckpoint().Save(*sim1, { 0U }, dir / "checkpoint.bin");
+	const auto sim2 = SimulatorBuilder::Build(pt_config, 1U);
+	SimulatorCheckpoint::Load(*sim2, dir / "checkpoint.bin");
+	EXPECT_EQ(RunPathogens(*sim1, 8U), RunPathogens(*sim2, 8U));
+	boost::filesystem::remove_all(dir);
+
+	// One value, or one per pathogen; and only with the dense cluster pass.
+	pt_config.put("run.r0", "11,2");
+	EXPECT_THROW(SimulatorBuilder::Build(pt_config, 1U), runtime_error);
+	pt_config.put("run.r0", "11");
+	pt_config.put("run.cluster_engine", "sparse");
+	EXPECT_THROW(SimulatorBuilder::Build(pt_config, 1U), runtime_error);
+}
+
+} //end-of-namespace-Tests
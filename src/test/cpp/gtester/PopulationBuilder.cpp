@@ -0,0 +1,229 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Tests for reading population files.
+ */
+
+#include "core/ClusterType.h"
+#include "pop/Population.h"
+#include "pop/PopulationBuilder.h"
+#include "util/InstallDirs.h"
+#include "util/Random.h"
+
+#include <gtest/gtest.h>
+#include <boost/iostreams/copy.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/xml_parser.hpp>
+#include <omp.h>
+
+#include <algorithm>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace stride;
+using namespace stride::util;
+using namespace ::testing;
+
+namespace Tests {
+
+class PopulationReading: public ::testing::Test
+{
+protected:
+	/// Set up for the test fixture
+	virtual void SetUp()
+	{
+		m_pt_config.put("run.seeding_rate", 0.0);
+		m_pt_config.put("run.immunity_rate", 0.0);
+		m_pt_config.put("run.log_level", "None");
+		read_xml((InstallDirs::GetDataDir() / "disease_measles.xml").string(), m_pt_disease);
+
+		// Some quirks of real files: fractional ages, a blank line, CRLF line ends.
+		ostringstream oss;
+		oss << "\"age\",\"household_id\",\"school_id\",\"work_id\",\"primary_community\",\"secondary_community\"\n";
+		for (unsigned int i = 0; i < g_num_persons; i++) {
+			oss << (i * 7U) % 90U << (i % 11U == 0U ? ".5" : "") << "," << 1U + i / 3U << ","
+			        << (i % 5U) << "," << (i % 7U) * 3U << "," << 1U + i / 500U << ","
+			        << 1U + (i * 13U) % 97U << (i % 17U == 0U ? "\r\n" : "\n");
+			if (i == g_num_persons / 2) {
+				oss << "\n";
+			}
+		}
+		m_csv = oss.str();
+	}
+
+	/// Build population from the stream with the given number of threads.
+	shared_ptr<Population> Build(istream& is, int num_threads)
+	{
+		omp_set_num_threads(num_threads);
+		Random rng(2015U);
+		const auto pop = PopulationBuilder::Build(m_pt_config, m_pt_disease, is, rng);
+		m_next_draw = rng.NextDouble();
+		return pop;
+	}
+
+	/// Check that both populations hold identical persons.
+	static void ExpectEqual(const Population& p1, const Population& p2)
+	{
+		ASSERT_EQ(p1.size(), p2.size());
+		for (size_t i = 0; i < p1.size(); i++) {
+			EXPECT_EQ(p1[i].GetId(), p2[i].GetId());
+			EXPECT_EQ(p1[i].GetAge(), p2[i].GetAge());
+			for (auto type : { ClusterType::Household, ClusterType::School, ClusterType::Work,
+			                ClusterType::PrimaryCommunity, ClusterType::SecondaryCommunity }) {
+				EXPECT_EQ(p1[i].GetClusterId(type), p2[i].GetClusterId(type));
+			}
+			EXPECT_EQ(p1[i].GetHealth().GetStartInfectiousness(), p2[i].GetHealth().GetStartInfectiousness());
+			EXPECT_EQ(p1[i].GetHealth().GetEndInfectiousness(), p2[i].GetHealth().GetEndInfectiousness());
+			EXPECT_EQ(p1[i].GetHealth().GetStartSymptomatic(), p2[i].GetHealth().GetStartSymptomatic());
+			EXPECT_EQ(p1[i].GetHealth().GetEndSymptomatic(), p2[i].GetHealth().GetEndSymptomatic());
+		}
+	}
+
+	// Data members of the test fixture
+	static const unsigned int         g_num_persons;
+	boost::property_tree::ptree       m_pt_config;
+	boost::property_tree::ptree       m_pt_disease;
+	string                            m_csv;
+	double                            m_next_draw;
+};
+
+const unsigned int PopulationReading::g_num_persons = 200000U;
+
+TEST_F( PopulationReading, Parse )
+{
+	istringstream is(m_csv);
+	const auto pop = Build(is, 1);
+	ASSERT_EQ(pop->size(), g_num_persons);
+	EXPECT_EQ((*pop)[11].GetAge(), 77.0);
+	EXPECT_EQ((*pop)[11].GetClusterId(ClusterType::Household), 4U);
+	EXPECT_EQ((*pop)[11].GetClusterId(ClusterType::School), 1U);
+	EXPECT_EQ((*pop)[11].GetClusterId(ClusterType::Work), 12U);
+	EXPECT_EQ((*pop)[11].GetClusterId(ClusterType::PrimaryCommunity), 1U);
+	EXPECT_EQ((*pop)[11].GetClusterId(ClusterType::SecondaryCommunity), 47U);
+	EXPECT_EQ(pop->back().GetId(), g_num_persons - 1U);
+}
+
+TEST_F( PopulationReading, IndependentOfThreads )
+{
+	istringstream is1(m_csv);
+	const auto pop1 = Build(is1, 1);
+	const double next_draw1 = m_next_draw;
+
+	istringstream is4(m_csv);
+	const auto pop4 = Build(is4, 4);
+	ExpectEqual(*pop1, *pop4);
+	EXPECT_EQ(next_draw1, m_next_draw);
+}
+
+TEST_F( PopulationReading, ImmunityAndSeeding )
+{
+	m_pt_config.put("run.immunity_rate", 0.8);
+	m_pt_config.put("run.seeding_rate", 0.01);
+	istringstream is1(m_csv);
+	const auto pop1 = Build(is1, 1);
+	istringstream is4(m_csv);
+	const auto pop4 = Build(is4, 4);
+
+	size_t num_immune = 0U;
+	size_t num_infected = 0U;
+	for (size_t i = 0; i < pop1->size(); i++) {
+		const auto& h = (*pop1)[i].GetHealth();
+		ASSERT_EQ(h.GetHealthStatus(), (*pop4)[i].GetHealth().GetHealthStatus());
+		num_immune += h.IsImmune();
+		num_infected += h.IsInfected();
+	}
+	EXPECT_EQ(num_immune, g_num_persons * 8U / 10U);
+	EXPECT_EQ(num_infected, g_num_persons / 100U);
+}
+
+TEST_F( PopulationReading, LocalityOrder )
+{
+	istringstream is_file(m_csv);
+	const auto pop_file = Build(is_file, 1);
+	m_pt_config.put("run.person_order", "locality");
+	istringstream is_locality(m_csv);
+	const auto pop = Build(is_locality, 1);
+	ASSERT_EQ(pop->size(), g_num_persons);
+
+	// Same persons (by id), with the members of a household next to one another.
+	set<unsigned int> ids;
+	set<unsigned int> households_seen;
+	for (size_t i = 0; i < pop->size(); i++) {
+		const auto& p = (*pop)[i];
+		ids.insert(p.GetId());
+		EXPECT_EQ(p.GetClusterId(ClusterType::Household), (*pop_file)[p.GetId()].GetClusterId(ClusterType::Household));
+		const auto hh = p.GetClusterId(ClusterType::Household);
+		if (i == 0 || hh != (*pop)[i - 1].GetClusterId(ClusterType::Household)) {
+			EXPECT_TRUE(households_seen.insert(hh).second);
+		}
+	}
+	EXPECT_EQ(ids.size(), g_num_persons);
+}
+
+TEST_F( PopulationReading, Gzip )
+{
+	istringstream is_plain(m_csv);
+	const auto pop_plain = Build(is_plain, 2);
+
+	stringstream compressed;
+	{
+		istringstream is(m_csv);
+		boost::iostreams::filtering_ostream os;
+		os.push(boost::iostreams::gzip_compressor());
+		os.push(compressed);
+		boost::iostreams::copy(is, os);
+	}
+	const auto pop_gzip = Build(compressed, 2);
+	ExpectEqual(*pop_plain, *pop_gzip);
+}
+
+TEST_F( PopulationReading, Records )
+{
+	istringstream is(m_csv);
+	const auto pop_file = Build(is, 2);
+	const double next_draw_file = m_next_draw;
+
+	// The records of the file, in batches of different sizes.
+	vector<PopulationBuilder::Record> records;
+	for (unsigned int i = 0; i < g_num_persons; i++) {
+		records.push_back({ { (i * 7U) % 90U, 1U + i / 3U, i % 5U, (i % 7U) * 3U, 1U + i / 500U, 1U + (i * 13U) % 97U } });
+	}
+	omp_set_num_threads(2);
+	Random rng(2015U);
+	const auto pop = PopulationBuilder::Build(m_pt_config, m_pt_disease, [&](const PopulationBuilder::RecordSink& sink) {
+		for (size_t first = 0, size = 1000U; first < records.size(); first += size, size *= 3U) {
+			sink(vector<PopulationBuilder::Record>(records.begin() + first,
+				records.begin() + min(records.size(), first + size)));
+		}
+	}, rng);
+	ExpectEqual(*pop_file, *pop);
+	EXPECT_EQ(next_draw_file, rng.NextDouble());
+}
+
+TEST_F( PopulationReading, BadData )
+{
+	istringstream is(m_csv + "12,1,x,0,1,1\n");
+	EXPECT_THROW(Build(is, 2), runtime_error);
+}
+
+} //end-of-namespace-Tests
@@ -0,0 +1,88 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Tests for the synthetic population generator.
+ */
+
+#include "TestSupport.h"
+
+#include "core/ContactMatrixReader.h"
+#include "pop/Population.h"
+#include "pop/PopulationGenerator.h"
+#include "sim/Simulator.h"
+#include "sim/SimulatorBuilder.h"
+#include "util/InstallDirs.h"
+
+#include <gtest/gtest.h>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/xml_parser.hpp>
+
+#include <set>
+#include <sstream>
+#include <string>
+
+using namespace std;
+using namespace stride;
+using namespace stride::util;
+using namespace ::testing;
+
+namespace Tests {
+
+TEST( PopulationGenerator, default )
+{
+	boost::property_tree::ptree pt_config = GetTestConfig();
+	pt_config.put("run.population_file", "pop_synthetic.csv");
+	boost::property_tree::ptree pt_disease;
+	read_xml((InstallDirs::GetDataDir() / "disease_measles.xml").string(), pt_disease);
+
+	// The same population for a seed, whatever the number of threads; another for another seed.
+	const size_t num_persons = 20000U;
+	const PopulationGenerator generator;
+	EXPECT_EQ(589U, generator.GetNumCities());
+	ostringstream serial;
+	ostringstream parallel;
+	ostringstream other;
+	generator.Write(serial, num_persons, 1U, 1U);
+	generator.Write(parallel, num_persons, 1U, 3U);
+	generator.Write(other, num_persons, 2U, 1U);
+	EXPECT_EQ(serial.str(), parallel.str());
+	EXPECT_NE(serial.str(), other.str());
+
+	// Exactly the persons asked for, households not split over cities, and a simulator on them.
+	istringstream pop_stream(serial.str());
+	const auto sim = SimulatorBuilder::Build(pt_config, pt_disease, ContactMatrixReader::Read(pt_config), pop_stream, 1U);
+	const auto& population = *sim->GetPopulation();
+	ASSERT_EQ(num_persons, population.size());
+	set<unsigned int> households;
+	unsigned int num_children = 0U;
+	unsigned int num_workers = 0U;
+	for (size_t i = 0; i < population.size(); i++) {
+		const auto& person = population[i];
+		households.insert(person.GetClusterId(ClusterType::Household));
+		EXPECT_NE(0U, person.GetClusterId(ClusterType::PrimaryCommunity));
+		EXPECT_NE(0U, person.GetClusterId(ClusterType::SecondaryCommunity));
+		EXPECT_EQ(person.GetAge() >= 3U && person.GetAge() <= 17U, person.GetClusterId(ClusterType::School) != 0U);
+		num_children += person.GetAge() < 18U;
+		num_workers  += person.GetClusterId(ClusterType::Work) != 0U;
+	}
+	// Some 2.3 persons per household, a fifth under 18 and half of everyone at work.
+	EXPECT_NEAR(2.3, static_cast<double>(num_persons) / households.size(), 0.2);
+	EXPECT_NEAR(0.2, static_cast<double>(num_children) / num_persons, 0.03);
+	EXPECT_NEAR(0.48, static_cast<double>(num_workers) / num_persons, 0.03);
+}
+
+} //end-of-namespace-Tests
@@ -0,0 +1,127 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Tests for simulator checkpoints.
+ */
+
+#include "TestSupport.h"
+
+#include "core/ClusterType.h"
+#include "pop/Population.h"
+#include "sim/Simulator.h"
+#include "sim/SimulatorBuilder.h"
+#include "sim/SimulatorCheckpoint.h"
+
+#include <gtest/gtest.h>
+#include <boost/filesystem.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <omp.h>
+
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace stride;
+using namespace ::testing;
+
+namespace Tests {
+
+class SimulatorCheckpoints: public ::testing::Test
+{
+protected:
+	/// Set up for the test fixture
+	virtual void SetUp()
+	{
+		m_pt_config = GetTestConfig();
+
+		m_dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+		boost::filesystem::create_directories(m_dir);
+		omp_set_num_threads(1);
+		omp_set_schedule(omp_sched_static, 1);
+	}
+
+	/// Tearing down the test fixture
+	virtual void TearDown()
+	{
+		boost::filesystem::remove_all(m_dir);
+	}
+
+	/// Run up to the given day, adding the daily case counts.
+	static void Run(Simulator& sim, vector<unsigned int>& cases, unsigned int num_days)
+	{
+		while (cases.size() < num_days) {
+			sim.TimeStep();
+			cases.push_back(sim.GetPopulation()->GetInfectedCount());
+		}
+	}
+
+	// Data members of the test fixture
+	boost::property_tree::ptree    m_pt_config;
+	boost::filesystem::path        m_dir;
+};
+
+TEST_F( SimulatorCheckpoints, default )
+{
+	// Full checkpoints on days 4 and 8; incremental ones on days 4 and 8.
+	m_pt_config.put("run.mean_field_min_size", 100U);
+	const auto sim = SimulatorBuilder::Build(m_pt_config, 1U);
+	SimulatorCheckpoint full;
+	SimulatorCheckpoint incremental(true);
+	vector<unsigned int> cases;
+	for (const unsigned int day : { 4U, 8U }) {
+		Run(*sim, cases, day);
+		full.Save(*sim, cases, m_dir / ("full_" + to_string(day) + ".bin"));
+		incremental.Save(*sim, cases, m_dir / ("incremental_" + to_string(day) + ".bin"));
+	}
+	Run(*sim, cases, 15U);
+	EXPECT_GT(sim->GetNumMeanField()[static_cast<size_t>(ClusterType::SecondaryCommunity)], 0U);
+	EXPECT_LT(boost::filesystem::file_size(m_dir / "incremental_8.bin"),
+	        boost::filesystem::file_size(m_dir / "full_8.bin") / 10U);
+
+	// Restarts continue exactly as the run that wrote the checkpoint.
+	for (const auto file : { "full_4.bin", "full_8.bin", "incremental_8.bin" }) {
+		const auto restarted = SimulatorBuilder::Build(m_pt_config, 1U);
+		auto restarted_cases = SimulatorCheckpoint::Load(*restarted, m_dir / file);
+		ASSERT_EQ(restarted_cases, vector<unsigned int>(cases.begin(), cases.begin() + restarted_cases.size()));
+		Run(*restarted, restarted_cases, 15U);
+		EXPECT_EQ(cases, restarted_cases) << file;
+		EXPECT_EQ(sim->GetEngineDays(), restarted->GetEngineDays()) << file;
+		EXPECT_EQ(sim->GetNumMeanField(), restarted->GetNumMeanField()) << file;
+		for (size_t i = 0; i < sim->GetPopulation()->size(); i++) {
+			ASSERT_EQ((*sim->GetPopulation())[i].GetHealth().GetHealthStatus(),
+			        (*restarted->GetPopulation())[i].GetHealth().GetHealthStatus());
+		}
+	}
+
+	// Incremental checkpoints need their base, unchanged.
+	{
+		std::ofstream ofs((m_dir / "incremental_4.bin").string(), ios::binary | ios::in | ios::out);
+		ofs.seekp(boost::filesystem::file_size(m_dir / "incremental_4.bin") / 2U);
+		ofs.put('x');
+	}
+	const auto restarted = SimulatorBuilder::Build(m_pt_config, 1U);
+	EXPECT_THROW(SimulatorCheckpoint::Load(*restarted, m_dir / "incremental_8.bin"), runtime_error);
+
+	// Not for another number of threads (other random streams).
+	const auto other = SimulatorBuilder::Build(m_pt_config, 2U);
+	EXPECT_THROW(SimulatorCheckpoint::Load(*other, m_dir / "full_4.bin"), runtime_error);
+}
+
+} //end-of-namespace-Tests
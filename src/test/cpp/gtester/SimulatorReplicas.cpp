@@ -0,0 +1,215 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Tests for simulators, lockstep ensembles and index case trials built on the population of another simulator.
+ */
+
+#include "TestSupport.h"
+
+#include "pop/Population.h"
+#include "sim/IndexCaseTrials.h"
+#include "sim/LockstepEnsemble.h"
+#include "sim/Simulator.h"
+#include "sim/SimulatorBuilder.h"
+#include "util/InstallDirs.h"
+
+#include <gtest/gtest.h>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/xml_parser.hpp>
+#include <omp.h>
+
+#include <algorithm>
+#include <numeric>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace stride;
+using namespace stride::util;
+using namespace ::testing;
+
+namespace Tests {
+
+class SimulatorReplicas: public ::testing::Test
+{
+protected:
+	/// Set up for the test fixture
+	virtual void SetUp()
+	{
+		m_pt_config = GetTestConfig();
+		read_xml((InstallDirs::GetDataDir() / "disease_measles.xml").string(), m_pt_disease);
+
+		omp_set_num_threads(1);
+		omp_set_schedule(omp_sched_static, 1);
+	}
+
+	// Data members of the test fixture
+	boost::property_tree::ptree    m_pt_config;
+	boost::property_tree::ptree    m_pt_disease;
+};
+
+TEST_F( SimulatorReplicas, default )
+{
+	m_pt_config.put("run.person_order", "locality");
+	const auto model = SimulatorBuilder::Build(m_pt_config, 1U);
+	const auto num_seeded = GetNumSeeded(m_pt_config, model->GetPopulation()->size());
+
+	// Other seed, rates and R0 than the model: same as a build from scratch.
+	m_pt_config.put("run.rng_seed", 7U);
+	m_pt_config.put("run.r0", 3.0);
+	m_pt_config.put("run.seeding_rate", 0.001);
+	m_pt_config.put("run.immunity_rate", 0.5);
+	const auto cases = RunDays(*SimulatorBuilder::Build(m_pt_config, 1U));
+	const auto replica = SimulatorBuilder::Build(*model, m_pt_config, m_pt_disease, 1U);
+	EXPECT_EQ(cases, RunDays(*replica));
+
+	// The model is left as it was built.
+	EXPECT_EQ(model->GetPopulation()->size(), replica->GetPopulation()->size());
+	EXPECT_EQ(model->GetPopulation()->GetInfectedCount(), num_seeded);
+}
+
+TEST_F( SimulatorReplicas, lockstep )
+{
+	const auto model = SimulatorBuilder::Build(m_pt_config, 1U);
+	const auto num_seeded = GetNumSeeded(m_pt_config, model->GetPopulation()->size());
+	vector<unsigned int> seeds;
+	for (unsigned int i = 0; i < LockstepEnsemble::MaxReplicas(); i++) {
+		seeds.push_back(100U + i);
+	}
+	LockstepEnsemble ensemble1(*model, m_pt_config, m_pt_disease, seeds);
+	LockstepEnsemble ensemble2(*model, m_pt_config, m_pt_disease, seeds);
+	ASSERT_EQ(ensemble1.GetNumReplicas(), seeds.size());
+
+	// Every lane starts from its seeded persons and only ever gains cases.
+	vector<unsigned int> previous(seeds.size(), num_seeded);
+	EXPECT_EQ(ensemble1.GetInfectedCounts(), previous);
+	for (unsigned int day = 0; day < 10U; day++) {
+		ensemble1.TimeStep();
+		ensemble2.TimeStep();
+		for (size_t k = 0; k < seeds.size(); k++) {
+			EXPECT_GE(ensemble1.GetInfectedCounts()[k], previous[k]);
+		}
+		previous = ensemble1.GetInfectedCounts();
+	}
+	EXPECT_EQ(ensemble1.GetInfectedCounts(), ensemble2.GetInfectedCounts());
+	EXPECT_GT(*max_element(previous.begin(), previous.end()), num_seeded);
+	EXPECT_EQ(model->GetPopulation()->GetInfectedCount(), num_seeded);
+
+	seeds.push_back(1U);
+	EXPECT_THROW(LockstepEnsemble(*model, m_pt_config, m_pt_disease, seeds), runtime_error);
+}
+
+TEST_F( SimulatorReplicas, common_random_numbers )
+{
+	const auto model = SimulatorBuilder::Build(m_pt_config, 1U);
+
+	// Lanes 0 and 1 are the same scenario, lanes 2 and 3 a higher R0 and schools closed.
+	vector<boost::property_tree::ptree> lane_configs(4U, m_pt_config);
+	for (size_t k = 2U; k < lane_configs.size(); k++) {
+		lane_configs[k].put("run.r0", 15.0);
+		lane_configs[k].put("run.days_off", "School");
+	}
+	LockstepEnsemble ensemble1(*model, lane_configs, m_pt_disease, 1U, false, true);
+	LockstepEnsemble ensemble2(*model, lane_configs, m_pt_disease, 2U, false, true);
+	for (unsigned int day = 0; day < 10U; day++) {
+		ensemble1.TimeStep();
+		ensemble2.TimeStep();
+	}
+
+	// Same scenario and seed, same draws: same course, whatever the number of threads.
+	const auto& cases = ensemble1.GetInfectedCounts();
+	EXPECT_EQ(cases[0], cases[1]);
+	EXPECT_EQ(cases[2], cases[3]);
+	EXPECT_NE(cases[0], cases[2]);
+	EXPECT_EQ(cases, ensemble2.GetInfectedCounts());
+}
+
+TEST_F( SimulatorReplicas, diseases )
+{
+	const auto model = SimulatorBuilder::Build(m_pt_config, 1U);
+	boost::property_tree::ptree pt_influenza;
+	read_xml((InstallDirs::GetDataDir() / "disease_influenza.xml").string(), pt_influenza);
+
+	// Measles and influenza in one ensemble, and each on its own.
+	vector<boost::property_tree::ptree> lane_configs(2U, m_pt_config);
+	lane_configs[1].put("run.r0", 2.0);
+	lane_configs[1].put("run.immunity_rate", 0.0);
+	LockstepEnsemble both(*model, lane_configs, { m_pt_disease, pt_influenza }, 1U, false, true);
+	LockstepEnsemble measles(*model, { lane_configs[0] }, m_pt_disease, 1U, false, true);
+	LockstepEnsemble influenza(*model, { lane_configs[1] }, pt_influenza, 1U, false, true);
+	for (unsigned int day = 0; day < 10U; day++) {
+		both.TimeStep();
+		measles.TimeStep();
+		influenza.TimeStep();
+	}
+
+	// With common random numbers, a disease lane follows the same course in company or not.
+	EXPECT_EQ(measles.GetInfectedCounts()[0], both.GetInfectedCounts()[0]);
+	EXPECT_EQ(influenza.GetInfectedCounts()[0], both.GetInfectedCounts()[1]);
+	EXPECT_NE(both.GetInfectedCounts()[0], both.GetInfectedCounts()[1]);
+	EXPECT_THROW(LockstepEnsemble(*model, lane_configs, vector<boost::property_tree::ptree>(1U, m_pt_disease)), runtime_error);
+}
+
+TEST_F( SimulatorReplicas, extinction )
+{
+	// A handful of index cases among mostly immune persons: the epidemic dies out.
+	m_pt_config.put("run.r0", 1.0);
+	m_pt_config.put("run.immunity_rate", 0.9);
+	m_pt_config.put("run.seeding_rate", 0.0001);
+	const auto sim = SimulatorBuilder::Build(m_pt_config, 1U);
+	LockstepEnsemble ensemble(*sim, m_pt_config, m_pt_disease, { 1U, 2U, 3U });
+	unsigned int day = 0U;
+	for (; day < 200U && !(sim->IsExtinct() && ensemble.IsExtinct()); day++) {
+		sim->TimeStep();
+		ensemble.TimeStep();
+	}
+	ASSERT_LT(day, 200U);
+
+	// Nothing changes anymore.
+	const auto cases = sim->GetPopulation()->GetInfectedCount();
+	const auto lanes = ensemble.GetInfectedCounts();
+	for (unsigned int i = 0; i < 10U; i++) {
+		sim->TimeStep();
+		ensemble.TimeStep();
+	}
+	EXPECT_EQ(cases, sim->GetPopulation()->GetInfectedCount());
+	EXPECT_EQ(lanes, ensemble.GetInfectedCounts());
+	EXPECT_TRUE(sim->IsExtinct());
+}
+
+TEST_F( SimulatorReplicas, index_case_trials )
+{
+	const auto model = SimulatorBuilder::Build(m_pt_config, 1U, true);
+	const IndexCaseTrials trials(*model, m_pt_config, m_pt_disease, 1U);
+	const auto results = trials.Run(500U);
+	const auto distribution = IndexCaseTrials::GetDistribution(results);
+	ASSERT_EQ(500U, accumulate(distribution.begin(), distribution.end(), 0U));
+	EXPECT_GT(distribution.size(), 1U);
+
+	// Trials do not depend on the number of threads.
+	const IndexCaseTrials parallel_trials(*model, m_pt_config, m_pt_disease, 2U);
+	EXPECT_EQ(distribution, IndexCaseTrials::GetDistribution(parallel_trials.Run(500U)));
+
+	// Nobody to infect.
+	m_pt_config.put("run.immunity_rate", 1.0);
+	const IndexCaseTrials immune_trials(*model, m_pt_config, m_pt_disease, 1U);
+	EXPECT_EQ(vector<unsigned int>(1U, 100U), IndexCaseTrials::GetDistribution(immune_trials.Run(100U)));
+}
+
+} //end-of-namespace-Tests
@@ -0,0 +1,115 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Tests for simulator snapshots.
+ */
+
+#include "TestSupport.h"
+
+#include "pop/Population.h"
+#include "sim/Simulator.h"
+#include "sim/SimulatorBuilder.h"
+#include "sim/SimulatorSnapshot.h"
+
+#include <gtest/gtest.h>
+#include <boost/filesystem.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <omp.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace stride;
+using namespace ::testing;
+
+namespace Tests {
+
+class SimulatorSnapshots: public ::testing::Test
+{
+protected:
+	/// Set up for the test fixture
+	virtual void SetUp()
+	{
+		m_pt_config = GetTestConfig();
+
+		m_snapshot_dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+		omp_set_num_threads(1);
+		omp_set_schedule(omp_sched_static, 1);
+	}
+
+	/// Tearing down the test fixture
+	virtual void TearDown()
+	{
+		boost::filesystem::remove_all(m_snapshot_dir);
+	}
+
+	// Data members of the test fixture
+	boost::property_tree::ptree    m_pt_config;
+	boost::filesystem::path        m_snapshot_dir;
+};
+
+TEST_F( SimulatorSnapshots, default )
+{
+	const auto cases = RunDays(*SimulatorBuilder::Build(m_pt_config, 1U));
+
+	m_pt_config.put("run.snapshot_dir", m_snapshot_dir.string());
+	const auto key  = SimulatorSnapshot::GetKey(m_pt_config);
+	const auto file = SimulatorSnapshot::GetPath(m_snapshot_dir, key);
+
+	// The first build writes the snapshot, the second one starts from it.
+	const auto cases_written = RunDays(*SimulatorBuilder::Build(m_pt_config, 1U));
+	ASSERT_TRUE(boost::filesystem::is_regular_file(file));
+	const auto cases_loaded = RunDays(*SimulatorBuilder::Build(m_pt_config, 1U));
+	EXPECT_EQ(cases, cases_written);
+	EXPECT_EQ(cases, cases_loaded);
+
+	// Persons mapped from the snapshot (shared with other processes) give the same run.
+	m_pt_config.put("run.snapshot_shared", true);
+	const auto cases_shared = RunDays(*SimulatorBuilder::Build(m_pt_config, 1U));
+	EXPECT_EQ(cases, cases_shared);
+
+	// The R0 is not part of the key, the seed is.
+	m_pt_config.put("run.r0", 3.0);
+	EXPECT_EQ(key, SimulatorSnapshot::GetKey(m_pt_config));
+	m_pt_config.put("run.rng_seed", 2016U);
+	EXPECT_NE(key, SimulatorSnapshot::GetKey(m_pt_config));
+}
+
+TEST_F( SimulatorSnapshots, layout )
+{
+	const auto cold = SimulatorBuilder::Build(m_pt_config, 1U);
+
+	// A partitioned build over two threads writes the snapshot: it holds the persons in
+	// file order, not in the order of the partitions.
+	m_pt_config.put("run.snapshot_dir", m_snapshot_dir.string());
+	m_pt_config.put("run.partitioning", "graph");
+	SimulatorBuilder::Build(m_pt_config, 2U);
+	m_pt_config.put("run.partitioning", "none");
+	const auto warm = SimulatorBuilder::Build(m_pt_config, 1U);
+
+	const auto& cold_persons = *cold->GetPopulation();
+	const auto& warm_persons = *warm->GetPopulation();
+	ASSERT_EQ(cold_persons.size(), warm_persons.size());
+	for (size_t i = 0; i < cold_persons.size(); i++) {
+		ASSERT_EQ(cold_persons[i].GetId(), warm_persons[i].GetId());
+	}
+	EXPECT_EQ(RunDays(*cold), RunDays(*warm));
+}
+
+} //end-of-namespace-Tests
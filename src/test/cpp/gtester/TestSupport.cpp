@@ -0,0 +1,67 @@
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Implementation of the config and helpers shared by the simulator tests.
+ */
+
+#include "TestSupport.h"
+
+#include "pop/Population.h"
+#include "sim/Simulator.h"
+
+#include <cmath>
+
+using namespace std;
+using namespace stride;
+
+namespace Tests {
+
+boost::property_tree::ptree GetTestConfig()
+{
+	boost::property_tree::ptree pt_config;
+	pt_config.put("run.rng_seed", 2015U);
+	pt_config.put("run.r0", 11.0);
+	pt_config.put("run.seeding_rate", 0.002);
+	pt_config.put("run.immunity_rate", 0.8);
+	pt_config.put("run.population_file", "pop_oklahoma.csv");
+	pt_config.put("run.disease_config_file", "disease_measles.xml");
+	pt_config.put("run.num_participants_survey", 10U);
+	pt_config.put("run.start_date", "2017-01-01");
+	pt_config.put("run.holidays_file", "holidays_none.json");
+	pt_config.put("run.age_contact_matrix_file", "contact_matrix_average.xml");
+	pt_config.put("run.log_level", "None");
+	return pt_config;
+}
+
+unsigned int GetNumSeeded(const boost::property_tree::ptree& pt_config, size_t population_size)
+{
+	// As the population builder does.
+	return static_cast<unsigned int>(floor(static_cast<double>(population_size)
+		* pt_config.get<double>("run.seeding_rate")));
+}
+
+vector<unsigned int> RunDays(Simulator& sim, unsigned int num_days)
+{
+	vector<unsigned int> cases;
+	for (unsigned int i = 0; i < num_days; i++) {
+		sim.TimeStep();
+		cases.push_back(sim.GetPopulation()->GetInfectedCount());
+	}
+	return cases;
+}
+
+} //end-of-namespace-Tests
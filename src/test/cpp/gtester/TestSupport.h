@@ -0,0 +1,47 @@
+#ifndef TESTS_TEST_SUPPORT_H_INCLUDED
+#define TESTS_TEST_SUPPORT_H_INCLUDED
+/*
+ *  This is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  any later version.
+ *  The software is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  You should have received a copy of the GNU General Public License
+ *  along with the software. If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Copyright 2017, Willem L, Kuylen E, Stijven S & Broeckhove J
+ */
+
+/**
+ * @file
+ * Config and helpers shared by the simulator tests.
+ */
+
+#include <boost/property_tree/ptree.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace stride {
+class Simulator;
+}
+
+namespace Tests {
+
+/// Config of the simulator tests: measles with R0 11 in pop_oklahoma.csv, seeding rate
+/// 0.002, immunity rate 0.8, no holidays, average contact matrices and no logging.
+/// Tests put their own values over it.
+boost::property_tree::ptree GetTestConfig();
+
+/// Number of persons the config's seeding rate infects at the start in a population of the given size.
+unsigned int GetNumSeeded(const boost::property_tree::ptree& pt_config, std::size_t population_size);
+
+/// Run the simulator for a number of days and collect the daily (cumulative) case counts.
+std::vector<unsigned int> RunDays(stride::Simulator& sim, unsigned int num_days = 10U);
+
+} //end-of-namespace-Tests
+
+#endif // end-of-include-guard